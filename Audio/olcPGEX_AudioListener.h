@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|         OneLoneCoder Pixel Game Engine Extension            |
-	|                    AudioListener v1.0                       |
+	|                    AudioListener v1.4                       |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -20,6 +20,7 @@
 
 	olcPGEX_AudioListener.h      (this file)
 	olcPGEX_AudioSource.h
+	olcPGEX_ThreadPool.h         (in the main folder, rather than the Audio folder)
 
 	These can be found in the github repo as well...
 
@@ -115,9 +116,135 @@
 
 		}
 
+	And at the end of OnUserUpdate (after everything else has been updated) let the
+	listener pass this frame's changes on to SoLoud.  This is required, see v1.4 below:
+
+		AL.UpdateAudio();
+
 
 	Those are the basics... other features can be accessed in much the same way.
 
+
+	v1.1 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	Spatial Audio
+
+	Sounds that belong to something in your world (an engine, a waterfall, an enemy) can
+	get quieter as they move away from the listener and drift to the left or right
+	speaker depending on which side of the listener they are.
+
+	Tell the Audio Source it lives in the world, and where it is:
+
+		AS_Test.SetSpatial();
+		AS_Test.UpdatePosition(vecWaterfallPos);
+
+	Move the listener along with your player (or camera):
+
+		AL.UpdatePosition(vecPlayerPos);
+
+	And once per frame (after everything has moved) let the listener work out the
+	volume and pan of every spatial sound in one go:
+
+		AL.UpdateSpatialAudio();
+
+	Only the sounds whose volume or pan actually changed are passed on to SoLoud, and
+	they are all passed on together rather than one at a time.  (PGE_GAME_2D does this
+	for you at the end of every frame.)
+
+	How quickly sounds fade away is up to you:
+
+		AL.falloff = olcPGEX_AudioListener::Falloff::INVERSE;	// LINEAR, INVERSE or INVERSE_SQUARE
+		AL.fMinDistance = 32.0f;	// full volume when closer than this
+		AL.fMaxDistance = 640.0f;	// silent when further away than this
+		AL.fRolloff = 1.0f;			// how steeply INVERSE and INVERSE_SQUARE drop off
+		AL.fPanDistance = 320.0f;	// how far to the side a sound has to be to be fully panned
+		AL.fPanAmount = 0.8f;		// 0.0f = no panning, 1.0f = all the way to one speaker
+
+	GetDistance has also been fixed, it now returns the actual distance between the
+	listener and a position (or the squared distance if returnRoot is false).
+
+
+	v1.2 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	Voice Management
+
+	Every time an Audio Source plays it uses up a voice, and every voice that is playing
+	has to be mixed.  With lots of gunfire and footsteps that soon adds up, so the listener
+	now only lets a set number of voices play for real:
+
+		AL.SetMaxRealVoices(24);
+
+	Anything over that, and anything too quiet to hear (out of range spatial sounds for
+	example), becomes a virtual voice.  Virtual voices are not mixed, but the listener
+	keeps track of where they are up to, so when there is room again (or they come back
+	into range) they carry on from where they would have been rather than from the start.
+
+		AL.fAudibilityThreshold = 0.005f;	// quieter than this and a voice goes virtual
+
+	When there are more voices than room, the ones with the highest priority win, then
+	the loudest.  Give important sounds (music, dialogue) a higher priority:
+
+		AS_Music.nPriority = 10;
+
+	Each Audio Source can also play several copies of its sound at once (gunfire again),
+	up to nMaxSamples (4 by default, 8 at most).  Playing another copy when they are all
+	in use stops the oldest one to make room:
+
+		AS_Gun.nMaxSamples = 6;
+
+	The once per frame update is now called UpdateAudio (UpdateSpatialAudio still works)
+	and it is needed for virtual voices to come back, so call it every frame even without
+	any spatial sounds.  GetRealVoiceCount and GetVirtualVoiceCount tell you how things
+	are going.
+
+
+	v1.3 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	Streaming
+
+	Sound effects are decoded into memory when they are loaded, so they are ready to play
+	instantly.  That is no good for music though... a few minutes of decoded stereo music
+	takes tens of megabytes and a few seconds to load.  Big files are now streamed instead,
+	a little of the file is decoded at a time as it plays.
+
+	By default anything bigger than nStreamThreshold bytes (1MB) is streamed, or you can
+	choose for yourself:
+
+		AS_Music.LoadAudioSample(MUSIC, "./assets/mus/Theme.ogg", olcPGEX_AudioListener::StreamMode::STREAM);
+		AS_Boom.LoadAudioSample(BOOM, "./assets/snd/Boom.wav", olcPGEX_AudioListener::StreamMode::DECODE);
+
+	Give the listener a thread pool and streams are read in the background, so loading
+	(and starting) music never holds up a frame:
+
+		AL.pThreadPool = &threadPool;
+
+	Playing a stream that hasn't finished loading yet is fine, it starts playing as soon
+	as it is ready (from the first UpdateAudio after that).  Until then its handle is only
+	known to the listener, so use the Audio Source functions rather than calling SoLoud
+	with it directly.
+
+
+	v1.4 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	Deferred Commands
+
+	SoLoud locks the audio thread out every time a sound is changed, so hundreds of
+	Audio Sources adjusting their volume and speed every frame means hundreds of locks,
+	with the game and the audio fighting over them.
+
+	Pause, Stop, SetVolume and ModulateAudio on an Audio Source now just make a note of
+	what has changed.  UpdateAudio then passes everything on to SoLoud in one go, under
+	a single lock.  Changing the same sound more than once in a frame costs nothing extra,
+	only the last volume / speed is sent.  (Play is still immediate, so you get its handle
+	straight away.)
+
+	This does mean changes are heard when UpdateAudio is called, so calling it once per
+	frame after your game has updated is now required (PGE_GAME_2D does this in
+	LateUpdateGAME2D).  Until the first call changes still go straight to SoLoud and
+	no voice is made virtual, so older code that never calls it keeps working, it
+	just misses out on voice management.  nCommandsApplied tells you how many changes
+	the last UpdateAudio passed on.
+
 	Enjoy!
 
 
@@ -169,6 +296,15 @@
 
 #include "soloud.h"
 #include "soloud_wav.h"
+#include "soloud_wavstream.h"
+
+#include "olcPGEX_ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
 
 class olcPGEX_AudioListener : public olc::PGEX
 {
@@ -180,10 +316,34 @@ public:
 		{
 			nSampleID = ID;
 			wav = wavPtr;
+			source = wavPtr;
 		}
 
+		sAudioSample(int ID, SoLoud::WavStream* streamPtr, std::shared_ptr<std::atomic<bool>> ready)
+		{
+			nSampleID = ID;
+			stream = streamPtr;
+			source = streamPtr;
+			bReady = ready;
+		}
+
+		// Streams may still be loading in the background, nothing can play until they are ready
+		bool IsReady() const { return bReady == nullptr || bReady->load(); }
+		double GetLength() { return wav != nullptr ? wav->getLength() : stream->getLength(); }
+
 		int nSampleID;
-		SoLoud::Wav* wav;
+		SoLoud::Wav* wav = nullptr;				// decoded in full
+		SoLoud::WavStream* stream = nullptr;	// decoded as it plays
+		SoLoud::AudioSource* source = nullptr;	// whichever of the two it is
+		std::shared_ptr<std::atomic<bool>> bReady;
+	};
+
+	// How an Audio Sample is loaded
+	enum class StreamMode : uint8_t
+	{
+		AUTO,		// stream files bigger than nStreamThreshold, decode the rest
+		DECODE,		// decode the whole file up front, best for short sound effects
+		STREAM,		// decode a little at a time as it plays, best for music
 	};
 
 	// SoLoud Audio Engine Object
@@ -202,6 +362,38 @@ public:
 	// Vector of Audio Samples
 	std::vector<sAudioSample> audioSamples;
 	std::list<SoLoud::Wav> wavs;
+	std::list<SoLoud::WavStream> streams;
+
+	// Files bigger than this (in bytes) are streamed when loaded with StreamMode::AUTO
+	size_t nStreamThreshold = 1024 * 1024;
+
+	// Streams are loaded on this in the background (or straight away if there isn't one)
+	olcPGEX_ThreadPool* pThreadPool = nullptr;
+
+	// How volume falls away with distance for spatial sounds
+	enum class Falloff : uint8_t
+	{
+		LINEAR,				// straight line from full volume at fMinDistance down to silence at fMaxDistance
+		INVERSE,			// natural sounding, halves at twice fMinDistance (with a rolloff of 1)
+		INVERSE_SQUARE,		// like INVERSE but drops off more quickly
+	};
+
+	// Spatial settings
+	Falloff falloff = Falloff::INVERSE;
+	float fMinDistance = 32.0f;
+	float fMaxDistance = 640.0f;
+	float fRolloff = 1.0f;
+	float fPanDistance = 320.0f;
+	float fPanAmount = 0.8f;
+
+	// Number of voices whose volume or pan was passed on to SoLoud by the last UpdateAudio
+	int nSpatialVoicesUpdated = 0;
+
+	// Number of changes of any kind (volume, pan, speed, pause, stop) passed on by the last UpdateAudio
+	int nCommandsApplied = 0;
+
+	// Voices quieter than this are not worth mixing, so they become virtual
+	float fAudibilityThreshold = 0.005f;
 
 
 
@@ -209,8 +401,8 @@ public:
 	void AudioSystemInit();
 	void AudioSystemDestroy();
 
-	// Load a file and store it in the list of wavs
-	void LoadAudioSample(int ID, const char* fileName);
+	// Load a file and store it in the list of wavs (or streams)
+	void LoadAudioSample(int ID, const char* fileName, StreamMode mode = StreamMode::AUTO);
 
 	// Identify a particular Audio Sample based on its ID
 	sAudioSample* GetAudioSampleByID(int ID);
@@ -220,6 +412,111 @@ public:
 
 	// Calculate distance between listener and source
 	float GetDistance(olc::vf2d sourcePos, bool returnRoot = true);
+
+	// Spatial sources - returns a slot used to refer to the source from then on
+	int AddSpatialSource(olc::vf2d pos, float fVolume = 1.0f);
+	void RemoveSpatialSource(int nSlot);
+
+	// Update a spatial source's position and volume (before distance is applied)
+	void SetSpatialPosition(int nSlot, olc::vf2d pos);
+	void SetSpatialVolume(int nSlot, float fVolume);
+
+	// Work out the volume and pan for a sound at this position straight away (handy for starting a sound at the right level)
+	void GetSpatialVolumeAndPan(olc::vf2d pos, float fVolume, float& fOutVolume, float& fOutPan);
+
+	// Hard limit on the number of voices mixed at once, the rest are virtual
+	void SetMaxRealVoices(int nMax);
+	int GetMaxRealVoices() const;
+	int GetRealVoiceCount() const;
+	int GetVirtualVoiceCount() const;
+
+	// Voices - used by the Audio Sources, these keep track of every sound that is playing so it can be made virtual when
+	// needed.  Once UpdateAudio is being called, everything other than PlayVoice is only passed on to SoLoud by the next
+	// UpdateAudio (before that they are passed on straight away)
+	unsigned int PlayVoice(int nSampleID, float fVolume, float fSpeed, bool bLooping, bool bPaused, int nPriority, int nSpatialSlot);
+	void StopVoice(unsigned int handle);
+	void PauseVoice(unsigned int handle, bool bPause);
+	void SetVoiceVolume(unsigned int handle, float fVolume);
+	void SetVoiceSpeed(unsigned int handle, float fSpeed);
+	void SetVoiceSpatialSlot(unsigned int handle, int nSpatialSlot);
+	bool IsVoiceActive(unsigned int handle);
+	bool IsVoiceVirtual(unsigned int handle) const;
+
+	// Once per frame - work out every spatial source's volume and pan, decide which voices are real and which are
+	// virtual, and pass all of the changes made this frame on to SoLoud together
+	void UpdateAudio();
+	void UpdateSpatialAudio() { UpdateAudio(); }
+
+private:
+	// A voice started by an Audio Source
+	struct sVoice
+	{
+		unsigned int nKey = 0;		// what the Audio Source knows it as (the SoLoud handle, unless it had to wait for a stream)
+		unsigned int handle = 0;	// SoLoud handle, 0 until it has started
+		int nSampleID = 0;
+		int nSpatialSlot = -1;
+		int nPriority = 0;
+		float fVolume = 1.0f;		// volume before distance is applied
+		float fSpeed = 1.0f;
+		float fLoudness = 0.0f;		// what it would actually be heard at this frame
+		float fSentVolume = -1.0f;	// last volume, pan and speed passed on to SoLoud (-1 = unknown)
+		float fSentPan = 0.0f;
+		float fSentSpeed = 1.0f;
+		double dLength = 0.0;
+		double dPosition = 0.0;		// play position when it last became virtual
+		std::chrono::steady_clock::time_point tVirtual;
+		bool bLooping = false;
+		bool bPaused = false;		// paused by the Audio Source (as opposed to being virtual)
+		bool bSentPaused = false;	// paused in SoLoud (either way)
+		bool bVirtual = false;
+		bool bWantReal = false;
+		bool bFinished = false;
+		bool bPending = false;		// waiting for its stream to load
+		bool bStopping = false;		// stopped by the Audio Source, waiting for UpdateAudio
+	};
+
+	std::vector<sVoice> voices;
+	std::unordered_map<unsigned int, int> mapVoices;
+	std::vector<int> vVoiceRanking;
+	int nMaxRealVoices = 16;
+	unsigned int nPendingCount = 0;
+
+	// Set by the first UpdateAudio.  Until then nothing would ever pass deferred changes on, or bring a virtual voice
+	// back, so changes go straight to SoLoud and voices always start for real (as they did before v1.2)
+	bool bDeferCommands = false;
+
+	// Set in the keys of voices that had to wait for a stream, never set in a SoLoud handle
+	static constexpr unsigned int PENDING_KEY_BIT = 0x800;
+
+	sVoice* i_FindVoice(unsigned int handle);
+	const sVoice* i_FindVoice(unsigned int handle) const;
+	void i_ForgetVoice(unsigned int handle);
+
+	// Without UpdateAudio - forget voices SoLoud has finished with, and start any that were waiting for a stream
+	void i_TidyVoices();
+
+	// Play position of a virtual voice, as if it had carried on playing
+	double i_VirtualPosition(const sVoice& v, std::chrono::steady_clock::time_point tNow) const;
+
+	// True if a voice with this priority and loudness would be one of the real voices
+	bool i_HasRoomFor(int nPriority, float fLoudness) const;
+
+	// Start a voice in SoLoud, real or virtual depending on whether there is room for it
+	void i_StartVoice(sVoice& v, sAudioSample& sample);
+
+	// Spatial sources, kept in separate arrays so they can all be worked out in a single loop
+	std::vector<float> vSpatialX;
+	std::vector<float> vSpatialY;
+	std::vector<float> vSpatialVolume;
+	std::vector<float> vSpatialOutVolume;
+	std::vector<float> vSpatialOutPan;
+	std::vector<int> vSpatialFreeSlots;
+
+	// Calls fn with the attenuation curve currently selected, so the choice is made once rather than once per sound
+	template<class F> void i_WithFalloff(F&& fn) const;
+
+	// Volume and pan for n sounds, relative to the listener
+	template<class C> void i_Spatialise(C curve, const float* x, const float* y, const float* vol, float* outVol, float* outPan, size_t n) const;
 };
 
 #ifdef AUDIO_LISTENER_IMPLEMENTATION
@@ -229,20 +526,59 @@ void olcPGEX_AudioListener::AudioSystemInit()
 {
 	// Initialise the SoLoud backend
 	soloud.init();
+
+	// SoLoud only mixes this many voices too, as a backstop for the frame or so before UpdateAudio catches up
+	soloud.setMaxActiveVoiceCount(nMaxRealVoices);
 }
 
 void olcPGEX_AudioListener::AudioSystemDestroy()
 {
+	// Streams still loading in the background need to finish before they can be cleaned up
+	for (auto& a : audioSamples)
+		while (!a.IsReady()) std::this_thread::yield();
+
 	// Clean up the SoLoud engine
 	soloud.deinit();
 }
 
-void olcPGEX_AudioListener::LoadAudioSample(int ID, const char* fileName)
+void olcPGEX_AudioListener::LoadAudioSample(int ID, const char* fileName, StreamMode mode)
 {
 	// Search for any matching IDs
 	for (auto& a : audioSamples)
 		if (a.nSampleID == ID) return; // Audio Sample is already loaded, no need to load the same file twice!
 
+	// Big files are streamed rather than decoded
+	if (mode == StreamMode::AUTO)
+	{
+		std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+		mode = file.is_open() && size_t(file.tellg()) > nStreamThreshold ? StreamMode::STREAM : StreamMode::DECODE;
+	}
+
+	if (mode == StreamMode::STREAM)
+	{
+		// Add a new stream to the list of streams, it can't be played until it has loaded
+		streams.emplace_back();
+		SoLoud::WavStream* streamPtr = &streams.back();
+		auto ready = std::make_shared<std::atomic<bool>>(false);
+
+		// Reading the (still compressed) file into memory means nothing has to wait on the disk later on, when
+		// it starts playing or as it plays
+		std::string sFileName = fileName;
+		auto load = [streamPtr, ready, sFileName]()
+		{
+			streamPtr->loadToMem(sFileName.c_str());
+			ready->store(true);
+		};
+
+		if (pThreadPool != nullptr)
+			pThreadPool->AddJob(load);
+		else
+			load();
+
+		audioSamples.emplace_back(sAudioSample(ID, streamPtr, ready));
+		return;
+	}
+
 	// Add a new wav to the list of wavs and get a pointer to it
 	wavs.push_back(SoLoud::Wav());
 	SoLoud::Wav* wavPtr = &wavs.back();
@@ -273,11 +609,570 @@ void olcPGEX_AudioListener::UpdatePosition(olc::vf2d pos)
 float olcPGEX_AudioListener::GetDistance(olc::vf2d sourcePos, bool returnRoot)
 {
 	// Return the distance via square root if needed, or the squared version when optimisation is possible
+	olc::vf2d vecDelta = sourcePos - vecPos;
+	float fDistanceSquared = vecDelta.x * vecDelta.x + vecDelta.y * vecDelta.y;
+
 	if (returnRoot)
-		return sqrtf(abs(sourcePos.x * sourcePos.x - vecPos.x * vecPos.x) + abs(sourcePos.y * sourcePos.y - vecPos.y * vecPos.y));
+		return sqrtf(fDistanceSquared);
+	else
+		return fDistanceSquared;
+
+}
+
+int olcPGEX_AudioListener::AddSpatialSource(olc::vf2d pos, float fVolume)
+{
+	// Reuse a removed slot if there is one, otherwise add a new one on the end
+	int nSlot;
+	if (!vSpatialFreeSlots.empty())
+	{
+		nSlot = vSpatialFreeSlots.back();
+		vSpatialFreeSlots.pop_back();
+	}
+	else
+	{
+		nSlot = int(vSpatialX.size());
+		vSpatialX.push_back(0.0f);
+		vSpatialY.push_back(0.0f);
+		vSpatialVolume.push_back(0.0f);
+		vSpatialOutVolume.push_back(0.0f);
+		vSpatialOutPan.push_back(0.0f);
+	}
+
+	vSpatialX[nSlot] = pos.x;
+	vSpatialY[nSlot] = pos.y;
+	vSpatialVolume[nSlot] = fVolume;
+
+	return nSlot;
+}
+
+void olcPGEX_AudioListener::RemoveSpatialSource(int nSlot)
+{
+	if (nSlot < 0 || nSlot >= int(vSpatialX.size())) return;
+
+	// A removed slot is silent and controls nothing, so the update loop can carry on running over it
+	vSpatialVolume[nSlot] = 0.0f;
+	vSpatialFreeSlots.push_back(nSlot);
+
+	for (auto& v : voices)
+		if (v.nSpatialSlot == nSlot) v.nSpatialSlot = -1;
+}
+
+void olcPGEX_AudioListener::SetSpatialPosition(int nSlot, olc::vf2d pos)
+{
+	if (nSlot < 0 || nSlot >= int(vSpatialX.size())) return;
+
+	vSpatialX[nSlot] = pos.x;
+	vSpatialY[nSlot] = pos.y;
+}
+
+void olcPGEX_AudioListener::SetSpatialVolume(int nSlot, float fVolume)
+{
+	if (nSlot < 0 || nSlot >= int(vSpatialX.size())) return;
+
+	vSpatialVolume[nSlot] = fVolume;
+}
+
+void olcPGEX_AudioListener::GetSpatialVolumeAndPan(olc::vf2d pos, float fVolume, float& fOutVolume, float& fOutPan)
+{
+	i_WithFalloff([&](auto curve) { i_Spatialise(curve, &pos.x, &pos.y, &fVolume, &fOutVolume, &fOutPan, 1); });
+}
+
+void olcPGEX_AudioListener::SetMaxRealVoices(int nMax)
+{
+	nMaxRealVoices = std::max(nMax, 1);
+	soloud.setMaxActiveVoiceCount(nMaxRealVoices);
+}
+
+int olcPGEX_AudioListener::GetMaxRealVoices() const
+{
+	return nMaxRealVoices;
+}
+
+int olcPGEX_AudioListener::GetRealVoiceCount() const
+{
+	int nCount = 0;
+	for (auto& v : voices)
+		if (!v.bVirtual && !v.bPaused && !v.bPending) nCount++;
+
+	return nCount;
+}
+
+int olcPGEX_AudioListener::GetVirtualVoiceCount() const
+{
+	int nCount = 0;
+	for (auto& v : voices)
+		if (v.bVirtual && !v.bPaused) nCount++;
+
+	return nCount;
+}
+
+unsigned int olcPGEX_AudioListener::PlayVoice(int nSampleID, float fVolume, float fSpeed, bool bLooping, bool bPaused, int nPriority, int nSpatialSlot)
+{
+	if (audioSamples.empty()) return 0;
+	sAudioSample* sample = GetAudioSampleByID(nSampleID);
+
+	if (nSpatialSlot >= int(vSpatialX.size())) nSpatialSlot = -1;
+
+	if (!bDeferCommands) i_TidyVoices();
+
+	sVoice v;
+	v.nSampleID = sample->nSampleID;
+	v.nSpatialSlot = nSpatialSlot;
+	v.nPriority = nPriority;
+	v.fVolume = nSpatialSlot >= 0 ? vSpatialVolume[nSpatialSlot] : fVolume;
+	v.fSpeed = fSpeed;
+	v.bLooping = bLooping;
+	v.bPaused = bPaused;
+
+	if (sample->IsReady())
+	{
+		i_StartVoice(v, *sample);
+		v.nKey = v.handle;
+	}
+	else
+	{
+		// The stream is still loading, so UpdateAudio starts it later on.  SoLoud handles only use the bottom
+		// 11 bits for the voice number (there are at most 1024 voices), so a key with bit 11 set can never be
+		// mistaken for a real handle
+		v.bPending = true;
+		v.nKey = (++nPendingCount << 12) | PENDING_KEY_BIT;
+	}
+
+	// SoLoud reuses handles once a voice has finished, so replace anything left over from an old voice
+	auto it = mapVoices.find(v.nKey);
+	if (it != mapVoices.end())
+		voices[it->second] = v;
 	else
-		return abs(sourcePos.x * sourcePos.x - vecPos.x * vecPos.x) + abs(sourcePos.y * sourcePos.y - vecPos.y * vecPos.y);
+	{
+		mapVoices[v.nKey] = int(voices.size());
+		voices.push_back(v);
+	}
+
+	return v.nKey;
+}
+
+void olcPGEX_AudioListener::StopVoice(unsigned int handle)
+{
+	sVoice* v = i_FindVoice(handle);
+	if (v == nullptr)
+	{
+		// A placeholder key outlives its voice (the Audio Source still holds it after the stream has finished), and
+		// SoLoud would read past the end of its voices if it were ever given one, so only real handles are passed on
+		if ((handle & PENDING_KEY_BIT) == 0)
+			soloud.stop(handle);
+		return;
+	}
+
+	// A voice that hasn't started yet can just be forgotten, otherwise UpdateAudio stops it with everything else
+	if (v->bPending)
+		i_ForgetVoice(handle);
+	else if (!bDeferCommands)
+	{
+		soloud.stop(v->handle);
+		i_ForgetVoice(handle);
+	}
+	else
+		v->bStopping = true;
+}
+
+void olcPGEX_AudioListener::PauseVoice(unsigned int handle, bool bPause)
+{
+	sVoice* v = i_FindVoice(handle);
+	if (v == nullptr) return;
+
+	// A virtual voice's position stops (or starts) counting from here
+	if (v->bVirtual)
+	{
+		if (bPause && !v->bPaused) v->dPosition = i_VirtualPosition(*v, std::chrono::steady_clock::now());
+		v->tVirtual = std::chrono::steady_clock::now();
+	}
+
+	v->bPaused = bPause;
+
+	if (!bDeferCommands && !v->bPending)
+	{
+		v->bSentPaused = v->bPaused || v->bVirtual;
+		soloud.setPause(v->handle, v->bSentPaused);
+	}
+}
+
+void olcPGEX_AudioListener::SetVoiceVolume(unsigned int handle, float fVolume)
+{
+	sVoice* v = i_FindVoice(handle);
+	if (v == nullptr) return;
+
+	// Spatial voices get their volume from the spatial update instead
+	v->fVolume = fVolume;
+
+	if (!bDeferCommands && !v->bPending && v->nSpatialSlot < 0)
+	{
+		v->fLoudness = fVolume;
+		v->fSentVolume = fVolume;
+		soloud.setVolume(v->handle, fVolume);
+	}
+}
+
+void olcPGEX_AudioListener::SetVoiceSpeed(unsigned int handle, float fSpeed)
+{
+	sVoice* v = i_FindVoice(handle);
+	if (v == nullptr) return;
+
+	// A virtual voice's position is worked out from its speed, so start counting again from here
+	if (v->bVirtual && !v->bPaused)
+	{
+		auto tNow = std::chrono::steady_clock::now();
+		v->dPosition = i_VirtualPosition(*v, tNow);
+		v->tVirtual = tNow;
+	}
+
+	v->fSpeed = fSpeed;
+
+	if (!bDeferCommands && !v->bPending)
+	{
+		v->fSentSpeed = fSpeed;
+		soloud.setRelativePlaySpeed(v->handle, fSpeed);
+	}
+}
+
+void olcPGEX_AudioListener::SetVoiceSpatialSlot(unsigned int handle, int nSpatialSlot)
+{
+	sVoice* v = i_FindVoice(handle);
+	if (v == nullptr) return;
+
+	v->nSpatialSlot = nSpatialSlot < int(vSpatialX.size()) ? nSpatialSlot : -1;
+	if (v->nSpatialSlot >= 0) v->fVolume = vSpatialVolume[v->nSpatialSlot];
+
+	// Make sure the next update sends the new volume and pan
+	v->fSentVolume = -1.0f;
+}
+
+bool olcPGEX_AudioListener::IsVoiceActive(unsigned int handle)
+{
+	const sVoice* v = i_FindVoice(handle);
+	if (v != nullptr && !bDeferCommands && !v->bPending)
+		return soloud.isValidVoiceHandle(v->handle);
+
+	return v != nullptr && !v->bStopping;
+}
+
+bool olcPGEX_AudioListener::IsVoiceVirtual(unsigned int handle) const
+{
+	const sVoice* v = i_FindVoice(handle);
+	return v != nullptr && v->bVirtual;
+}
+
+void olcPGEX_AudioListener::UpdateAudio()
+{
+	bDeferCommands = true;
+	nSpatialVoicesUpdated = 0;
+	nCommandsApplied = 0;
+
+	// Work out every source's volume and pan together (removed slots have no volume, so they cost nothing to include)
+	size_t nSources = vSpatialX.size();
+	if (nSources > 0)
+	{
+		i_WithFalloff([&](auto curve)
+		{
+			i_Spatialise(curve, vSpatialX.data(), vSpatialY.data(), vSpatialVolume.data(), vSpatialOutVolume.data(), vSpatialOutPan.data(), nSources);
+		});
+	}
+
+	if (voices.empty()) return;
+
+	// Streams that have finished loading can start the voices that were waiting for them
+	for (auto& v : voices)
+	{
+		if (!v.bPending) continue;
+
+		sAudioSample* sample = GetAudioSampleByID(v.nSampleID);
+		if (sample->IsReady()) i_StartVoice(v, *sample);
+	}
+
+	auto tNow = std::chrono::steady_clock::now();
+
+	// How loud is each voice, and has any virtual voice reached the end of its sound while nobody was listening?
+	vVoiceRanking.clear();
+	for (int i = 0; i < int(voices.size()); i++)
+	{
+		sVoice& v = voices[i];
+		if (v.bPending || v.bStopping) continue;
+
+		v.fLoudness = v.nSpatialSlot >= 0 ? vSpatialOutVolume[v.nSpatialSlot] : v.fVolume;
+		v.bWantReal = false;
+
+		if (v.bVirtual && !v.bPaused && !v.bLooping && v.dLength > 0.0 && i_VirtualPosition(v, tNow) >= v.dLength)
+			v.bFinished = true;
+
+		if (!v.bPaused && !v.bFinished && v.fLoudness >= fAudibilityThreshold)
+			vVoiceRanking.push_back(i);
+	}
+
+	// Only the most important (then loudest) voices get to be real.  Voices that are already real get a little
+	// extra loudness, so sounds at much the same level don't keep swapping between real and virtual every frame
+	auto i_Louder = [&](int a, int b)
+	{
+		if (voices[a].nPriority != voices[b].nPriority) return voices[a].nPriority > voices[b].nPriority;
+
+		float fA = voices[a].bVirtual ? voices[a].fLoudness : voices[a].fLoudness * 1.1f + 0.0001f;
+		float fB = voices[b].bVirtual ? voices[b].fLoudness : voices[b].fLoudness * 1.1f + 0.0001f;
+		return fA > fB;
+	};
+
+	if (int(vVoiceRanking.size()) > nMaxRealVoices)
+	{
+		std::nth_element(vVoiceRanking.begin(), vVoiceRanking.begin() + nMaxRealVoices, vVoiceRanking.end(), i_Louder);
+		vVoiceRanking.resize(nMaxRealVoices);
+	}
+
+	for (int i : vVoiceRanking)
+		voices[i].bWantReal = true;
+
+	// Voices changing between real and virtual need their play position carried across.  SoLoud takes its own
+	// lock for these, so they happen first (they are only needed when something changes, not every frame)
+	for (auto& v : voices)
+	{
+		if (v.bFinished || v.bPaused || v.bPending || v.bStopping) continue;
+
+		if (!v.bVirtual && !v.bWantReal)
+		{
+			v.dPosition = soloud.getStreamPosition(v.handle);
+			v.tVirtual = tNow;
+		}
+		else if (v.bVirtual && v.bWantReal)
+		{
+			soloud.seek(v.handle, i_VirtualPosition(v, tNow));
+		}
+	}
+
+	// Hand everything that has changed this frame to SoLoud at once, rather than locking the audio thread out once
+	// per call.  Each voice only remembers its latest volume / speed / pause, so changing it several times in a
+	// frame still only sends it once
+	soloud.lockAudioMutex_internal();
+
+	for (auto& v : voices)
+	{
+		if (v.bPending) continue;
+
+		int nVoice = soloud.getVoiceFromHandle_internal(v.handle);
+		if (nVoice < 0)
+		{
+			// The sound has finished (or been stopped), so there is nothing left to update
+			v.bFinished = true;
+			continue;
+		}
+
+		if (v.bFinished || v.bStopping)
+		{
+			soloud.stopVoice_internal(nVoice);
+			v.bFinished = true;
+			nCommandsApplied++;
+			continue;
+		}
+
+		// Voices paused by their Audio Source stay as they are, anything else is real or virtual as decided above
+		if (!v.bPaused)
+			v.bVirtual = !v.bWantReal;
+
+		bool bPause = v.bPaused || v.bVirtual;
+		if (bPause != v.bSentPaused)
+		{
+			soloud.setVoicePause_internal(nVoice, bPause ? 1 : 0);
+			v.bSentPaused = bPause;
+			nCommandsApplied++;
+		}
+
+		if (v.fSpeed != v.fSentSpeed)
+		{
+			soloud.setVoiceRelativePlaySpeed_internal(nVoice, v.fSpeed);
+			v.fSentSpeed = v.fSpeed;
+			nCommandsApplied++;
+		}
+
+		// Virtual voices aren't being mixed, so their volume can wait until they are real again
+		if (v.bVirtual) continue;
+
+		// Only voices whose volume or pan has moved enough to hear need passing on
+		const float fThreshold = 1.0f / 1024.0f;
+		float fPan = v.nSpatialSlot >= 0 ? vSpatialOutPan[v.nSpatialSlot] : 0.0f;
+		if (fabsf(v.fLoudness - v.fSentVolume) > fThreshold || fabsf(fPan - v.fSentPan) > fThreshold)
+		{
+			soloud.setVoiceVolume_internal(nVoice, v.fLoudness);
+			soloud.setVoicePan_internal(nVoice, fPan);
+			v.fSentVolume = v.fLoudness;
+			v.fSentPan = fPan;
+			nSpatialVoicesUpdated++;
+			nCommandsApplied++;
+		}
+	}
+
+	soloud.unlockAudioMutex_internal();
+
+	// Forget about voices that have finished
+	for (int i = int(voices.size()) - 1; i >= 0; i--)
+		if (voices[i].bFinished) i_ForgetVoice(voices[i].nKey);
+}
+
+olcPGEX_AudioListener::sVoice* olcPGEX_AudioListener::i_FindVoice(unsigned int handle)
+{
+	auto it = mapVoices.find(handle);
+	return it != mapVoices.end() ? &voices[it->second] : nullptr;
+}
+
+const olcPGEX_AudioListener::sVoice* olcPGEX_AudioListener::i_FindVoice(unsigned int handle) const
+{
+	auto it = mapVoices.find(handle);
+	return it != mapVoices.end() ? &voices[it->second] : nullptr;
+}
+
+void olcPGEX_AudioListener::i_StartVoice(sVoice& v, sAudioSample& sample)
+{
+	// Spatial sounds start at the right volume and pan for where they are, rather than jumping there next frame
+	float fStartVolume = v.fVolume;
+	float fStartPan = 0.0f;
+	if (v.nSpatialSlot >= 0)
+		GetSpatialVolumeAndPan({ vSpatialX[v.nSpatialSlot], vSpatialY[v.nSpatialSlot] }, vSpatialVolume[v.nSpatialSlot], fStartVolume, fStartPan);
+
+	// If it can't be heard, or there is no room for it, it starts off virtual (paused in SoLoud)
+	v.bVirtual = bDeferCommands && (fStartVolume < fAudibilityThreshold || !i_HasRoomFor(v.nPriority, fStartVolume));
+
+	v.handle = soloud.play(*sample.source, fStartVolume, fStartPan, v.bPaused || v.bVirtual);
+	soloud.setRelativePlaySpeed(v.handle, v.fSpeed);
+	soloud.setLooping(v.handle, v.bLooping);
+
+	v.fLoudness = fStartVolume;
+	v.fSentVolume = fStartVolume;
+	v.fSentPan = fStartPan;
+	v.fSentSpeed = v.fSpeed;
+	v.bSentPaused = v.bPaused || v.bVirtual;
+	v.dLength = sample.GetLength();
+	v.dPosition = 0.0;
+	v.tVirtual = std::chrono::steady_clock::now();
+	v.bPending = false;
+}
+
+void olcPGEX_AudioListener::i_ForgetVoice(unsigned int handle)
+{
+	// Swap the last voice into its place
+	auto it = mapVoices.find(handle);
+	if (it == mapVoices.end()) return;
+
+	int nIndex = it->second;
+	mapVoices.erase(it);
+
+	if (nIndex != int(voices.size()) - 1)
+	{
+		voices[nIndex] = voices.back();
+		mapVoices[voices[nIndex].nKey] = nIndex;
+	}
+	voices.pop_back();
+}
+
+void olcPGEX_AudioListener::i_TidyVoices()
+{
+	for (int i = int(voices.size()) - 1; i >= 0; i--)
+	{
+		sVoice& v = voices[i];
+		if (v.bPending)
+		{
+			sAudioSample* sample = GetAudioSampleByID(v.nSampleID);
+			if (sample->IsReady()) i_StartVoice(v, *sample);
+		}
+		else if (!soloud.isValidVoiceHandle(v.handle))
+			i_ForgetVoice(v.nKey);
+	}
+}
+
+double olcPGEX_AudioListener::i_VirtualPosition(const sVoice& v, std::chrono::steady_clock::time_point tNow) const
+{
+	double dPosition = v.dPosition;
+	if (!v.bPaused)
+		dPosition += std::chrono::duration<double>(tNow - v.tVirtual).count() * v.fSpeed;
+
+	if (v.bLooping && v.dLength > 0.0)
+		dPosition = fmod(dPosition, v.dLength);
+
+	return dPosition;
+}
+
+bool olcPGEX_AudioListener::i_HasRoomFor(int nPriority, float fLoudness) const
+{
+	// Room to spare, or something real that is less important (or quieter) that can make way
+	int nReal = 0;
+	bool bBeatsOne = false;
+	for (auto& v : voices)
+	{
+		if (v.bVirtual || v.bPaused || v.bPending) continue;
+
+		nReal++;
+		if (nPriority > v.nPriority || (nPriority == v.nPriority && fLoudness > v.fLoudness))
+			bBeatsOne = true;
+	}
+
+	return nReal < nMaxRealVoices || bBeatsOne;
+}
+
+template<class F>
+void olcPGEX_AudioListener::i_WithFalloff(F&& fn) const
+{
+	// Keep the distances sensible so there is never a divide by zero
+	const float fMin = std::max(fMinDistance, 0.001f);
+	const float fMax = std::max(fMaxDistance, fMin + 0.001f);
+
+	switch (falloff)
+	{
+	case Falloff::LINEAR:
+	{
+		const float fInvRange = 1.0f / (fMax - fMin);
+		fn([=](float d) { return 1.0f - (d - fMin) * fInvRange; });
+		break;
+	}
+
+	case Falloff::INVERSE:
+	case Falloff::INVERSE_SQUARE:
+	{
+		// The inverse curves never quite reach zero, so they are lowered and stretched slightly to end
+		// in silence at fMax rather than cutting out suddenly
+		const bool bSquare = falloff == Falloff::INVERSE_SQUARE;
+		const float k = std::max(fRolloff, 0.0f) / fMin;
+		float fEnd = 1.0f / (1.0f + k * (fMax - fMin));
+		if (bSquare) fEnd *= fEnd;
+		const float fScale = fEnd < 1.0f ? 1.0f / (1.0f - fEnd) : 0.0f;
+
+		if (bSquare)
+			fn([=](float d) { float g = 1.0f / (1.0f + k * (d - fMin)); return (g * g - fEnd) * fScale; });
+		else
+			fn([=](float d) { return (1.0f / (1.0f + k * (d - fMin)) - fEnd) * fScale; });
+		break;
+	}
+	}
+}
+
+template<class C>
+void olcPGEX_AudioListener::i_Spatialise(C curve, const float* x, const float* y, const float* vol, float* outVol, float* outPan, size_t n) const
+{
+	const float fMin = std::max(fMinDistance, 0.001f);
+	const float fMax = std::max(fMaxDistance, fMin + 0.001f);
+	const float fPan = std::min(std::max(fPanAmount, 0.0f), 1.0f);
+	const float fPanScale = fPanDistance > 0.0f ? fPan / fPanDistance : 0.0f;
+	const float lx = vecPos.x;
+	const float ly = vecPos.y;
+
+	// No branches (or comparisons) in here, so the compiler is free to work on several sounds at a time.
+	// The clamps use max(a, b) = (a + b + |a - b|) / 2, as compilers won't vectorise float min / max
+	// without fast math
+	for (size_t i = 0; i < n; i++)
+	{
+		float dx = x[i] - lx;
+		float dy = y[i] - ly;
+		float d = sqrtf(dx * dx + dy * dy);
+		d = 0.5f * (d + fMin + fabsf(d - fMin));
+		d = 0.5f * (d + fMax - fabsf(d - fMax));
+
+		float p = dx * fPanScale;
 
+		outVol[i] = vol[i] * curve(d);
+		outPan[i] = 0.5f * (fabsf(p + fPan) - fabsf(p - fPan));
+	}
 }
 
 #endif // AUDIO_LISTENER_IMPLEMENTATION
@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|         OneLoneCoder Pixel Game Engine Extension            |
-	|                     AudioSource v1.0                        |
+	|                     AudioSource v1.4                        |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -15,6 +15,21 @@
 	A detailed description and instructions can be found in that
 	header file, please refer to it instead :-)
 	
+	v1.1 - Spatial sources (SetSpatial / UpdatePosition), their volume
+	and pan are worked out by the Audio Listener each frame.
+
+	v1.2 - Up to nMaxSamples copies of the sound can play at once (the
+	oldest is stopped to make room), and nPriority decides which sounds
+	keep playing when the Audio Listener runs out of real voices.
+
+	v1.3 - LoadAudioSample can stream big files (music) rather than
+	decoding them up front, see StreamMode in the Audio Listener.
+
+	v1.4 - Pause, Stop, SetVolume and ModulateAudio are passed on to
+	SoLoud by the Audio Listener's UpdateAudio, all together, once per
+	frame.  Call AL.UpdateAudio() every frame, they are only applied
+	straight away until it has been called for the first time.
+
 	Enjoy!
 
 
@@ -70,12 +85,16 @@ public:
 	// Pointer to the Audio Listener for this object
 	olcPGEX_AudioListener* AL;
 
-	// Handle for this particular copy of the sound
+	// Handle for this particular copy of the sound (the most recently played copy)
 	int handle = 255;
 
-	// Maximum copies of this sound allowed for this audio source
-	//const int nMaxSamples = 4;
-	//int nSampleHandles[4] = { 255, 255, 255, 255 };
+	// Maximum copies of this sound allowed for this audio source (up to MAX_SAMPLES)
+	static constexpr int MAX_SAMPLES = 8;
+	int nMaxSamples = 4;
+	int nSampleHandles[MAX_SAMPLES] = { 255, 255, 255, 255, 255, 255, 255, 255 };
+
+	// Higher priority sounds keep playing when there are too many voices, lower ones become virtual
+	int nPriority = 0;
 
 	// Audio Sample ID used to locate which sound to play
 	int nID;
@@ -100,10 +119,14 @@ public:
 	// Object position, used for calculating volume
 	olc::vf2d pos = { 0.0f, 0.0f };
 
+	// Slot in the Audio Listener's list of spatial sources, -1 if this source is not positioned in the world
+	// (copies of an Audio Source share the same slot)
+	int nSpatialSlot = -1;
+
 
 
 	// Instruct Audio Listener to load this sound (if not loaded already)
-	void LoadAudioSample(int ID, const char* fileName);
+	void LoadAudioSample(int ID, const char* fileName, olcPGEX_AudioListener::StreamMode mode = olcPGEX_AudioListener::StreamMode::AUTO);
 
 	// Play the Audio Sample, with given parameters
 	void Play(float speed = 1.0f, float vol = 1.0f, bool looping = false, bool paused = false);
@@ -122,19 +145,30 @@ public:
 
 	// Set Default Parameters
 	void SetDefaults(float speed, float vol, float minVol, float maxVol, bool looping);
+
+	// Spatial sources get quieter with distance from the Audio Listener, and are panned left / right
+	void SetSpatial(bool spatial = true);
+
+	// Move the source, the new volume and pan are applied by the Audio Listener's next UpdateAudio
+	void UpdatePosition(olc::vf2d newPos);
+
+private:
+	// When each copy was played, so the oldest can be stopped to make room for a new one
+	unsigned int nSampleStarted[MAX_SAMPLES] = {};
+	unsigned int nPlayCount = 0;
 };
 
 #ifdef AUDIO_SOURCE_IMPLEMENTATION
 #undef AUDIO_SOURCE_IMPLEMENTATION
 
 
-void olcPGEX_AudioSource::LoadAudioSample(int ID, const char* fileName)
+void olcPGEX_AudioSource::LoadAudioSample(int ID, const char* fileName, olcPGEX_AudioListener::StreamMode mode)
 {
 	// Link the IDs together
 	nID = ID;
 
 	// Call the Audio Listener to load the sample
-	AL->LoadAudioSample(ID, fileName);
+	AL->LoadAudioSample(ID, fileName, mode);
 }
 
 void olcPGEX_AudioSource::Play(float speed, float vol, bool looping, bool paused)
@@ -145,12 +179,30 @@ void olcPGEX_AudioSource::Play(float speed, float vol, bool looping, bool paused
 	bLooping = looping;
 	bPaused = paused;
 
-	// Assign a handle to this instance of the sound we are about to play
-	handle = AL->soloud.play(*AL->GetAudioSampleByID(nID)->wav, fVolume, 0.0f, bPaused);
+	if (nSpatialSlot >= 0)
+		AL->SetSpatialVolume(nSpatialSlot, fVolume);
+
+	// Find a free copy, or make room by stopping the oldest one
+	int nCopies = std::min(std::max(nMaxSamples, 1), MAX_SAMPLES);
+	int nCopy = -1;
+	for (int i = 0; i < nCopies && nCopy < 0; i++)
+		if (nSampleHandles[i] == 255 || !AL->IsVoiceActive(nSampleHandles[i])) nCopy = i;
+
+	if (nCopy < 0)
+	{
+		nCopy = 0;
+		for (int i = 1; i < nCopies; i++)
+			if (nSampleStarted[i] < nSampleStarted[nCopy]) nCopy = i;
 
-	// Set speed and looping 
-	AL->soloud.setRelativePlaySpeed(handle, fPlaySpeed);
-	AL->soloud.setLooping(handle, looping);
+		AL->StopVoice(nSampleHandles[nCopy]);
+	}
+
+	// Assign a handle to this instance of the sound we are about to play (the Audio Listener sets the speed and looping,
+	// decides whether there is room for it to play for real, and waits for it if it is a stream that is still loading)
+	handle = AL->PlayVoice(nID, fVolume, fPlaySpeed, bLooping, bPaused, nPriority, nSpatialSlot);
+
+	nSampleHandles[nCopy] = handle;
+	nSampleStarted[nCopy] = ++nPlayCount;
 
 	// Update Play status
 	bIsPlaying = true;
@@ -158,8 +210,9 @@ void olcPGEX_AudioSource::Play(float speed, float vol, bool looping, bool paused
 
 void olcPGEX_AudioSource::Pause(bool pauseState)
 {
-	// Use the Audio Listener to pause or un-pause the sound as neccessary
-	AL->soloud.setPause(handle, pauseState);
+	// Use the Audio Listener to pause or un-pause the sound as neccessary (every copy of it)
+	for (int h : nSampleHandles)
+		if (h != 255) AL->PauseVoice(h, pauseState);
 
 	// Update Play status
 	bIsPlaying = !pauseState;
@@ -167,8 +220,12 @@ void olcPGEX_AudioSource::Pause(bool pauseState)
 
 void olcPGEX_AudioSource::Stop()
 {
-	// Use the Audio Listener to stop the sound
-	AL->soloud.stop(handle);
+	// Use the Audio Listener to stop the sound (every copy of it)
+	for (int& h : nSampleHandles)
+	{
+		if (h != 255) AL->StopVoice(h);
+		h = 255;
+	}
 
 	// The current handle will now point to nothing, so we set it to MAX so we can test for validity if need be
 	handle = 255;
@@ -190,9 +247,13 @@ void olcPGEX_AudioSource::ModulateAudio(float minPlaySpeed, float maxPlaySpeed,
 	else if (fPlaySpeed > maxPlaySpeed) fPlaySpeed = maxPlaySpeed;
 
 	// If multiple adjustments to the playback speed are required, then the Audio Listener update itself can be
-	// deferred until the very last adjustment is made... A small optimisation
+	// deferred until the very last adjustment is made... (the Audio Listener only passes the last speed each frame
+	// on to SoLoud anyway, so this just saves looking up the copies)
 	if (!deferred)
-		AL->soloud.setRelativePlaySpeed(handle, fPlaySpeed);
+	{
+		for (int h : nSampleHandles)
+			if (h != 255) AL->SetVoiceSpeed(h, fPlaySpeed);
+	}
 }
 
 void olcPGEX_AudioSource::SetVolume(float vol, float minVol, float maxVol)
@@ -206,8 +267,14 @@ void olcPGEX_AudioSource::SetVolume(float vol, float minVol, float maxVol)
 	else if (fVolume > maxVol)
 		fVolume = maxVol;
 
-	// Instruct the Audio Listener to apply the volume change
-	AL->soloud.setVolume(handle, fVolume);
+	// Instruct the Audio Listener to apply the volume change (spatial sources pick it up on the next spatial update)
+	if (nSpatialSlot >= 0)
+		AL->SetSpatialVolume(nSpatialSlot, fVolume);
+	else
+	{
+		for (int h : nSampleHandles)
+			if (h != 255) AL->SetVoiceVolume(h, fVolume);
+	}
 }
 
 void olcPGEX_AudioSource::SetDefaults(float speed, float vol, float minVol, float maxVol, bool looping)
@@ -220,5 +287,38 @@ void olcPGEX_AudioSource::SetDefaults(float speed, float vol, float minVol, floa
 	bLooping = looping;
 }
 
+void olcPGEX_AudioSource::SetSpatial(bool spatial)
+{
+	if (spatial && nSpatialSlot < 0)
+	{
+		nSpatialSlot = AL->AddSpatialSource(pos, fVolume);
+
+		// Already playing?  Then the listener can take over from here
+		for (int h : nSampleHandles)
+			if (h != 255) AL->SetVoiceSpatialSlot(h, nSpatialSlot);
+	}
+	else if (!spatial && nSpatialSlot >= 0)
+	{
+		AL->RemoveSpatialSource(nSpatialSlot);
+		nSpatialSlot = -1;
+
+		// Back to the middle, at the volume it was set to
+		for (int h : nSampleHandles)
+		{
+			if (h == 255) continue;
+			AL->SetVoiceSpatialSlot(h, -1);
+			AL->SetVoiceVolume(h, fVolume);
+		}
+	}
+}
+
+void olcPGEX_AudioSource::UpdatePosition(olc::vf2d newPos)
+{
+	pos = newPos;
+
+	if (nSpatialSlot >= 0)
+		AL->SetSpatialPosition(nSpatialSlot, pos);
+}
+
 #endif // AUDIO_SOURCE_IMPLEMENTATION
 #endif
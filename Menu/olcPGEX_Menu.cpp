@@ -2,6 +2,12 @@
 
 olcPGEX_Menu::olcPGEX_Menu() {}
 
+olcPGEX_Menu::~olcPGEX_Menu()
+{
+	for (auto& m : menu)
+		delete m;
+}
+
 olcPGEX_MenuItem* olcPGEX_Menu::GetMenuItemByID(const int ID)
 {
 	for (auto& m : menu)
@@ -38,15 +44,7 @@ void olcPGEX_Menu::StartTransition(const float transitionDirection, const float
 		for (auto& m : menu)
 		{
 			m->bVisible = m->bIncludeInTransition;
-			m->fTransitionDirection = transitionDirection;
-			m->fTransitionSpeed = speed;
-
-			if (transitionDirection > 0.0f)
-			{
-				m->fCurrentAlpha = 0.0f;
-				m->fCurrentZoom = 1.0f;
-				m->vecDrawSize = m->vecSize;
-			}
+			m->StartFade(transitionDirection, speed);
 		}
 	}
 	else
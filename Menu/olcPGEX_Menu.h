@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|          OneLoneCoder Pixel Game Engine Extension           |
-	|                        Menu - v1.0                          |
+	|                        Menu - v1.1                          |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -22,6 +22,11 @@
 		olcPGEX_Menu.cpp
 		olcPGEX_MenuItem.h
 		olcPGEX_MenuItem.cpp
+		olcPGEX_Tween.h (from the main folder, needed since v1.1)
+
+	olcPGEX_MenuItem.h includes olcPGEX_Tween.h for you, so it never needs
+	including in your own code, but it must be next to these files (or
+	somewhere on your include path).
 
 	There is an example.cpp file in my github here:
 	https://github.com/justinrichardsmusic/PGEv2_Extensions/blob/master/Menu/example.cpp
@@ -33,6 +38,16 @@
 	Enjoy.
 
 
+	v1.1 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+
+	The hover zoom and the fades when a menu transitions in or out are now
+	run by the shared olcPGEX_Tween engine, so items that are sitting still
+	cost nothing to update.  Nothing changes in how you use menus, other
+	than menus and menu items can no longer be copied (each one owns its
+	tweens, which are released when it is destroyed).
+
+
 	License (OLC-3)
 	~~~~~~~~~~~~~~~
 
@@ -80,6 +95,7 @@ class olcPGEX_Menu : public olcPGEX_MenuItem
 {
 public:
 	olcPGEX_Menu();
+	~olcPGEX_Menu();
 	olcPGEX_MenuItem*		GetMenuItemByID(const int ID);
 	void				AddMenuItem(const int ID, olc::Decal* decal, const olc::vf2d pos, const olc::vf2d size, const olc::vf2d sourcePos = { 0.0f, 0.0f }, const bool visible = true, const bool enabled = true, const float zoomFactor = 1.2f, const bool centered = true, const bool isStatic = false);
 	void				SetMenuVisibility(const bool visible = true);
@@ -7,6 +7,16 @@ olcPGEX_MenuItem::olcPGEX_MenuItem(const int ID, olc::Decal* decal, const olc::v
 	Construct(ID, decal, pos, size, sourcePos, visible, enabled, zoomFactor, centered, isStatic);
 }
 
+olcPGEX_MenuItem::~olcPGEX_MenuItem()
+{
+	if (nZoomTween < 0)
+		return;
+
+	auto& tweens = olcPGEX_Tween::Shared();
+	tweens.Destroy(nZoomTween);
+	tweens.Destroy(nAlphaTween);
+}
+
 bool olcPGEX_MenuItem::i_FPointInsideRect(olc::vf2d point, olc::vf2d rPos, olc::vf2d rSize)
 {
 	return (point.x >= rPos.x &&
@@ -32,47 +42,90 @@ void olcPGEX_MenuItem::Construct(const int ID, olc::Decal* decal, const olc::vf2
 	decMenu = decal;
 }
 
+void olcPGEX_MenuItem::i_CreateTweens()
+{
+	// Created on first use rather than in the constructor, menu items can exist before the engine does
+	if (nZoomTween >= 0)
+		return;
+
+	auto& tweens = olcPGEX_Tween::Shared();
+	nZoomTween = tweens.Create(fCurrentZoom);
+	nAlphaTween = tweens.Create(fCurrentAlpha);
+}
+
+void olcPGEX_MenuItem::StartFade(const float transitionDirection, const float speed)
+{
+	i_CreateTweens();
+
+	fTransitionDirection = transitionDirection;
+	fTransitionSpeed = speed;
+	fFadeDirection = 0.0f;							// Update starts the fade, even if it is in the same direction as last time
+
+	if (transitionDirection > 0.0f)
+	{
+		fCurrentAlpha = 0.0f;
+		fCurrentZoom = 1.0f;
+		vecDrawSize = vecSize;
+
+		fZoomTarget = 1.0f;
+		bZoomTweening = false;
+		olcPGEX_Tween::Shared().Set(nZoomTween, fCurrentZoom);
+	}
+}
+
 void olcPGEX_MenuItem::Update(const float fElapsedTime, const olc::vi2d mousePos)
 {
+	(void)fElapsedTime;								// The tweens are advanced by the shared tween engine - v1.1
+
+	i_CreateTweens();
+	auto& tweens = olcPGEX_Tween::Shared();
+
 	if (fTransitionDirection == 0)
 	{
 		if (!bIsStatic)
 		{
 			olc::vf2d fMousePos = { (float)mousePos.x, (float)mousePos.y };
 
-			if (i_FPointInsideRect(fMousePos, vecPos, vecSize) && !bToggledOff)
-			{
-				if (fCurrentZoom < fZoomFactor)
-					fCurrentZoom += fElapsedTime * fZoomSpeed;
+			bHover = i_FPointInsideRect(fMousePos, vecPos, vecSize) && !bToggledOff;
 
-				bHover = true;
-			}
-			else
+			// Only start the zoom when where it is heading changes, it is left alone otherwise
+			const float fTarget = bHover ? fZoomFactor : 1.0f;
+			if (fTarget != fZoomTarget)
 			{
-				if (fCurrentZoom > 1.0f)
-					fCurrentZoom -= fElapsedTime * fZoomSpeed;
-
-				bHover = false;
+				fZoomTarget = fTarget;
+				tweens.Start(nZoomTween, fCurrentZoom, fTarget, std::fabs(fTarget - fCurrentZoom) / fZoomSpeed);
+				bZoomTweening = true;
 			}
 
+			if (bZoomTweening)
+			{
+				fCurrentZoom = tweens.Get(nZoomTween);
+				bZoomTweening = tweens.IsActive(nZoomTween);
+			}
 		}
 
 		vecDrawSize = vecSize * fCurrentZoom;
 	}
 	else
 	{
-		fCurrentAlpha += fTransitionDirection * fTransitionSpeed * fElapsedTime;
-
-		if (fCurrentAlpha < 0.0f)
+		// fTransitionDirection can still be set directly, so start the fade whenever it changes
+		if (fTransitionDirection != fFadeDirection)
 		{
-			fTransitionDirection = 0.0f;
-			fCurrentAlpha = 0.0f;
-			bVisible = false;
+			fFadeDirection = fTransitionDirection;
+
+			const float fTarget = fTransitionDirection > 0.0f ? 1.0f : 0.0f;
+			tweens.Start(nAlphaTween, fCurrentAlpha, fTarget, std::fabs(fTarget - fCurrentAlpha) / fTransitionSpeed);
 		}
-		else if (fCurrentAlpha > 1.0f)
+
+		fCurrentAlpha = tweens.Get(nAlphaTween);
+
+		if (!tweens.IsActive(nAlphaTween))
 		{
 			fTransitionDirection = 0.0f;
-			fCurrentAlpha = 1.0f;
+			fFadeDirection = 0.0f;
+
+			if (fCurrentAlpha <= 0.0f)
+				bVisible = false;
 		}
 	}
 }
@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|          OneLoneCoder Pixel Game Engine Extension           |
-	|                        Menu - v1.0                          |
+	|                        Menu - v1.1                          |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -22,6 +22,11 @@
 		olcPGEX_Menu.cpp
 		olcPGEX_MenuItem.h (this file)
 		olcPGEX_MenuItem.cpp
+		olcPGEX_Tween.h (from the main folder, needed since v1.1)
+
+	olcPGEX_MenuItem.h includes olcPGEX_Tween.h for you, so it never needs
+	including in your own code, but it must be next to these files (or
+	somewhere on your include path).
 
 	There is an example.cpp file in my github here:
 	https://github.com/justinrichardsmusic/PGEv2_Extensions/menu
@@ -33,6 +38,16 @@
 	Enjoy.
 
 
+	v1.1 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+
+	The hover zoom and the fades when a menu transitions in or out are now
+	run by the shared olcPGEX_Tween engine, so items that are sitting still
+	cost nothing to update.  Nothing changes in how you use menus, other
+	than menus and menu items can no longer be copied (each one owns its
+	tweens, which are released when it is destroyed).
+
+
 	License (OLC-3)
 	~~~~~~~~~~~~~~~
 
@@ -74,12 +89,18 @@
 
 #pragma once
 #include "olcPixelGameEngine.h"
+#include "olcPGEX_Tween.h"
 
 class olcPGEX_MenuItem : public olc::PGEX
 {
 public:
 	olcPGEX_MenuItem();
 	olcPGEX_MenuItem(const int ID, olc::Decal* decal, const olc::vf2d pos, const olc::vf2d size, const olc::vf2d sourcePos = { 0.0f, 0.0f }, const bool visible = true, const bool enabled = true, const float zoomFactor = 1.2f, const bool centered = true, const bool isStatic = false);
+	virtual ~olcPGEX_MenuItem();
+
+	// Each item owns its tweens, so items are not copied (menus keep them by pointer)
+	olcPGEX_MenuItem(const olcPGEX_MenuItem&) = delete;
+	olcPGEX_MenuItem& operator=(const olcPGEX_MenuItem&) = delete;
 
 	int			nID =				-1;
 	bool			bVisible =			true;
@@ -112,10 +133,18 @@ private:
 	olc::vf2d		vecCenterPos			{};
 	olc::vf2d		vecHalfSize			{};
 
+	int			nZoomTween =			-1;
+	int			nAlphaTween =			-1;
+	float			fZoomTarget =			1.0f;
+	bool			bZoomTweening =			false;
+	float			fFadeDirection =		0.0f;		// The direction the alpha tween was last started in
+
 	bool			i_FPointInsideRect(olc::vf2d point, olc::vf2d rPos, olc::vf2d rSize);
+	void			i_CreateTweens();
 
 public:
 	void			Construct(const int ID, olc::Decal* decal, const olc::vf2d pos, const olc::vf2d size, const olc::vf2d sourcePos = { 0.0f, 0.0f }, const bool visible = true, const bool enabled = true, const float zoomFactor = 1.2f, const bool centered = true, const bool isStatic = false);
+	void			StartFade(const float transitionDirection, const float speed = 2.0f);
 	void			Update(const float fElapsedTime, const olc::vi2d mousePos);
 	void			Draw();
 	void			Reposition(const olc::vf2d newPos, const olc::vf2d newSize = { 0.0f, 0.0f }, const bool centered = true);
@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|    OneLoneCoder Pixel Game Engine - Framework Extension     |
-	|                    PGE_GAME_2D v1.0                         |
+	|                    PGE_GAME_2D v1.3                         |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -78,6 +78,53 @@
 	add your own code and get cracking on making a game!
 	
 	
+	v1.1 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	Changing scenes no longer leaves a black screen while the next scene
+	loads its images.  Tell the backend which images each game state
+	needs (in OnUserCreate for example)...
+	
+		AddSceneResource(LEVEL_1, "./assets/level1_tiles.png");
+		AddSceneResource(LEVEL_1, "./assets/level1_enemies.png");
+	
+	... then change scene with a transition...
+	
+		ChangeScene(LEVEL_1, BLACK, 2.0f);
+	
+	The images start loading in the background (on threadPool) as the
+	screen fades out.  The game state only changes, and the screen only
+	fades back in, once the fade out has finished AND everything has
+	loaded.  Use rm.RM_Sprite as normal in the new scene, the images are
+	already there.
+	
+	fLastSceneLoadOverrun is how many seconds the screen had to stay
+	covered waiting for loading after the fade out finished (0.0f means
+	the loading was completely hidden by the transition), and
+	IsChangingScene() tells you if a change is still in progress.  A
+	ChangeScene made while another change is in progress is ignored and
+	returns false.
+	
+	
+	v1.2 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	Images added with AddSceneResource for the starting game state
+	(MAIN_MENU unless you change it) are loaded while the splash screen
+	plays, so the game is ready to go as soon as it finishes.  Anything
+	else can be loaded at the same time from OnUserCreate...
+	
+		splashScreen.AddPreloadJob([&]() { LoadLevelData(); }, &threadPool);
+	
+	
+	v1.3 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	(With PGE_GAME_WITH_AUDIO) Audio sources set to spatial have their
+	volume and pan updated at the end of every frame, all in one go, and
+	big audio files (music) are streamed and loaded on threadPool.
+	Keep the listener where the player is...
+	
+		AL.UpdatePosition(vecPlayerPos);
+	
+	
 
 	License (OLC-3)
 	~~~~~~~~~~~~~~~
@@ -123,6 +170,7 @@
 #include "olcPixelGameEngine.h"
 #include "PGE_GAME_2D_Constants.h"
 
+#define OLC_PGEX_RESOURCE_MANAGER_IMPLEMENTATION
 #include "olcPGEX_ResourceManager.h"
 #include "olcPGEX_SplashScreen.h"
 #include "olcPGEX_Camera2D.h"
@@ -132,7 +180,7 @@
 #include "olcPGEX_ScrollingTile.h"
 #define INTERACTABLE_IMPLEMENTATION
 #include "olcPGEX_Interactable.h"
-#define TRANSITION_IMPLEMENTATION
+#define OLC_PGEX_TRANSITION_IMPLEMENTATION
 #include "olcPGEX_Transition.h"
 
 #ifdef PGE_GAME_WITH_AUDIO
@@ -144,6 +192,8 @@
 
 #endif
 
+#include <map>
+
 
 
 ////////////////////////////////////
@@ -164,6 +214,26 @@ namespace GAME2D
 		olcPGEX_Camera2D				camera{};			// 2D camera
 		olcPGEX_ScrollingTile				scrollingTile{};		// Scrolling Tile
 		std::vector<olcPGEX_Transition>			transitions{};			// Transitions
+		olcPGEX_ThreadPool				threadPool{};			// Worker threads for background loading
+
+	private:
+		// Scene changes
+		enum class SCENE_CHANGE
+		{
+			NONE,
+			FADING_OUT,
+			LOADING,
+			FADING_IN,
+		};
+
+		SCENE_CHANGE sceneChange =			SCENE_CHANGE::NONE;
+		int nSceneGameState =				0;				// Game state being changed to
+		int nSceneTransition =				0;				// Transition covering the change
+		float fSceneSpeed =				1.0f;
+		float fSceneLoadWait =				0.0f;				// Time spent covered, waiting for loads
+		std::map<int, std::vector<std::string>>		mSceneResources{};		// Images each game state needs
+
+		void i_UpdateSceneChange();
 
 	private:
 		// Backend Variables
@@ -182,6 +252,7 @@ namespace GAME2D
 		int nGameState{};								// Current game state
 		int nNextGameState{};								// Game state to transition to next frame
 		int nTransitionGameState =			NO_TRANSITION_STATE;		// Game state to transition to once a particular transition has finished
+		float fLastSceneLoadOverrun =			0.0f;				// Seconds the last scene change waited for loading after its fade out
 
 		// Audio
 		#ifdef PGE_GAME_WITH_AUDIO
@@ -211,6 +282,10 @@ namespace GAME2D
 		void StartScreenTransition(int transitionID, float transitionDirection, float speed = 1.0f);
 		void StopScreenTransition(int transitionID = ALL_TRANSITIONS);
 		bool AnyScreenTransitionHasFinished();
+
+		void AddSceneResource(int gameState, const std::string& fileName);
+		bool ChangeScene(int gameState, int transitionID = BLACK, float speed = 1.0f);
+		bool IsChangingScene() const { return sceneChange != SCENE_CHANGE::NONE; }
 	};
 
 
@@ -235,7 +310,7 @@ namespace GAME2D
 		bSplashScreenOn = splashScreenOn;
 		if (bSplashScreenOn)
 		{
-			splashScreen.SetOptions(3, 1, 3.0f, 0.0f, olc::BLACK, olc::GREEN, olc::DARK_GREEN, olc::CYAN, PGE_GAME_2D_ENABLED);
+			splashScreen.SetOptions(3, 1, 3.0f, 0.0f, olc::BLACK, olc::GREEN, olc::DARK_GREEN, olc::CYAN);
 			std::cout << "Splash screen ON\n";
 		}
 
@@ -249,6 +324,7 @@ namespace GAME2D
 
 		// Audio
 		#ifdef PGE_GAME_WITH_AUDIO
+		AL.pThreadPool = &threadPool;
 		AL.AudioSystemInit();
 		std::cout << "SDL2 Audio initialised...\n";
 		std::cout << "Default Menu Audio Sample ";
@@ -287,6 +363,15 @@ namespace GAME2D
 		// Run splash screen and return prior to further code execution
 		if (bSplashScreenOn)
 		{
+			// The starting scene's images load behind the splash screen
+			if (bFirstUpdateFrame)
+			{
+				auto it = mSceneResources.find(nGameState);
+				if (it != mSceneResources.end())
+					for (auto& fileName : it->second)
+						splashScreen.AddPreloadSprite(rm, fileName, &threadPool);
+			}
+
 			bFirstUpdateFrame = false;
 
 			if (splashScreen.AnimateSplashScreen(fElapsedTime))
@@ -297,9 +382,9 @@ namespace GAME2D
 
 		// Update camera
 		if (clampSize > NO_CLAMP)
-			camera.vecCamPos = camera.LerpCamera(camera.ClampVector({ 0, 0 }, clampSize, (cameraPosition - fScreenSize / 2.0f)), camera.fSpeed);
+			camera.vecCamPos = camera.LerpCamera(camera.ClampVector({ 0, 0 }, clampSize, (cameraPosition - camera.WorldViewSize() / 2.0f)), camera.fSpeed, fElapsedTime);
 		else
-			camera.vecCamPos = camera.LerpCamera(cameraPosition - fScreenSize / 2.0f, camera.fSpeed);
+			camera.vecCamPos = camera.LerpCamera(cameraPosition - camera.WorldViewSize() / 2.0f, camera.fSpeed, fElapsedTime);
 
 		// Update Scrolling Tile
 		if (bUseScrollingTile)
@@ -313,6 +398,16 @@ namespace GAME2D
 		// Process and Display Transitions
 		olcPGEX_Transition::ProcessTransitions(transitions, fElapsedTime, fScreenSize);
 
+		// Hand over any images that have finished loading, and move scene changes along
+		rm.RM_UpdatePreloads();
+		i_UpdateSceneChange();
+
+		#ifdef PGE_GAME_WITH_AUDIO
+		// Everything has moved for this frame, so bring the volume and pan of positioned sounds up to date,
+		// decide which voices are worth mixing, and pass this frame's audio changes on to SoLoud in one go
+		AL.UpdateAudio();
+		#endif
+
 		// Automate Game State changes when set transitions have finished
 		if (AnyScreenTransitionHasFinished() && nTransitionGameState != NO_TRANSITION_STATE)
 		{
@@ -359,10 +454,8 @@ namespace GAME2D
 	{
 		// Turn the scolling tile option on and set its values
 		bUseScrollingTile = true;
-		if (altDecal != nullptr)
-			scrollingTile.SetTileValues(iScreenSize, tileSize, decal, altDecal);
-		else
-			scrollingTile.SetTileValues(iScreenSize, tileSize, decal);
+		scrollingTile.SetTileValues(iScreenSize, tileSize, decal, altDecal);
+		scrollingTile.SetDrawMode(olcPGEX_ScrollingTile::DrawMode::CACHED_STRIP);		// whole background in a single decal
 
 		std::cout << "Scrolling Tile mode ON...\n";
 	}
@@ -436,6 +529,81 @@ namespace GAME2D
 	}
 
 
+	void PGE_GAME_2D_BACKEND::AddSceneResource(int gameState, const std::string& fileName)
+	{
+		mSceneResources[gameState].push_back(fileName);
+	}
+
+	bool PGE_GAME_2D_BACKEND::ChangeScene(int gameState, int transitionID, float speed)
+	{
+		// Half way through a change the transition and the loading belong to that scene, so let it finish
+		if (IsChangingScene())
+		{
+			std::cout << "Already changing scene to game state " << nSceneGameState << ", ignoring change to " << gameState << "\n";
+			return false;
+		}
+
+		nSceneGameState = gameState;
+		nSceneTransition = transitionID;
+		fSceneSpeed = speed;
+		fSceneLoadWait = 0.0f;
+
+		// Start loading straight away so it happens behind the fade out
+		auto it = mSceneResources.find(gameState);
+		if (it != mSceneResources.end())
+			for (auto& fileName : it->second)
+				rm.RM_PreloadSprite(fileName, &threadPool);
+
+		if (bUseTransitions && transitionID >= 0 && transitionID < (int)transitions.size())
+		{
+			StartScreenTransition(transitionID, 1.0f, speed);
+			sceneChange = SCENE_CHANGE::FADING_OUT;
+		}
+		else
+			sceneChange = SCENE_CHANGE::LOADING;
+
+		std::cout << "Changing scene to game state " << gameState << "...\n";
+		return true;
+	}
+
+	void PGE_GAME_2D_BACKEND::i_UpdateSceneChange()
+	{
+		const bool bTransition = bUseTransitions && nSceneTransition >= 0 && nSceneTransition < (int)transitions.size();
+
+		if (sceneChange == SCENE_CHANGE::FADING_OUT && transitions[nSceneTransition].bTransitionFinished)
+			sceneChange = SCENE_CHANGE::LOADING;
+
+		if (sceneChange == SCENE_CHANGE::LOADING)
+		{
+			// The screen stays covered until everything has loaded
+			if (rm.RM_PreloadsPending() > 0)
+			{
+				fSceneLoadWait += fElapsedTime;
+				return;
+			}
+
+			fLastSceneLoadOverrun = fSceneLoadWait;
+			nNextGameState = nSceneGameState;
+
+			if (fLastSceneLoadOverrun > 0.0f)
+				std::cout << "Scene loading overran the transition by " << fLastSceneLoadOverrun << " seconds\n";
+
+			if (bTransition)
+			{
+				StartScreenTransition(nSceneTransition, -1.0f, fSceneSpeed);
+				sceneChange = SCENE_CHANGE::FADING_IN;
+			}
+			else
+				sceneChange = SCENE_CHANGE::NONE;
+
+			return;
+		}
+
+		if (sceneChange == SCENE_CHANGE::FADING_IN && transitions[nSceneTransition].bTransitionFinished)
+			sceneChange = SCENE_CHANGE::NONE;
+	}
+
+
 	PGE_GAME_2D_BACKEND::~PGE_GAME_2D_BACKEND()
 	{
 		// Audio
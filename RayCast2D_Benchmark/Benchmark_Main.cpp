@@ -0,0 +1,217 @@
+/////////////////////////////////////////////
+//                                         //
+//   olcPGEX_RayCast2D - BENCHMARK         //
+//       by  Justin Richards               //
+//                                         //
+/////////////////////////////////////////////
+
+// A console program (no window is opened) that measures how many rays per
+// second each of the ray caster's query paths can handle as the number of
+// edges grows:
+//
+//		single edge		-	RayCastVsEdge called for every edge, keeping the closest
+//		edge set		-	RayCastVsEdgeSet (SSE / AVX)
+//		grid			-	RayCastVsEdgeGrid
+//		batch set		-	RayCastBatch over the edge set (thread pool)
+//		batch grid		-	RayCastBatch over the grid (thread pool)
+//
+// Two kinds of scene are tested.  Random scenes are short randomly placed
+// edges, spread over an area that grows with the edge count so the density
+// stays roughly the same (much like a real level gets bigger rather than
+// more crowded).  Level scenes are the merged outline of a tile map full of
+// rooms and pillars, so lots of axis aligned edges sharing end points.
+//
+// The closest hit of every path is compared against the edge set query so
+// you can be sure the faster paths are also the correct ones.  For a much
+// more thorough check against a high precision reference see Fuzzer_Main.cpp
+
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+
+#define OLC_PGEX_RAYCAST2D_IMPLEMENTATION
+#include "olcPGEX_RayCast2D.h"
+
+#include <chrono>
+#include <random>
+
+using sRay = olcPGEX_RayCast2D::sRay;
+using sRayHit = olcPGEX_RayCast2D::sRayHit;
+
+// Build a scene of short random edges and a set of line-of-sight rays through it
+void BuildRandomScene(const int nEdges, const int nRays, std::mt19937& rng, olcPGEX_RayCast2D::sEdgeSet& edges, std::vector<sRay>& rays)
+{
+	const float fWorldSize = std::sqrt((float)nEdges) * 40.0f;
+	std::uniform_real_distribution<float> distPos(0.0f, fWorldSize);
+	std::uniform_real_distribution<float> distAngle(0.0f, 6.2831853f);
+	std::uniform_real_distribution<float> distEdgeLength(8.0f, 64.0f);
+
+	edges.Clear();
+	for (int i = 0; i < nEdges; i++)
+	{
+		const olc::vf2d vecStart = { distPos(rng), distPos(rng) };
+		const float fAngle = distAngle(rng);
+		edges.AddEdge(vecStart, vecStart + olc::vf2d{ std::cos(fAngle), std::sin(fAngle) } * distEdgeLength(rng));
+	}
+
+	rays.clear();
+	for (int i = 0; i < nRays; i++)
+	{
+		const olc::vf2d vecStart = { distPos(rng), distPos(rng) };
+		const float fAngle = distAngle(rng);
+		rays.push_back({ vecStart, vecStart + olc::vf2d{ std::cos(fAngle), std::sin(fAngle) } * 400.0f });
+	}
+}
+
+// Build a tile map level of walls, rooms and pillars, extract its outline and cast rays from the empty tiles
+void BuildLevelScene(const int nMapSize, const int nRays, std::mt19937& rng, olcPGEX_RayCast2D& rayCaster2D, olcPGEX_RayCast2D::sEdgeSet& edges, std::vector<sRay>& rays)
+{
+	const olc::vf2d vecTileSize = { 16.0f, 16.0f };
+	std::vector<uint8_t> vTiles(nMapSize * nMapSize, 0);
+	auto tile = [&](const int x, const int y) -> uint8_t& { return vTiles[y * nMapSize + x]; };
+
+	// Outer wall plus a room every 12 tiles with a doorway in each wall
+	for (int y = 0; y < nMapSize; y++)
+		for (int x = 0; x < nMapSize; x++)
+		{
+			const bool bWallX = (x % 12 == 0) && (y % 12 != 6);
+			const bool bWallY = (y % 12 == 0) && (x % 12 != 6);
+			if (x == 0 || y == 0 || x == nMapSize - 1 || y == nMapSize - 1 || bWallX || bWallY)
+				tile(x, y) = 1;
+		}
+
+	// Scatter some pillars of 1 - 2 tiles
+	std::uniform_int_distribution<int> distTile(1, nMapSize - 3);
+	for (int i = 0; i < nMapSize * nMapSize / 20; i++)
+	{
+		const int x = distTile(rng), y = distTile(rng);
+		tile(x, y) = 1;
+		if (rng() % 2) tile(x + 1, y) = 1;
+		if (rng() % 2) tile(x, y + 1) = 1;
+	}
+
+	olcPGEX_RayCast2D::sTileEdgeMap tileEdges;
+	rayCaster2D.BuildTileEdges(tileEdges, { nMapSize, nMapSize }, vecTileSize, vTiles.data(), edges);
+
+	std::uniform_real_distribution<float> distAngle(0.0f, 6.2831853f);
+	rays.clear();
+	while ((int)rays.size() < nRays)
+	{
+		const int x = distTile(rng), y = distTile(rng);
+		if (tile(x, y) != 0)
+			continue;
+
+		const olc::vf2d vecStart = (olc::vf2d{ (float)x, (float)y } + olc::vf2d{ 0.5f, 0.5f }) * vecTileSize;
+		const float fAngle = distAngle(rng);
+		rays.push_back({ vecStart, vecStart + olc::vf2d{ std::cos(fAngle), std::sin(fAngle) } * 400.0f });
+	}
+}
+
+// Same closest hit (ties on distance may legitimately pick different edges)
+bool SameHit(const sRayHit& a, const sRayHit& b)
+{
+	return a.fDistance == b.fDistance && (a.nEdgeIndex < 0) == (b.nEdgeIndex < 0);
+}
+
+template<typename Func>
+double RaysPerSecond(const size_t nRays, Func&& func)
+{
+	auto tp1 = std::chrono::high_resolution_clock::now();
+	func();
+	auto tp2 = std::chrono::high_resolution_clock::now();
+	return (double)nRays / std::chrono::duration<double>(tp2 - tp1).count();
+}
+
+void RunScene(const char* sName, olcPGEX_RayCast2D& rayCaster2D, olcPGEX_ThreadPool& threadPool, const olcPGEX_RayCast2D::sEdgeSet& edges, const std::vector<sRay>& rays)
+{
+	olcPGEX_RayCast2D::sEdgeGrid grid;
+	rayCaster2D.BuildEdgeGrid(edges, grid);
+
+	// The brute force paths test every edge for every ray, so use fewer rays on big scenes
+	const size_t nBruteRays = std::min(rays.size(), std::max<size_t>(200, 40000000 / std::max<size_t>(1, edges.Size())));
+	const std::vector<sRay> bruteRays(rays.begin(), rays.begin() + nBruteRays);
+
+	std::vector<sRayHit> singleHits(bruteRays.size());
+	std::vector<sRayHit> setHits(bruteRays.size());
+	std::vector<sRayHit> gridHits(rays.size());
+	std::vector<sRayHit> batchSetHits;
+	std::vector<sRayHit> batchGridHits;
+
+	// The original API, one edge at a time - exactly what a user's loop over their edges looks like
+	const double fSingle = RaysPerSecond(bruteRays.size(), [&]()
+	{
+		for (size_t r = 0; r < bruteRays.size(); r++)
+		{
+			olc::vf2d vecHit;
+			float fDistance = 0.0f;
+			for (size_t i = 0; i < edges.Size(); i++)
+			{
+				const olc::vf2d vecEdgeStart = { edges.vStartX[i], edges.vStartY[i] };
+				const olc::vf2d vecEdgeEnd = vecEdgeStart + olc::vf2d{ edges.vDeltaX[i], edges.vDeltaY[i] };
+				if (rayCaster2D.RayCastVsEdge(bruteRays[r].vecStart, bruteRays[r].vecEnd, vecEdgeStart, vecEdgeEnd, vecHit, fDistance) && fDistance < singleHits[r].fDistance)
+				{
+					singleHits[r].fDistance = fDistance;
+					singleHits[r].nEdgeIndex = (int)i;
+				}
+			}
+		}
+	});
+
+	const double fSet = RaysPerSecond(bruteRays.size(), [&]()
+	{
+		for (size_t r = 0; r < bruteRays.size(); r++)
+			rayCaster2D.RayCastVsEdgeSet(bruteRays[r].vecStart, bruteRays[r].vecEnd, edges, setHits[r]);
+	});
+
+	const double fGrid = RaysPerSecond(rays.size(), [&]()
+	{
+		for (size_t r = 0; r < rays.size(); r++)
+			rayCaster2D.RayCastVsEdgeGrid(rays[r].vecStart, rays[r].vecEnd, grid, gridHits[r]);
+	});
+
+	const double fBatchSet = RaysPerSecond(bruteRays.size(), [&]() { rayCaster2D.RayCastBatch(bruteRays, edges, batchSetHits, &threadPool); });
+	const double fBatchGrid = RaysPerSecond(rays.size(), [&]() { rayCaster2D.RayCastBatch(rays, grid, batchGridHits, &threadPool); });
+
+	// Everything is compared against the edge set query on the rays both were given
+	int nMismatches = 0;
+	for (size_t r = 0; r < bruteRays.size(); r++)
+		if (!SameHit(setHits[r], singleHits[r]) || !SameHit(setHits[r], gridHits[r]) || !SameHit(setHits[r], batchSetHits[r]))
+			nMismatches++;
+	for (size_t r = 0; r < rays.size(); r++)
+		if (!SameHit(gridHits[r], batchGridHits[r]))
+			nMismatches++;
+
+	printf("%-7s | %7d | %12.0f | %12.0f | %12.0f | %12.0f | %12.0f | %d\n", sName, (int)edges.Size(), fSingle, fSet, fGrid, fBatchSet, fBatchGrid, nMismatches);
+}
+
+int main()
+{
+	olcPGEX_RayCast2D rayCaster2D;
+	olcPGEX_ThreadPool threadPool;
+	std::mt19937 rng(2020);
+
+	const int nRays = 20000;
+	const int nEdgeCounts[] = { 100, 1000, 10000, 100000 };
+	const int nMapSizes[] = { 24, 72, 240, 720 };
+
+	std::cout << "Worker threads: " << threadPool.WorkerCount() << " (plus the main thread)\n";
+	std::cout << "All figures are rays per second\n\n";
+	std::cout << "scene   |   edges |  single edge |     edge set |         grid |    batch set |   batch grid | mismatches\n";
+	std::cout << "--------+---------+--------------+--------------+--------------+--------------+--------------+-----------\n";
+
+	olcPGEX_RayCast2D::sEdgeSet edges;
+	std::vector<sRay> rays;
+
+	for (const int nEdges : nEdgeCounts)
+	{
+		BuildRandomScene(nEdges, nRays, rng, edges, rays);
+		RunScene("random", rayCaster2D, threadPool, edges, rays);
+	}
+
+	for (const int nMapSize : nMapSizes)
+	{
+		BuildLevelScene(nMapSize, nRays, rng, rayCaster2D, edges, rays);
+		RunScene("level", rayCaster2D, threadPool, edges, rays);
+	}
+
+	return 0;
+}
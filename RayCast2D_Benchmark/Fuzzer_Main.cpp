@@ -0,0 +1,1128 @@
+/////////////////////////////////////////////
+//                                         //
+//   olcPGEX_RayCast2D - FUZZER            //
+//       by  Justin Richards               //
+//                                         //
+/////////////////////////////////////////////
+
+// A console program (no window is opened) that throws lots of random and
+// awkward scenes at every ray caster query path and checks each result
+// against a simple high precision (long double) reference:
+//
+//		edges			-	RayCastVsEdge, the edge set, grid, batch, dynamic and tier queries
+//		tile grid		-	RayCastVsTileGrid, with a byte array and with a callable
+//		shapes			-	the circle, AABB, OBB and convex polygon ray casts and the swept tests
+//		visibility		-	CalculateVisibilityPolygon and sVisibilityPolygon::Contains
+//
+// The scenes are deliberately nasty: axis aligned tile outlines with shared
+// end points, rays aimed exactly at edge end points, corners and vertices,
+// rays and edges that share an x or y component, and coordinates at very
+// small and very large scales.
+//
+// Floating point results that sit right on a boundary (hitting the exact
+// end of an edge, almost parallel edges, grazing a circle etc) can
+// legitimately go either way, so the reference marks these as borderline.
+// A borderline case may hit or miss, but a hit must still be within
+// tolerance of where the reference says it is.  Everything else must agree.
+//
+//		Fuzzer [iterations] [seed]
+//
+// Returns 0 if there were no mismatches, 1 otherwise.
+
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+
+#define OLC_PGEX_RAYCAST2D_IMPLEMENTATION
+#include "olcPGEX_RayCast2D.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+using sRay = olcPGEX_RayCast2D::sRay;
+using sRayHit = olcPGEX_RayCast2D::sRayHit;
+using vld2d = olc::v2d_generic<long double>;
+
+vld2d ToLD(const olc::vf2d v) { return { (long double)v.x, (long double)v.y }; }
+
+// Tolerance on the normalised distances, far larger than float rounding but far smaller than any real error
+const long double fEpsilon = 1e-4L;
+
+struct sReference
+{
+	bool bHit = false;
+	bool bBorderline = false;
+	bool bParallel = false;										// Borderline with no single crossing point
+	long double t1 = 0.0L;
+	long double fTolerance = fEpsilon;
+};
+
+// The reference - same bounds as the ray caster (0 < t1 < 1, 0 < t2 <= 1) in long double precision
+sReference ReferenceIntersect(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd)
+{
+	const long double rx = (long double)vecRayEnd.x - vecRayStart.x, ry = (long double)vecRayEnd.y - vecRayStart.y;
+	const long double ex = (long double)vecEdgeEnd.x - vecEdgeStart.x, ey = (long double)vecEdgeEnd.y - vecEdgeStart.y;
+	const long double dx = (long double)vecEdgeStart.x - vecRayStart.x, dy = (long double)vecEdgeStart.y - vecRayStart.y;
+
+	sReference ref;
+	const long double fDenom = ex * ry - ey * rx;
+	const long double fScale = std::sqrt((ex * ex + ey * ey) * (rx * rx + ry * ry));
+
+	// Parallel, almost parallel or zero length - the float versions may go either way
+	if (fScale == 0.0L || std::fabs(fDenom) <= fScale * 1e-5L)
+	{
+		ref.bBorderline = true;
+		ref.bParallel = true;
+		return ref;
+	}
+
+	ref.t1 = (dy * ex - dx * ey) / fDenom;
+	const long double t2 = (rx * dy - ry * dx) / fDenom;
+
+	ref.bHit = ref.t1 > 0.0L && ref.t1 < 1.0L && t2 > 0.0L && t2 <= 1.0L;
+
+	// Float rounding in the products is magnified by how close to parallel the lines are
+	const long double fLengthD = std::sqrt(dx * dx + dy * dy);
+	const long double fLengthE = std::sqrt(ex * ex + ey * ey);
+	const long double fLengthR = std::sqrt(rx * rx + ry * ry);
+	ref.fTolerance = fEpsilon + 1e-6L * (fLengthD * std::max(fLengthE, fLengthR) + fLengthE * fLengthR) / std::fabs(fDenom);
+
+	auto near = [&](const long double a, const long double b) { return std::fabs(a - b) <= ref.fTolerance; };
+	ref.bBorderline = near(ref.t1, 0.0L) || near(ref.t1, 1.0L) || near(t2, 0.0L) || near(t2, 1.0L);
+	return ref;
+}
+
+long double DistanceToSegment(const vld2d vecPoint, const vld2d vecStart, const vld2d vecEnd)
+{
+	const vld2d vecDelta = vecEnd - vecStart;
+	const long double fLength2 = vecDelta.dot(vecDelta);
+	const long double t = fLength2 > 0.0L ? std::min(std::max((vecPoint - vecStart).dot(vecDelta) / fLength2, 0.0L), 1.0L) : 0.0L;
+	return (vecStart + vecDelta * t - vecPoint).mag();
+}
+
+// How far a point is from the surface of a shape, negative inside
+long double BoxSurface(const vld2d vecPoint, const vld2d vecMin, const vld2d vecMax)
+{
+	const vld2d vecOutside = { std::max(vecMin.x - vecPoint.x, vecPoint.x - vecMax.x), std::max(vecMin.y - vecPoint.y, vecPoint.y - vecMax.y) };
+	return vld2d{ std::max(vecOutside.x, 0.0L), std::max(vecOutside.y, 0.0L) }.mag() + std::min(std::max(vecOutside.x, vecOutside.y), 0.0L);
+}
+
+long double PolygonSurface(const vld2d vecPoint, const std::vector<vld2d>& vPoints)
+{
+	const long double fWinding = (vPoints[1] - vPoints[0]).cross(vPoints[2] - vPoints[1]) < 0.0L ? -1.0L : 1.0L;
+	long double fDistance = std::numeric_limits<long double>::infinity();
+	bool bInside = true;
+	for (size_t i = 0; i < vPoints.size(); i++)
+	{
+		const vld2d vecA = vPoints[i];
+		const vld2d vecB = vPoints[(i + 1) % vPoints.size()];
+		fDistance = std::min(fDistance, DistanceToSegment(vecPoint, vecA, vecB));
+		bInside &= (vecB - vecA).cross(vecPoint - vecA) * fWinding >= 0.0L;
+	}
+	return bInside ? -fDistance : fDistance;
+}
+
+// Could a hit at t (vecPoint) on this edge be right?  A borderline edge may or may not be hit, but when it is
+// the hit must still be where the ray meets it.  Parallel edges have no single crossing, so the hit just has
+// to lie on the edge
+bool HitMatchesEdge(const sReference& ref, const long double t, const vld2d vecPoint, const vld2d vecEdgeStart, const vld2d vecEdgeEnd, const long double fRayLength)
+{
+	if (!ref.bHit && !ref.bBorderline)
+		return false;
+
+	if (ref.bParallel)
+		return t > 0.0L && t < 1.0L && DistanceToSegment(vecPoint, vecEdgeStart, vecEdgeEnd) <= fEpsilon * (fRayLength + (vecEdgeEnd - vecEdgeStart).mag());
+
+	return std::fabs(t - ref.t1) <= ref.fTolerance;
+}
+
+enum { SINGLE, SET, GRID, BATCH_SET, BATCH_GRID, DYNAMIC, TIERS, TILE_GRID, CIRCLE, AABB, OBB, POLYGON, SWEPT_AABB, SWEPT_CIRCLE, SWEPT_EDGE, VIS_FAN, VIS_CONTAINS, PATH_COUNT };
+
+struct sPathStats
+{
+	std::string sName;
+	long long nTests = 0;
+	long long nBorderline = 0;
+	long long nMismatches = 0;
+};
+
+struct sScene
+{
+	olcPGEX_RayCast2D::sEdgeSet edges;
+	std::vector<sRay> rays;
+	std::string sKind;
+	float fWorld = 1.0f;
+
+	// Tile grid for RayCastVsTileGrid, a procedural (callable) grid when there is no tile map
+	std::vector<uint8_t> vTiles;
+	int nTiles = 0;
+	float fTileSize = 1.0f;
+};
+
+olc::vf2d EdgeStart(const olcPGEX_RayCast2D::sEdgeSet& edges, const size_t i) { return { edges.vStartX[i], edges.vStartY[i] }; }
+olc::vf2d EdgeEnd(const olcPGEX_RayCast2D::sEdgeSet& edges, const size_t i) { return EdgeStart(edges, i) + olc::vf2d{ edges.vDeltaX[i], edges.vDeltaY[i] }; }
+
+void BuildScene(std::mt19937& rng, olcPGEX_RayCast2D& rayCaster2D, sScene& scene)
+{
+	std::uniform_real_distribution<float> distUnit(0.0f, 1.0f);
+	std::uniform_real_distribution<float> distAngle(0.0f, 6.2831853f);
+
+	// Very small to very large worlds
+	const float fScales[] = { 0.01f, 1.0f, 100.0f, 10000.0f };
+	const float fScale = fScales[rng() % 4];
+	const float fWorld = 100.0f * fScale;
+
+	scene.edges.Clear();
+	scene.rays.clear();
+	scene.fWorld = fWorld;
+	scene.vTiles.clear();
+	scene.nTiles = 0;
+	scene.fTileSize = fWorld / (float)(4 + rng() % 28);
+
+	const int nKind = rng() % 3;
+	if (nKind == 0)
+	{
+		// Random edges of any length and direction
+		scene.sKind = "random";
+		const int nEdges = 1 + rng() % 200;
+		for (int i = 0; i < nEdges; i++)
+		{
+			const olc::vf2d vecStart = { distUnit(rng) * fWorld, distUnit(rng) * fWorld };
+			scene.edges.AddEdge(vecStart, { distUnit(rng) * fWorld, distUnit(rng) * fWorld });
+		}
+	}
+	else if (nKind == 1)
+	{
+		// Tile map outline - axis aligned, shared end points and collinear runs
+		scene.sKind = "tiles";
+		const int nSize = 4 + rng() % 28;
+		std::vector<uint8_t> vTiles(nSize * nSize);
+		for (auto& t : vTiles)
+			t = (rng() % 3 == 0) ? 1 : 0;
+
+		olcPGEX_RayCast2D::sTileEdgeMap tileEdges;
+		rayCaster2D.BuildTileEdges(tileEdges, { nSize, nSize }, { fWorld / nSize, fWorld / nSize }, vTiles.data(), scene.edges);
+
+		scene.vTiles = vTiles;
+		scene.nTiles = nSize;
+		scene.fTileSize = fWorld / nSize;
+	}
+	else
+	{
+		// Boxes and axis aligned lines, so lots of edges share an x or y component with each other
+		scene.sKind = "boxes";
+		const int nBoxes = 1 + rng() % 50;
+		for (int i = 0; i < nBoxes; i++)
+		{
+			const olc::vf2d vecPos = { std::floor(distUnit(rng) * 20.0f) * fWorld / 20.0f, std::floor(distUnit(rng) * 20.0f) * fWorld / 20.0f };
+			const olc::vf2d vecSize = olc::vf2d{ 1.0f + std::floor(distUnit(rng) * 4.0f), 1.0f + std::floor(distUnit(rng) * 4.0f) } * (fWorld / 20.0f);
+			scene.edges.AddEdge(vecPos, vecPos + olc::vf2d{ vecSize.x, 0.0f });
+			scene.edges.AddEdge(vecPos + olc::vf2d{ vecSize.x, 0.0f }, vecPos + vecSize);
+			scene.edges.AddEdge(vecPos + vecSize, vecPos + olc::vf2d{ 0.0f, vecSize.y });
+			scene.edges.AddEdge(vecPos + olc::vf2d{ 0.0f, vecSize.y }, vecPos);
+		}
+	}
+
+	if (scene.edges.Size() == 0)
+		scene.edges.AddEdge({ 0.0f, 0.0f }, { fWorld, fWorld });
+
+	// A mixture of rays, including the awkward ones
+	const int nRays = 64;
+	for (int i = 0; i < nRays; i++)
+	{
+		const olc::vf2d vecStart = { distUnit(rng) * fWorld, distUnit(rng) * fWorld };
+		const size_t nEdge = rng() % scene.edges.Size();
+		const olc::vf2d vecEdgeDelta = { scene.edges.vDeltaX[nEdge], scene.edges.vDeltaY[nEdge] };
+
+		switch (rng() % 5)
+		{
+		case 0:	// Any direction
+		{
+			const float fAngle = distAngle(rng);
+			scene.rays.push_back({ vecStart, vecStart + olc::vf2d{ std::cos(fAngle), std::sin(fAngle) } * fWorld * distUnit(rng) });
+			break;
+		}
+		case 1:	// Axis aligned
+		{
+			const float fLength = (distUnit(rng) - 0.5f) * 2.0f * fWorld;
+			scene.rays.push_back({ vecStart, vecStart + ((rng() % 2) ? olc::vf2d{ fLength, 0.0f } : olc::vf2d{ 0.0f, fLength }) });
+			break;
+		}
+		case 2:	// Aimed exactly at an edge end point
+			scene.rays.push_back({ vecStart, (rng() % 2) ? EdgeStart(scene.edges, nEdge) : EdgeEnd(scene.edges, nEdge) });
+			break;
+		case 3:	// Through an edge end point and beyond
+			scene.rays.push_back({ vecStart, vecStart + (EdgeStart(scene.edges, nEdge) - vecStart) * 2.0f });
+			break;
+		case 4:	// Shares an x or y component with an edge's delta
+		{
+			const float fOther = (distUnit(rng) - 0.5f) * 2.0f * fWorld;
+			scene.rays.push_back({ vecStart, vecStart + ((rng() % 2) ? olc::vf2d{ vecEdgeDelta.x, fOther } : olc::vf2d{ fOther, vecEdgeDelta.y }) });
+			break;
+		}
+		}
+	}
+}
+
+// Check a closest hit result (from any path) against the reference results for every edge
+void CheckClosest(sPathStats& stats, const std::vector<sReference>& vRefs, const bool bHit, const int nEdge, const float fDistance, int& nReported, const sRay& ray, const sScene& scene)
+{
+	stats.nTests++;
+
+	long double fClosestSure = 2.0L;
+	bool bAnyBorderline = false;
+	for (const auto& ref : vRefs)
+	{
+		if (ref.bHit && !ref.bBorderline && ref.t1 < fClosestSure)
+			fClosestSure = ref.t1;
+		bAnyBorderline |= ref.bBorderline;
+	}
+
+	bool bOk;
+	if (!bHit)
+		bOk = fClosestSure > 1.0L;
+	else
+	{
+		const sReference& ref = vRefs[nEdge];
+		const vld2d vecRay = ToLD(ray.vecEnd) - ToLD(ray.vecStart);
+		bOk = HitMatchesEdge(ref, fDistance, ToLD(ray.vecStart) + vecRay * (long double)fDistance, ToLD(EdgeStart(scene.edges, nEdge)), ToLD(EdgeEnd(scene.edges, nEdge)), vecRay.mag())
+			&& (long double)fDistance <= fClosestSure + ref.fTolerance;
+	}
+
+	if (bOk)
+	{
+		if (bAnyBorderline)
+			stats.nBorderline++;
+		return;
+	}
+
+	stats.nMismatches++;
+	if (nReported++ < 10)
+		printf("  MISMATCH %-22s (%s) ray (%g, %g) -> (%g, %g) : got %s edge %d t %.7f, reference closest %.7Lf\n",
+			stats.sName.c_str(), scene.sKind.c_str(), ray.vecStart.x, ray.vecStart.y, ray.vecEnd.x, ray.vecEnd.y,
+			bHit ? "hit" : "miss", nEdge, fDistance, fClosestSure);
+}
+
+// Reference for RayCastVsTileGrid - the tiles the ray passes through are found from every grid line it
+// crosses (worked out in long double), rather than by stepping like the DDA does.  Solid tiles that are
+// only entered through a corner, or right at the start, may or may not be hit.  The first tile that must be
+// hit is the reference hit
+struct sTileReference
+{
+	bool bHit = false;
+	bool bBorderline = false;
+	long double t = 0.0L;
+	olc::vi2d vecTile{};
+	olc::vf2d vecNormal{};
+	long double fTolerance = fEpsilon;
+	std::vector<std::pair<long double, long double>> vCrossings;	// Every grid line crossed, in order, with its tolerance
+};
+
+template<typename IsSolidFunc>
+sTileReference ReferenceTileGrid(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, IsSolidFunc&& isSolid, const float fTileSize)
+{
+	sTileReference ref;
+	const vld2d vecStart = ToLD(vecRayStart) / (long double)fTileSize;
+	const vld2d vecDistance = (ToLD(vecRayEnd) - ToLD(vecRayStart)) / (long double)fTileSize;
+
+	// A crossing's t carries float rounding of the start in tile units divided by the distance along that axis,
+	// so a ray nearly parallel to the grid lines it crosses gets a much wider window on them
+	struct sCrossing { long double t; int nAxis; long double fTolerance; bool operator<(const sCrossing& c) const { return t < c.t; } };
+	std::vector<sCrossing> vCrossings;
+	for (int a = 0; a < 2; a++)
+	{
+		const long double fStart = a == 0 ? vecStart.x : vecStart.y;
+		const long double fDistance = a == 0 ? vecDistance.x : vecDistance.y;
+
+		// Running along a grid line, either side of it could be the one that counts
+		if (fDistance == 0.0L)
+		{
+			ref.bBorderline |= std::fabs(fStart - std::round(fStart)) <= fEpsilon;
+			continue;
+		}
+
+		// A little past the end as well, as float may put a crossing just before it
+		const long double fEnd = fStart + fDistance;
+		const long double fTolerance = fEpsilon + 1e-6L * (std::fabs(fStart) + std::fabs(fEnd) + 1.0L) / std::fabs(fDistance);
+		for (long double k = std::floor(std::min(fStart, fEnd)); k <= std::ceil(std::max(fStart, fEnd)); k++)
+		{
+			const long double t = (k - fStart) / fDistance;
+			if (t > 0.0L && t < 1.0L + fTolerance)
+				vCrossings.push_back({ t, a, fTolerance });
+		}
+	}
+	std::sort(vCrossings.begin(), vCrossings.end());
+
+	const bool bAlongLine = ref.bBorderline;
+	for (size_t i = 0; i < vCrossings.size(); i++)
+	{
+		const sCrossing& c = vCrossings[i];
+		ref.vCrossings.push_back({ c.t, c.fTolerance });
+		const long double tPrevious = i > 0 ? vCrossings[i - 1].t : 0.0L;
+		const long double fPreviousTolerance = i > 0 ? vCrossings[i - 1].fTolerance : fEpsilon;
+		const long double tNext = i + 1 < vCrossings.size() ? vCrossings[i + 1].t : 1.0L + c.fTolerance;
+		const long double fNextTolerance = i + 1 < vCrossings.size() ? vCrossings[i + 1].fTolerance : fEpsilon;
+
+		// Near a corner the DDA may step through either side of it first, so a solid tile on either side may be hit
+		const bool bNearNext = i + 1 < vCrossings.size() && tNext - c.t <= c.fTolerance + fNextTolerance;
+		if (bNearNext)
+		{
+			const vld2d vecBefore = vecStart + vecDistance * ((tPrevious + c.t) * 0.5L);
+			const olc::vi2d vecTile = { (int)std::floor(vecBefore.x), (int)std::floor(vecBefore.y) };
+			const olc::vi2d vecStep = { vecDistance.x > 0.0L ? 1 : -1, vecDistance.y > 0.0L ? 1 : -1 };
+			ref.bBorderline |= isSolid(vecTile.x + vecStep.x, vecTile.y) || isSolid(vecTile.x, vecTile.y + vecStep.y);
+		}
+
+		// Exactly through a corner, the tile is entered by the next crossing
+		if (tNext - c.t <= 1e-12L)
+			continue;
+
+		// The tile this crossing enters, from the middle of the ray's path through it
+		const vld2d vecMiddle = vecStart + vecDistance * ((c.t + tNext) * 0.5L);
+		const olc::vi2d vecTile = { (int)std::floor(vecMiddle.x), (int)std::floor(vecMiddle.y) };
+		if (!isSolid(vecTile.x, vecTile.y))
+			continue;
+
+		// Close to a corner or the start of the ray, the DDA may step round this tile (or start inside it)
+		if (bAlongLine || bNearNext || c.t - tPrevious <= c.fTolerance + fPreviousTolerance)
+		{
+			ref.bBorderline = true;
+			continue;
+		}
+
+		ref.t = c.t;
+		ref.fTolerance = c.fTolerance;
+		ref.bHit = ref.t < 1.0L;
+		ref.bBorderline |= std::fabs(ref.t - 1.0L) <= c.fTolerance;
+		ref.vecTile = vecTile;
+		ref.vecNormal = c.nAxis == 0 ? olc::vf2d{ vecDistance.x > 0.0L ? -1.0f : 1.0f, 0.0f } : olc::vf2d{ 0.0f, vecDistance.y > 0.0L ? -1.0f : 1.0f };
+		break;
+	}
+
+	return ref;
+}
+
+void CheckTileGrid(olcPGEX_RayCast2D& rayCaster2D, const sScene& scene, sPathStats& stats, int& nReported)
+{
+	const int nTiles = scene.nTiles;
+	auto isMapSolid = [&](const int x, const int y) { return x >= 0 && y >= 0 && x < nTiles && y < nTiles && scene.vTiles[y * nTiles + x] != 0; };
+	auto isProceduralSolid = [](const int x, const int y) { return (((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u)) % 3 == 0; };
+
+	for (const sRay& ray : scene.rays)
+	{
+		olc::vf2d vecHit, vecNormal;
+		olc::vi2d vecTile;
+		float fDistance = 0.0f;
+		bool bHit;
+		sTileReference ref;
+
+		// The byte array version for tile map scenes, a callable covering negative tiles too for the rest
+		if (nTiles > 0)
+		{
+			bHit = rayCaster2D.RayCastVsTileGrid(ray.vecStart, ray.vecEnd, scene.vTiles.data(), { nTiles, nTiles }, { scene.fTileSize, scene.fTileSize }, vecHit, fDistance, vecTile, vecNormal);
+			ref = ReferenceTileGrid(ray.vecStart, ray.vecEnd, isMapSolid, scene.fTileSize);
+		}
+		else
+		{
+			bHit = rayCaster2D.RayCastVsTileGrid(ray.vecStart, ray.vecEnd, isProceduralSolid, { scene.fTileSize, scene.fTileSize }, vecHit, fDistance, vecTile, vecNormal);
+			ref = ReferenceTileGrid(ray.vecStart, ray.vecEnd, isProceduralSolid, scene.fTileSize);
+		}
+
+		stats.nTests++;
+		bool bOk;
+		if (ref.bBorderline)
+		{
+			// Only a miss if there is no tile that must be hit, otherwise a solid tile the ray touches, entered at
+			// a grid line and no further than the reference hit
+			const bool bSolid = nTiles > 0 ? isMapSolid(vecTile.x, vecTile.y) : isProceduralSolid(vecTile.x, vecTile.y);
+			bool bAtCrossing = std::fabs((long double)fDistance) <= fEpsilon;
+			for (const auto& c : ref.vCrossings)
+				bAtCrossing |= std::fabs((long double)fDistance - c.first) <= c.second;
+
+			const vld2d vecDistance = (ToLD(ray.vecEnd) - ToLD(ray.vecStart)) / (long double)scene.fTileSize;
+			const vld2d vecPoint = ToLD(ray.vecStart) / (long double)scene.fTileSize + vecDistance * (long double)fDistance;
+			const vld2d vecCorner = { (long double)vecTile.x, (long double)vecTile.y };
+			const bool bTouches = BoxSurface(vecPoint, vecCorner, vecCorner + vld2d{ 1.0L, 1.0L }) <= fEpsilon * (vecDistance.mag() + 1.0L);
+
+			if (!bHit)
+				bOk = !ref.bHit || ref.t >= 1.0L - ref.fTolerance;
+			else
+				bOk = bSolid && bAtCrossing && bTouches && (!ref.bHit || (long double)fDistance <= ref.t + ref.fTolerance);
+		}
+		else
+			bOk = bHit == ref.bHit && (!bHit || (std::fabs((long double)fDistance - ref.t) <= ref.fTolerance && vecTile == ref.vecTile && vecNormal == ref.vecNormal));
+
+		if (bOk)
+		{
+			if (ref.bBorderline)
+				stats.nBorderline++;
+			continue;
+		}
+
+		stats.nMismatches++;
+		if (nReported++ < 10)
+			printf("  MISMATCH %-22s (%s) ray (%g, %g) -> (%g, %g) : got %s tile (%d, %d) t %.7f, reference %s tile (%d, %d) t %.7Lf\n",
+				stats.sName.c_str(), scene.sKind.c_str(), ray.vecStart.x, ray.vecStart.y, ray.vecEnd.x, ray.vecEnd.y,
+				bHit ? "hit" : "miss", vecTile.x, vecTile.y, fDistance, ref.bHit ? "hit" : "miss", ref.vecTile.x, ref.vecTile.y, ref.t);
+	}
+}
+
+// The closed form shape tests are checked against long double versions of the same tests.  Each one is run
+// again with the shape grown and shrunk and the ray moved by a little more than float rounding.  If the
+// nudged runs disagree about hitting the case is borderline (grazing a circle, clipping a corner, touching at
+// the very end of the ray), otherwise the spread of their t values sets the tolerance
+struct sShapeResult
+{
+	bool bHit = false;
+	bool bBorderline = false;									// Ambiguous in a way nudging cannot show
+	long double t = 0.0L;
+};
+
+struct sShapeReference
+{
+	bool bHit = false;
+	bool bBorderline = false;
+	long double t = 0.0L;
+	long double fTolerance = fEpsilon;
+};
+
+template<typename RefFunc>
+sShapeReference NudgedReference(RefFunc&& refFunc, const long double fNudge)
+{
+	// Grow the shape by, move the ray by
+	const long double fNudges[7][3] =
+	{
+		{ 0.0L, 0.0L, 0.0L },
+		{ fNudge, 0.0L, 0.0L }, { -fNudge, 0.0L, 0.0L },
+		{ 0.0L, fNudge, 0.0L }, { 0.0L, -fNudge, 0.0L },
+		{ 0.0L, 0.0L, fNudge }, { 0.0L, 0.0L, -fNudge }
+	};
+
+	sShapeReference ref;
+	long double fSpread = 0.0L;
+	for (int n = 0; n < 7; n++)
+	{
+		const sShapeResult result = refFunc(fNudges[n][0], vld2d{ fNudges[n][1], fNudges[n][2] });
+		if (n == 0)
+		{
+			ref.bHit = result.bHit;
+			ref.t = result.t;
+		}
+
+		ref.bBorderline |= result.bHit != ref.bHit || result.bBorderline;
+		if (result.bHit && ref.bHit)
+			fSpread = std::max(fSpread, std::fabs(result.t - ref.t));
+	}
+
+	ref.fTolerance = fEpsilon + 2.0L * fSpread;
+	return ref;
+}
+
+// Rays starting inside (or on) a circle never hit it, swept tests that start overlapping hit at t = 0 if moving inwards
+sShapeResult ReferenceRayVsCircle(const vld2d vecStart, const vld2d vecDistance, const vld2d vecCenter, const long double fRadius, const bool bSwept)
+{
+	sShapeResult result;
+	const vld2d vecOffset = vecStart - vecCenter;
+	const long double a = vecDistance.dot(vecDistance);
+	const long double b = vecOffset.dot(vecDistance);
+	const long double c = vecOffset.dot(vecOffset) - fRadius * fRadius;
+	if (a == 0.0L || b * b - a * c < 0.0L)
+		return result;
+
+	result.t = (-b - std::sqrt(b * b - a * c)) / a;
+	if (c <= 0.0L)
+	{
+		if (!bSwept || b >= 0.0L)
+			return result;
+
+		result.t = 0.0L;
+	}
+
+	result.bHit = (bSwept ? result.t >= 0.0L : result.t > 0.0L) && result.t < 1.0L;
+	return result;
+}
+
+// Slab test, the box edges count as inside.  Swept tests that start overlapping hit at t = 0 if moving towards the middle
+sShapeResult ReferenceRayVsBox(const vld2d vecStart, const vld2d vecDistance, const vld2d vecMin, const vld2d vecMax, const bool bSwept)
+{
+	sShapeResult result;
+	const long double fStart[2] = { vecStart.x, vecStart.y };
+	const long double fDistance[2] = { vecDistance.x, vecDistance.y };
+	const long double fMin[2] = { vecMin.x, vecMin.y };
+	const long double fMax[2] = { vecMax.x, vecMax.y };
+
+	long double tEnter = -std::numeric_limits<long double>::infinity();
+	long double tExit = std::numeric_limits<long double>::infinity();
+	for (int a = 0; a < 2; a++)
+	{
+		if (fDistance[a] == 0.0L)
+		{
+			if (fStart[a] < fMin[a] || fStart[a] > fMax[a])
+				return result;
+			continue;
+		}
+
+		const long double t0 = (fMin[a] - fStart[a]) / fDistance[a];
+		const long double t1 = (fMax[a] - fStart[a]) / fDistance[a];
+		tEnter = std::max(tEnter, std::min(t0, t1));
+		tExit = std::min(tExit, std::max(t0, t1));
+	}
+
+	if (tEnter > tExit || tExit <= 0.0L || tEnter == -std::numeric_limits<long double>::infinity())
+		return result;
+
+	if (tEnter < 0.0L)
+	{
+		if (!bSwept || vecDistance.dot((vecMin + vecMax) * 0.5L - vecStart) <= 0.0L)
+			return result;
+
+		tEnter = 0.0L;
+	}
+
+	result.t = tEnter;
+	result.bHit = (bSwept ? tEnter >= 0.0L : tEnter > 0.0L) && tEnter < 1.0L;
+	return result;
+}
+
+// Rays starting inside (or on) the polygon never hit it, otherwise the first side crossed is the hit
+sShapeResult ReferenceRayVsPolygon(const vld2d vecStart, const vld2d vecDistance, const std::vector<vld2d>& vPoints)
+{
+	sShapeResult result;
+	result.t = 2.0L;
+
+	const long double fWinding = (vPoints[1] - vPoints[0]).cross(vPoints[2] - vPoints[1]) < 0.0L ? -1.0L : 1.0L;
+	bool bInside = true;
+	for (size_t i = 0; i < vPoints.size(); i++)
+	{
+		const vld2d vecA = vPoints[i];
+		const vld2d vecSide = vPoints[(i + 1) % vPoints.size()] - vecA;
+		bInside &= vecSide.cross(vecStart - vecA) * fWinding >= 0.0L;
+
+		const long double fDenom = vecDistance.cross(vecSide);
+		if (fDenom == 0.0L)
+			continue;
+
+		const long double t = (vecA - vecStart).cross(vecSide) / fDenom;
+		const long double u = (vecStart - vecA).cross(vecDistance) / -fDenom;
+		if (t > 0.0L && t < 1.0L && u >= 0.0L && u <= 1.0L)
+			result.t = std::min(result.t, t);
+	}
+
+	result.bHit = !bInside && result.t < 1.0L;
+	return result;
+}
+
+// A circle moving into an edge is a ray against the edge grown into a capsule
+sShapeResult ReferenceSweptCircleVsEdge(const vld2d vecPos, const vld2d vecVelocity, const long double fRadius, const vld2d vecEdgeStart, const vld2d vecEdgeEnd)
+{
+	sShapeResult result;
+	const vld2d vecEdge = vecEdgeEnd - vecEdgeStart;
+	const long double fLength2 = vecEdge.dot(vecEdge);
+
+	// Already touching is a hit at t = 0 when moving towards the edge.  Otherwise it is the first time the circle
+	// meets the capsule, which can still be ahead when touching (sliding along the edge into its far end)
+	const long double fNearest = fLength2 > 0.0L ? std::min(std::max((vecPos - vecEdgeStart).dot(vecEdge) / fLength2, 0.0L), 1.0L) : 0.0L;
+	const vld2d vecToEdge = vecEdgeStart + vecEdge * fNearest - vecPos;
+
+	// Touching (or overlapping) while sliding along the edge, whether it counts as moving towards it is down to rounding
+	result.bBorderline = vecToEdge.mag() <= fRadius * (1.0L + 1e-4L) && std::fabs(vecToEdge.dot(vecVelocity)) <= 1e-4L * vecToEdge.mag() * vecVelocity.mag();
+	if (vecToEdge.dot(vecToEdge) <= fRadius * fRadius && vecToEdge.dot(vecVelocity) > 0.0L)
+	{
+		result.bHit = true;
+		result.t = 0.0L;
+		return result;
+	}
+
+	result.t = 2.0L;
+	if (fLength2 > 0.0L)
+	{
+		for (const long double fSide : { -1.0L, 1.0L })
+		{
+			const vld2d vecSide = vld2d{ -vecEdge.y, vecEdge.x } * (fSide / std::sqrt(fLength2));
+			const long double fDenom = vecVelocity.dot(vecSide);
+			if (fDenom >= 0.0L)
+				continue;
+
+			const vld2d vecOffsetStart = vecEdgeStart + vecSide * fRadius;
+			const long double t = (vecOffsetStart - vecPos).dot(vecSide) / fDenom;
+			const long double fAlong = (vecPos + vecVelocity * t - vecOffsetStart).dot(vecEdge) / fLength2;
+			if (t >= 0.0L && t <= 1.0L && fAlong >= 0.0L && fAlong <= 1.0L)
+				result.t = std::min(result.t, t);
+		}
+	}
+
+	for (const vld2d& vecEnd : { vecEdgeStart, vecEdgeEnd })
+	{
+		const sShapeResult end = ReferenceRayVsCircle(vecPos, vecVelocity, vecEnd, fRadius, true);
+		if (end.bHit)
+			result.t = std::min(result.t, end.t);
+	}
+
+	result.bHit = result.t <= 1.0L;
+	return result;
+}
+
+// surface() gives the distance of a point from the surface of the shape (negative inside)
+template<typename SurfaceFunc>
+void CheckShape(sPathStats& stats, const sShapeReference& ref, const bool bHit, const float fDistance, const olc::vf2d vecNormal, SurfaceFunc&& surface, const long double fSurfaceTolerance, const sRay& ray, int& nReported, const sScene& scene)
+{
+	stats.nTests++;
+
+	bool bOk;
+	if (ref.bBorderline)
+	{
+		// Either way will do, but a hit must be the reference one or on the surface (or inside, for a swept test
+		// already touching at the start)
+		const long double fSurface = surface(ToLD(ray.vecStart) + (ToLD(ray.vecEnd) - ToLD(ray.vecStart)) * (long double)fDistance);
+		bOk = !bHit || (ref.bHit && std::fabs((long double)fDistance - ref.t) <= ref.fTolerance)
+			|| std::fabs(fSurface) <= fSurfaceTolerance || (fDistance == 0.0f && fSurface <= 0.0L);
+	}
+	else
+		bOk = bHit == ref.bHit && (!bHit || std::fabs((long double)fDistance - ref.t) <= ref.fTolerance);
+
+	// The normal must be unit length and face back along the ray
+	const olc::vf2d vecDirection = ray.vecEnd - ray.vecStart;
+	if (bOk && bHit)
+		bOk = std::fabs(vecNormal.mag() - 1.0f) <= 1e-3f && vecNormal.dot(vecDirection) <= 1e-4f * vecDirection.mag();
+
+	if (bOk)
+	{
+		if (ref.bBorderline)
+			stats.nBorderline++;
+		return;
+	}
+
+	stats.nMismatches++;
+	if (nReported++ < 10)
+		printf("  MISMATCH %-22s (%s) ray (%g, %g) -> (%g, %g) : got %s t %.7f normal (%g, %g), reference %s t %.7Lf\n",
+			stats.sName.c_str(), scene.sKind.c_str(), ray.vecStart.x, ray.vecStart.y, ray.vecEnd.x, ray.vecEnd.y,
+			bHit ? "hit" : "miss", fDistance, vecNormal.x, vecNormal.y, ref.bHit ? "hit" : "miss", ref.t);
+}
+
+void CheckShapes(std::mt19937& rng, olcPGEX_RayCast2D& rayCaster2D, const sScene& scene, sPathStats* stats, int& nReported)
+{
+	std::uniform_real_distribution<float> distUnit(0.0f, 1.0f);
+	const float fTwoPi = 6.2831853f;
+	const float fWorld = scene.fWorld;
+
+	// A little more than float rounding at the size of the world
+	const long double fNudge = 2e-5L * fWorld;
+	const long double fSurfaceTolerance = 4.0L * fNudge;
+
+	auto randomPoint = [&]() { return olc::vf2d{ distUnit(rng), distUnit(rng) } * fWorld; };
+	auto randomSize = [&](const float fMin, const float fMax) { return (fMin + (fMax - fMin) * distUnit(rng)) * fWorld; };
+
+	const olc::vf2d vecCircle = randomPoint();
+	const float fRadius = randomSize(0.01f, 0.2f);
+
+	const olc::vf2d vecRectPos = randomPoint();
+	const olc::vf2d vecRectSize = { randomSize(0.01f, 0.3f), randomSize(0.01f, 0.3f) };
+
+	const olc::vf2d vecBoxCenter = randomPoint();
+	const olc::vf2d vecHalfSize = { randomSize(0.005f, 0.15f), randomSize(0.005f, 0.15f) };
+	const float fBoxAngle = distUnit(rng) * fTwoPi;
+
+	// Points on a circle are always convex, spaced out so the first three are never close to a line
+	const olc::vf2d vecPolyCenter = randomPoint();
+	const float fPolyRadius = randomSize(0.02f, 0.2f);
+	const int nPolyPoints = 3 + rng() % 6;
+	const float fPolyAngle = distUnit(rng) * fTwoPi;
+	const bool bClockwise = rng() % 2 == 0;
+	std::vector<olc::vf2d> vPolyPoints;
+	for (int i = 0; i < nPolyPoints; i++)
+	{
+		const float fAngle = fPolyAngle + (bClockwise ? -1.0f : 1.0f) * ((float)i + (distUnit(rng) - 0.5f) * 0.5f) * fTwoPi / (float)nPolyPoints;
+		vPolyPoints.push_back(vecPolyCenter + olc::vf2d{ std::cos(fAngle), std::sin(fAngle) } * fPolyRadius);
+	}
+
+	const olc::vf2d vecMoverSize = { randomSize(0.005f, 0.1f), randomSize(0.005f, 0.1f) };
+	const float fMoverRadius = randomSize(0.005f, 0.1f);
+	const size_t nEdge = rng() % scene.edges.Size();
+	const olc::vf2d vecEdgeStart = EdgeStart(scene.edges, nEdge);
+	const olc::vf2d vecEdgeEnd = EdgeEnd(scene.edges, nEdge);
+
+	// Aim extra rays straight at the awkward parts: corners, vertices, the sides of the circles and the edge ends
+	std::vector<olc::vf2d> vTargets =
+	{
+		vecCircle, vecCircle + olc::vf2d{ fRadius, 0.0f }, vecCircle - olc::vf2d{ 0.0f, fRadius + fMoverRadius },
+		vecRectPos, vecRectPos + vecRectSize, vecRectPos + olc::vf2d{ vecRectSize.x, 0.0f }, vecRectPos - vecMoverSize,
+		vecBoxCenter + olc::vf2d{ std::cos(fBoxAngle), std::sin(fBoxAngle) } * vecHalfSize.x,
+		vecEdgeStart, vecEdgeEnd, vecEdgeStart + (vecEdgeEnd - vecEdgeStart).perp().norm() * fMoverRadius
+	};
+	vTargets.insert(vTargets.end(), vPolyPoints.begin(), vPolyPoints.end());
+
+	std::vector<sRay> vRays = scene.rays;
+	for (int i = 0; i < 32; i++)
+	{
+		const olc::vf2d vecStart = randomPoint();
+		const olc::vf2d vecTarget = vTargets[rng() % vTargets.size()];
+		vRays.push_back({ vecStart, vecStart + (vecTarget - vecStart) * ((rng() % 2) ? 1.0f : 0.5f + 1.5f * distUnit(rng)) });
+	}
+
+	// The long double shapes, and which way to grow the polygon's points
+	std::vector<vld2d> vPolyLD, vPolyOut;
+	for (const olc::vf2d& vecPoint : vPolyPoints)
+	{
+		vPolyLD.push_back(ToLD(vecPoint));
+		vPolyOut.push_back((ToLD(vecPoint) - ToLD(vecPolyCenter)).norm());
+	}
+
+	const long double fCos = std::cos((long double)fBoxAngle);
+	const long double fSin = std::sin((long double)fBoxAngle);
+	auto toBox = [&](const vld2d v) { return vld2d{ v.x * fCos + v.y * fSin, -v.x * fSin + v.y * fCos }; };
+
+	for (const sRay& ray : vRays)
+	{
+		const vld2d vecStart = ToLD(ray.vecStart);
+		const vld2d vecEnd = ToLD(ray.vecEnd);
+		olc::vf2d vecHit, vecNormal;
+		float fDistance = 0.0f;
+		bool bHit;
+
+		bHit = rayCaster2D.RayCastVsCircle(ray.vecStart, ray.vecEnd, vecCircle, fRadius, vecHit, fDistance, vecNormal);
+		CheckShape(stats[CIRCLE], NudgedReference([&](const long double fGrow, const vld2d vecNudge)
+		{
+			return ReferenceRayVsCircle(vecStart + vecNudge, vecEnd - vecStart, ToLD(vecCircle), fRadius + fGrow, false);
+		}, fNudge), bHit, fDistance, vecNormal, [&](const vld2d vecPoint) { return (vecPoint - ToLD(vecCircle)).mag() - fRadius; }, fSurfaceTolerance, ray, nReported, scene);
+
+		bHit = rayCaster2D.RayCastVsAABB(ray.vecStart, ray.vecEnd, vecRectPos, vecRectSize, vecHit, fDistance, vecNormal);
+		CheckShape(stats[AABB], NudgedReference([&](const long double fGrow, const vld2d vecNudge)
+		{
+			return ReferenceRayVsBox(vecStart + vecNudge, vecEnd - vecStart, ToLD(vecRectPos) - vld2d{ fGrow, fGrow }, ToLD(vecRectPos + vecRectSize) + vld2d{ fGrow, fGrow }, false);
+		}, fNudge), bHit, fDistance, vecNormal, [&](const vld2d vecPoint) { return BoxSurface(vecPoint, ToLD(vecRectPos), ToLD(vecRectPos + vecRectSize)); }, fSurfaceTolerance, ray, nReported, scene);
+
+		bHit = rayCaster2D.RayCastVsOBB(ray.vecStart, ray.vecEnd, vecBoxCenter, vecHalfSize, fBoxAngle, vecHit, fDistance, vecNormal);
+		CheckShape(stats[OBB], NudgedReference([&](const long double fGrow, const vld2d vecNudge)
+		{
+			const vld2d vecHalf = ToLD(vecHalfSize) + vld2d{ fGrow, fGrow };
+			return ReferenceRayVsBox(toBox(vecStart + vecNudge - ToLD(vecBoxCenter)), toBox(vecEnd - vecStart), vld2d{ 0.0L, 0.0L } - vecHalf, vecHalf, false);
+		}, fNudge), bHit, fDistance, vecNormal, [&](const vld2d vecPoint) { return BoxSurface(toBox(vecPoint - ToLD(vecBoxCenter)), vld2d{ 0.0L, 0.0L } - ToLD(vecHalfSize), ToLD(vecHalfSize)); }, fSurfaceTolerance, ray, nReported, scene);
+
+		bHit = rayCaster2D.RayCastVsConvexPolygon(ray.vecStart, ray.vecEnd, vPolyPoints, vecHit, fDistance, vecNormal);
+		CheckShape(stats[POLYGON], NudgedReference([&](const long double fGrow, const vld2d vecNudge)
+		{
+			std::vector<vld2d> vGrown = vPolyLD;
+			for (size_t i = 0; i < vGrown.size(); i++)
+				vGrown[i] += vPolyOut[i] * fGrow;
+			return ReferenceRayVsPolygon(vecStart + vecNudge, vecEnd - vecStart, vGrown);
+		}, fNudge), bHit, fDistance, vecNormal, [&](const vld2d vecPoint) { return PolygonSurface(vecPoint, vPolyLD); }, fSurfaceTolerance, ray, nReported, scene);
+
+		// The swept tests move from the ray start to the ray end
+		bHit = rayCaster2D.SweptAABBVsAABB(ray.vecStart, vecMoverSize, ray.vecEnd - ray.vecStart, vecRectPos, vecRectSize, vecHit, fDistance, vecNormal);
+		CheckShape(stats[SWEPT_AABB], NudgedReference([&](const long double fGrow, const vld2d vecNudge)
+		{
+			return ReferenceRayVsBox(vecStart + vecNudge, vecEnd - vecStart, ToLD(vecRectPos - vecMoverSize) - vld2d{ fGrow, fGrow }, ToLD(vecRectPos + vecRectSize) + vld2d{ fGrow, fGrow }, true);
+		}, fNudge), bHit, fDistance, vecNormal, [&](const vld2d vecPoint) { return BoxSurface(vecPoint, ToLD(vecRectPos - vecMoverSize), ToLD(vecRectPos + vecRectSize)); }, fSurfaceTolerance, ray, nReported, scene);
+
+		bHit = rayCaster2D.SweptCircleVsCircle(ray.vecStart, fMoverRadius, ray.vecEnd - ray.vecStart, vecCircle, fRadius, vecHit, fDistance, vecNormal);
+		CheckShape(stats[SWEPT_CIRCLE], NudgedReference([&](const long double fGrow, const vld2d vecNudge)
+		{
+			return ReferenceRayVsCircle(vecStart + vecNudge, vecEnd - vecStart, ToLD(vecCircle), (long double)fRadius + fMoverRadius + fGrow, true);
+		}, fNudge), bHit, fDistance, vecNormal, [&](const vld2d vecPoint) { return (vecPoint - ToLD(vecCircle)).mag() - fRadius - fMoverRadius; }, fSurfaceTolerance, ray, nReported, scene);
+
+		bHit = rayCaster2D.SweptCircleVsEdge(ray.vecStart, fMoverRadius, ray.vecEnd - ray.vecStart, vecEdgeStart, vecEdgeEnd, vecHit, fDistance, vecNormal);
+		CheckShape(stats[SWEPT_EDGE], NudgedReference([&](const long double fGrow, const vld2d vecNudge)
+		{
+			return ReferenceSweptCircleVsEdge(vecStart + vecNudge, vecEnd - vecStart, fMoverRadius + fGrow, ToLD(vecEdgeStart), ToLD(vecEdgeEnd));
+		}, fNudge), bHit, fDistance, vecNormal, [&](const vld2d vecPoint) { return DistanceToSegment(vecPoint, ToLD(vecEdgeStart), ToLD(vecEdgeEnd)) - fMoverRadius; }, fSurfaceTolerance, ray, nReported, scene);
+	}
+}
+
+// Every ray of the fan is checked against the reference, then random points are checked with Contains.  Between
+// two rays of the fan the polygon is a straight line while the real view may not be (edges crossing, the rounded
+// off radius), so only points on the same side of both that line and the real view must agree
+void CheckVisibility(std::mt19937& rng, olcPGEX_RayCast2D& rayCaster2D, const sScene& scene, sPathStats* stats, int& nReported)
+{
+	std::uniform_real_distribution<float> distUnit(0.0f, 1.0f);
+	const float fTwoPi = 6.2831853f;
+	const long double fTwoPiLD = 6.283185307179586476925L;
+	const auto& edges = scene.edges;
+	std::vector<sReference> vRefs(edges.Size());
+	olcPGEX_RayCast2D::sVisibilityPolygon poly;
+
+	for (int nOrigin = 0; nOrigin < 2; nOrigin++)
+	{
+		const olc::vf2d vecOrigin = olc::vf2d{ distUnit(rng), distUnit(rng) } * scene.fWorld;
+		const float fRadius = (rng() % 2) ? 0.0f : (0.1f + 0.5f * distUnit(rng)) * scene.fWorld;
+		const float fAngleStart = (distUnit(rng) - 0.5f) * fTwoPi;
+		const float fAngleRange = (rng() % 2) ? fTwoPi : 0.3f + 5.7f * distUnit(rng);
+		rayCaster2D.CalculateVisibilityPolygon(vecOrigin, edges, poly, fRadius, fAngleStart, fAngleRange);
+
+		// The closest sure hit from the origin towards vecEnd (1 if nothing is hit), and whether any borderline edge could change it
+		long double fClosest = 1.0L;
+		long double fClosestTolerance = fEpsilon;
+		auto traceReference = [&](const olc::vf2d vecEnd)
+		{
+			bool bAnyBorderline = false;
+			fClosest = 1.0L;
+			fClosestTolerance = fEpsilon;
+			for (size_t i = 0; i < edges.Size(); i++)
+			{
+				vRefs[i] = ReferenceIntersect(vecOrigin, vecEnd, EdgeStart(edges, i), EdgeEnd(edges, i));
+				bAnyBorderline |= vRefs[i].bBorderline;
+				if (vRefs[i].bHit && !vRefs[i].bBorderline && vRefs[i].t1 < fClosest)
+				{
+					fClosest = vRefs[i].t1;
+					fClosestTolerance = vRefs[i].fTolerance;
+				}
+			}
+			return bAnyBorderline;
+		};
+
+		// The fan, vPoints[i + 1] is the ray cast at vAngles[i]
+		for (size_t i = 0; i < poly.vAngles.size(); i++)
+		{
+			const float fAngle = poly.fAngleStart + poly.vAngles[i];
+			const olc::vf2d vecEnd = vecOrigin + olc::vf2d{ std::cos(fAngle), std::sin(fAngle) } * poly.fRadius;
+			const bool bAnyBorderline = traceReference(vecEnd);
+
+			const vld2d vecRay = ToLD(vecEnd) - ToLD(vecOrigin);
+			const vld2d vecPoint = ToLD(poly.vPoints[i + 1]);
+			const long double t = (vecPoint - ToLD(vecOrigin)).dot(vecRay) / vecRay.dot(vecRay);
+			const bool bOnRay = std::fabs(vecRay.cross(vecPoint - ToLD(vecOrigin))) <= fEpsilon * vecRay.dot(vecRay);
+
+			bool bOk;
+			if (!bAnyBorderline)
+				bOk = std::fabs(t - fClosest) <= fClosestTolerance;
+			else
+			{
+				// Nothing hit, or a hit on one of the edges, but never beyond a sure hit
+				bOk = std::fabs(t - 1.0L) <= fEpsilon;
+				for (size_t e = 0; e < edges.Size() && !bOk; e++)
+					bOk = HitMatchesEdge(vRefs[e], t, vecPoint, ToLD(EdgeStart(edges, e)), ToLD(EdgeEnd(edges, e)), vecRay.mag());
+				bOk &= t <= fClosest + fClosestTolerance;
+			}
+			bOk &= bOnRay;
+
+			stats[VIS_FAN].nTests++;
+			if (bOk)
+			{
+				if (bAnyBorderline)
+					stats[VIS_FAN].nBorderline++;
+				continue;
+			}
+
+			stats[VIS_FAN].nMismatches++;
+			if (nReported++ < 10)
+				printf("  MISMATCH %-22s (%s) origin (%g, %g) angle %.7f : got (%g, %g) t %.7Lf, reference closest t %.7Lf\n",
+					stats[VIS_FAN].sName.c_str(), scene.sKind.c_str(), vecOrigin.x, vecOrigin.y, fAngle,
+					poly.vPoints[i + 1].x, poly.vPoints[i + 1].y, t, fClosest);
+		}
+
+		// Random points around the origin, some beyond the radius
+		for (int n = 0; n < 32; n++)
+		{
+			const float fPointAngle = distUnit(rng) * fTwoPi;
+			const olc::vf2d vecPoint = vecOrigin + olc::vf2d{ std::cos(fPointAngle), std::sin(fPointAngle) } * (poly.fRadius * 1.2f * distUnit(rng));
+			const bool bContains = poly.Contains(vecPoint);
+
+			const vld2d vecToPoint = ToLD(vecPoint) - ToLD(vecOrigin);
+			const long double fPointDistance = vecToPoint.mag();
+			const long double fBand = fEpsilon * poly.fRadius;
+
+			long double fRelative = std::fmod(std::atan2(vecToPoint.y, vecToPoint.x) - (long double)poly.fAngleStart, fTwoPiLD);
+			if (fRelative < 0.0L) fRelative += fTwoPiLD;
+
+			// 1 inside, 0 outside, -1 either
+			int nExpected = -1;
+			const bool bNearLimit = fRelative <= fEpsilon || fTwoPiLD - fRelative <= fEpsilon || (!poly.bFullCircle && std::fabs(fRelative - fAngleRange) <= fEpsilon);
+			if (fPointDistance <= fBand || bNearLimit)
+				nExpected = -1;
+			else if (!poly.bFullCircle && fRelative > fAngleRange)
+				nExpected = 0;
+			else
+			{
+				if (poly.bFullCircle && fRelative < poly.vAngles.front())
+					fRelative += fTwoPiLD;
+
+				// The triangle of the fan covering this angle, and where its outer line crosses the way to the point
+				size_t nUpper = 0;
+				while (nUpper < poly.vAngles.size() && poly.vAngles[nUpper] <= fRelative)
+					nUpper++;
+
+				const bool bNearRay = (nUpper > 0 && fRelative - poly.vAngles[nUpper - 1] <= 1e-5L) || (nUpper < poly.vAngles.size() && poly.vAngles[nUpper] - fRelative <= 1e-5L);
+				if (nUpper > 0 && nUpper < poly.vAngles.size() && !bNearRay)
+				{
+					const vld2d vecDirection = vecToPoint / fPointDistance;
+					const vld2d vecA = ToLD(poly.vPoints[nUpper]);
+					const vld2d vecSide = ToLD(poly.vPoints[nUpper + 1]) - vecA;
+					const long double fDenom = vecDirection.cross(vecSide);
+					const long double fLine = fDenom != 0.0L ? (vecA - ToLD(vecOrigin)).cross(vecSide) / fDenom : -1.0L;
+
+					const bool bAnyBorderline = traceReference(vecOrigin + olc::vf2d{ (float)vecDirection.x, (float)vecDirection.y } * poly.fRadius);
+					const long double fView = fClosest * poly.fRadius;
+
+					if (!bAnyBorderline && fLine > 0.0L)
+					{
+						const long double fBandView = fClosestTolerance * poly.fRadius;
+						if (fPointDistance < std::min(fLine - fBand, fView - fBandView))
+							nExpected = 1;
+						else if (fPointDistance > std::max(fLine + fBand, fView + fBandView))
+							nExpected = 0;
+					}
+				}
+			}
+
+			stats[VIS_CONTAINS].nTests++;
+			if (nExpected == -1)
+			{
+				stats[VIS_CONTAINS].nBorderline++;
+				continue;
+			}
+
+			if (bContains == (nExpected == 1))
+				continue;
+
+			stats[VIS_CONTAINS].nMismatches++;
+			if (nReported++ < 10)
+				printf("  MISMATCH %-22s (%s) origin (%g, %g) point (%g, %g) : got %s, reference %s\n",
+					stats[VIS_CONTAINS].sName.c_str(), scene.sKind.c_str(), vecOrigin.x, vecOrigin.y, vecPoint.x, vecPoint.y,
+					bContains ? "inside" : "outside", nExpected == 1 ? "inside" : "outside");
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const int nIterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+	const unsigned int nSeed = argc > 2 ? (unsigned int)std::atoi(argv[2]) : 2020;
+
+	olcPGEX_RayCast2D rayCaster2D;
+	olcPGEX_ThreadPool threadPool;
+	std::mt19937 rng(nSeed);
+
+	sPathStats stats[PATH_COUNT];
+	stats[SINGLE].sName = "RayCastVsEdge";
+	stats[SET].sName = "RayCastVsEdgeSet";
+	stats[GRID].sName = "RayCastVsEdgeGrid";
+	stats[BATCH_SET].sName = "RayCastBatch (set)";
+	stats[BATCH_GRID].sName = "RayCastBatch (grid)";
+	stats[DYNAMIC].sName = "RayCastVsDynamicEdges";
+	stats[TIERS].sName = "RayCastVsEdgeTiers";
+	stats[TILE_GRID].sName = "RayCastVsTileGrid";
+	stats[CIRCLE].sName = "RayCastVsCircle";
+	stats[AABB].sName = "RayCastVsAABB";
+	stats[OBB].sName = "RayCastVsOBB";
+	stats[POLYGON].sName = "RayCastVsConvexPolygon";
+	stats[SWEPT_AABB].sName = "SweptAABBVsAABB";
+	stats[SWEPT_CIRCLE].sName = "SweptCircleVsCircle";
+	stats[SWEPT_EDGE].sName = "SweptCircleVsEdge";
+	stats[VIS_FAN].sName = "Visibility (fan)";
+	stats[VIS_CONTAINS].sName = "Visibility (Contains)";
+
+	int nReported = 0;
+	sScene scene;
+	std::vector<sReference> vRefs;
+
+	for (int it = 0; it < nIterations; it++)
+	{
+		BuildScene(rng, rayCaster2D, scene);
+		const auto& edges = scene.edges;
+		const size_t nEdges = edges.Size();
+
+		olcPGEX_RayCast2D::sEdgeGrid grid;
+		rayCaster2D.BuildEdgeGrid(edges, grid);
+
+		// Fresh dynamic sets hand out IDs in order, so ID == edge index.  Every edge is moved
+		// away and back again first so the incremental grid updates are exercised too
+		olc::vf2d vecMin = EdgeStart(edges, 0), vecMax = vecMin;
+		for (size_t i = 0; i < nEdges; i++)
+		{
+			vecMin = vecMin.min(EdgeStart(edges, i)).min(EdgeEnd(edges, i));
+			vecMax = vecMax.max(EdgeStart(edges, i)).max(EdgeEnd(edges, i));
+		}
+
+		olcPGEX_RayCast2D::sDynamicEdgeSet dynamicEdges;
+		dynamicEdges.Init(vecMin, (vecMax - vecMin) * 0.9f, std::max(vecMax.x - vecMin.x, vecMax.y - vecMin.y) / 8.0f + 1e-3f);
+		for (size_t i = 0; i < nEdges; i++)
+			dynamicEdges.AddEdge(EdgeStart(edges, i) + olc::vf2d{ 13.0f, 7.0f }, EdgeEnd(edges, i));
+		for (size_t i = 0; i < nEdges; i++)
+			dynamicEdges.MoveEdge((int)i, EdgeStart(edges, i), EdgeEnd(edges, i));
+
+		// Tiers - first half static, second half dynamic (dynamic ID + nHalf == edge index)
+		const size_t nHalf = nEdges / 2;
+		olcPGEX_RayCast2D::sEdgeSet staticEdges;
+		olcPGEX_RayCast2D::sDynamicEdgeSet tierEdges;
+		tierEdges.Init(vecMin, vecMax - vecMin, std::max(vecMax.x - vecMin.x, vecMax.y - vecMin.y) / 4.0f + 1e-3f);
+		for (size_t i = 0; i < nEdges; i++)
+		{
+			if (i < nHalf)
+				staticEdges.AddEdge(EdgeStart(edges, i), EdgeEnd(edges, i));
+			else
+				tierEdges.AddEdge(EdgeStart(edges, i), EdgeEnd(edges, i));
+		}
+		olcPGEX_RayCast2D::sEdgeGrid staticGrid;
+		rayCaster2D.BuildEdgeGrid(staticEdges, staticGrid);
+
+		std::vector<sRayHit> vBatchSet, vBatchGrid;
+		rayCaster2D.RayCastBatch(scene.rays, edges, vBatchSet, &threadPool);
+		rayCaster2D.RayCastBatch(scene.rays, grid, vBatchGrid, &threadPool);
+
+		for (size_t r = 0; r < scene.rays.size(); r++)
+		{
+			const sRay& ray = scene.rays[r];
+
+			vRefs.resize(nEdges);
+			for (size_t i = 0; i < nEdges; i++)
+				vRefs[i] = ReferenceIntersect(ray.vecStart, ray.vecEnd, EdgeStart(edges, i), EdgeEnd(edges, i));
+
+			// Single edge API, every edge on its own
+			for (size_t i = 0; i < nEdges; i++)
+			{
+				olc::vf2d vecHit;
+				float fDistance = 0.0f;
+				const bool bHit = rayCaster2D.RayCastVsEdge(ray.vecStart, ray.vecEnd, EdgeStart(edges, i), EdgeEnd(edges, i), vecHit, fDistance);
+
+				stats[SINGLE].nTests++;
+				if (vRefs[i].bBorderline)
+				{
+					stats[SINGLE].nBorderline++;
+					continue;
+				}
+
+				if (bHit != vRefs[i].bHit || (bHit && std::fabs((long double)fDistance - vRefs[i].t1) > vRefs[i].fTolerance))
+				{
+					stats[SINGLE].nMismatches++;
+					if (nReported++ < 10)
+						printf("  MISMATCH %-22s (%s) ray (%g, %g) -> (%g, %g) edge (%g, %g) -> (%g, %g) : got %s t %.7f, reference %s t %.7Lf\n",
+							stats[SINGLE].sName.c_str(), scene.sKind.c_str(), ray.vecStart.x, ray.vecStart.y, ray.vecEnd.x, ray.vecEnd.y,
+							EdgeStart(edges, i).x, EdgeStart(edges, i).y, EdgeEnd(edges, i).x, EdgeEnd(edges, i).y,
+							bHit ? "hit" : "miss", fDistance, vRefs[i].bHit ? "hit" : "miss", vRefs[i].t1);
+				}
+			}
+
+			sRayHit hit;
+			bool bHit = rayCaster2D.RayCastVsEdgeSet(ray.vecStart, ray.vecEnd, edges, hit);
+			CheckClosest(stats[SET], vRefs, bHit, hit.nEdgeIndex, hit.fDistance, nReported, ray, scene);
+
+			bHit = rayCaster2D.RayCastVsEdgeGrid(ray.vecStart, ray.vecEnd, grid, hit);
+			CheckClosest(stats[GRID], vRefs, bHit, hit.nEdgeIndex, hit.fDistance, nReported, ray, scene);
+
+			CheckClosest(stats[BATCH_SET], vRefs, vBatchSet[r].nEdgeIndex >= 0, vBatchSet[r].nEdgeIndex, vBatchSet[r].fDistance, nReported, ray, scene);
+			CheckClosest(stats[BATCH_GRID], vRefs, vBatchGrid[r].nEdgeIndex >= 0, vBatchGrid[r].nEdgeIndex, vBatchGrid[r].fDistance, nReported, ray, scene);
+
+			bHit = rayCaster2D.RayCastVsDynamicEdges(ray.vecStart, ray.vecEnd, dynamicEdges, hit);
+			CheckClosest(stats[DYNAMIC], vRefs, bHit, hit.nEdgeIndex, hit.fDistance, nReported, ray, scene);
+
+			bHit = rayCaster2D.RayCastVsEdgeTiers(ray.vecStart, ray.vecEnd, staticGrid, tierEdges, hit);
+			const int nTierEdge = !bHit ? -1 : (hit.bDynamic ? hit.nEdgeIndex + (int)nHalf : hit.nEdgeIndex);
+			CheckClosest(stats[TIERS], vRefs, bHit, nTierEdge, hit.fDistance, nReported, ray, scene);
+		}
+
+		CheckTileGrid(rayCaster2D, scene, stats[TILE_GRID], nReported);
+		CheckShapes(rng, rayCaster2D, scene, stats, nReported);
+		CheckVisibility(rng, rayCaster2D, scene, stats, nReported);
+	}
+
+	long long nTotalMismatches = 0;
+	printf("\n%d scenes, seed %u\n\n", nIterations, nSeed);
+	printf("path                   |        tests |   borderline |   mismatches\n");
+	printf("-----------------------+--------------+--------------+-------------\n");
+	for (const auto& s : stats)
+	{
+		printf("%-22s | %12lld | %12lld | %12lld\n", s.sName.c_str(), s.nTests, s.nBorderline, s.nMismatches);
+		nTotalMismatches += s.nMismatches;
+	}
+
+	return nTotalMismatches == 0 ? 0 : 1;
+}
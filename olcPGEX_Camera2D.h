@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|          OneLoneCoder Pixel Game Engine Extension           |
-	|                    Camera2D - v1.1                          |
+	|                    Camera2D - v1.4                          |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -37,7 +37,7 @@
 	camera like shown below.  This example assumes you are moving towards
 	the player's current position and centering the camera on the player.
 
-			camera.vecCamPos = camera.LerpCamera(camera.ClampVector({ 0, 0 }, vecMapSize, (player.vecPos - camera.vecCamViewSize / 2.0f)), 15.0f);
+			camera.vecCamPos = camera.LerpCamera(camera.ClampVector({ 0, 0 }, vecMapSize, (player.vecPos - camera.WorldViewSize() / 2.0f)), 15.0f, fElapsedTime);
 
 	... and should be followed by a final clamp.
 
@@ -73,6 +73,107 @@
 
 
 
+	-----------------------
+	  v1.2 - NEW FEATURES
+	-----------------------
+
+	LerpCamera now takes the frame's elapsed time and is frame rate
+	independent, so the camera no longer moves faster at higher frame
+	rates.  fSpeed means the same as before (bigger is slower) and feels
+	identical to the old version at 60fps...
+
+			camera.vecCamPos = camera.LerpCamera(vecTarget, camera.fSpeed, fElapsedTime);
+
+	Added zoom and rotation.  vecCamPos is still the world position of
+	the top left of the view, zoom scales the view (2.0f shows half as
+	much of the world, twice as big) and the view rotates around its
+	centre (radians).
+
+			camera.fZoom = 2.0f;
+			camera.fRotation = 0.1f;
+
+	WorldViewSize() is the size of the view in world units, use it in
+	place of vecCamViewSize when centring the camera on something.
+
+	Added transforms between world and screen positions, either one at a
+	time or a whole array in one go (the rotation is only worked out
+	once for the whole array)...
+
+			olc::vf2d vecScreenPos = camera.WorldToScreen(enemy.vecPos);
+			olc::vf2d vecMouseWorld = camera.ScreenToWorld(GetMousePos());
+
+			camera.WorldToScreen(vWorldPoints.data(), vScreenPoints.data(), vWorldPoints.size());
+
+	Added visibility queries so you (and other extensions) can skip
+	drawing anything that is off screen.  VisibleWorldRect() returns the
+	area of the world that can be seen (the bounding box if the camera is
+	rotated), grown by fGuardBand screen pixels on each side...
+
+			camera.fGuardBand = 32.0f;		// objects pop in 32 pixels before they are on screen
+
+			if (camera.IsVisible(enemy.vecPos, enemy.vecSize))
+				DrawDecal(camera.WorldToScreen(enemy.vecPos), enemy.decal, camera.DecalScale());
+
+	Split screen and minimaps are handled by a viewport set.  Each
+	viewport is a camera with its own rectangle on the screen.  Instead
+	of drawing your world once per viewport, submit it once to a draw
+	list in world positions...
+
+			olcPGEX_DrawList2D drawList;
+			olcPGEX_ViewportSet2D viewports;
+
+			int nPlayer1 = viewports.AddViewport({ 0, 0 }, { 160, 240 });
+			int nPlayer2 = viewports.AddViewport({ 160, 0 }, { 160, 240 });
+
+		... then each frame ...
+
+			drawList.Clear();
+			drawList.DrawDecal(player1.vecPos, decPlayer);			// same functions as the PGE, world positions
+			drawList.DrawPartialDecal(vecTilePos, { 16, 16 }, decTiles, vecTileSource, { 16, 16 });
+
+			viewports.vViewports[nPlayer1].camera.vecCamPos = ...;	// move each camera as normal
+			viewports.Render(drawList);
+
+	Every viewport only draws the commands that can be seen through it,
+	and anything hanging over the edge of a viewport is clipped so it
+	doesn't draw over its neighbour.  nCommandsDrawn tells you how many
+	commands were drawn across all viewports last Render.
+
+
+	-----------------------
+	  v1.3 - NEW FEATURES
+	-----------------------
+
+	Scripted camera moves (cut scenes, panning over to a door that has
+	just opened, zooming in on a boss) using the shared olcPGEX_Tween
+	engine (olcPGEX_Tween.h is included by this header, it just needs to
+	be next to it or on your include path).  Give the position of the
+	top left of the view, how long to take and optionally an easing curve...
+
+			camera.TweenTo(vecDoorPos - camera.WorldViewSize() / 2.0f, 1.5f);
+			camera.TweenZoomTo(2.0f, 1.5f, olcPGEX_Tween::Ease::IN_OUT_CUBIC);
+
+	Keep calling LerpCamera as normal, while a tween is running it returns
+	the tweened position (and sets fZoom) instead of following the target,
+	and carries on following once the tween has finished.  IsTweening()
+	tells you if a tween is still running.
+
+
+	-----------------------
+	  v1.4 - NEW FEATURES
+	-----------------------
+
+	DrawDebugInfo draws through the shared olcPGEX_TextCache (again,
+	olcPGEX_TextCache.h only needs to be where the compiler can find
+	it), so only the digits that changed are drawn again each frame.
+
+	Each camera owns its tweens and debug text slots.  A copied camera
+	gets its own (it has the same view, but any tween in progress is not
+	carried over).  The slots are given back to the text cache when the
+	camera is destroyed or assigned over.
+
+
+
 	License (OLC-3)
 	~~~~~~~~~~~~~~~
 
@@ -115,37 +216,176 @@
 #ifndef OLC_PGEX_CAMERA2D 
 #define OLC_PGEX_CAMERA2D
 
+#include "olcPGEX_Tween.h"
+#include "olcPGEX_TextCache.h"
+
 class olcPGEX_Camera2D : public olc::PGEX
 {
 public:
 	olcPGEX_Camera2D() {}
 	olcPGEX_Camera2D(const olc::vf2d camPos, const olc::vf2d camViewSize) { InitialiseCamera(camPos, camViewSize); }
+	~olcPGEX_Camera2D() { i_DestroyTweens(); i_FreeDebugSlots(); }
+
+	// A copy gets its own tweens (and debug text slots) and starts off still, a move takes them over - v1.4
+	olcPGEX_Camera2D(const olcPGEX_Camera2D& other) : olc::PGEX() { i_CopyView(other); }
+	olcPGEX_Camera2D(olcPGEX_Camera2D&& other) noexcept : olc::PGEX() { *this = std::move(other); }
+	olcPGEX_Camera2D& operator=(const olcPGEX_Camera2D& other);
+	olcPGEX_Camera2D& operator=(olcPGEX_Camera2D&& other) noexcept;
+
+	// An area of the world, see VisibleWorldRect - v1.2
+	struct sRect
+	{
+		olc::vf2d vecPos{};
+		olc::vf2d vecSize{};
+	};
 
 	olc::vf2d vecCamPos{};
 	olc::vf2d vecDesiredPos{};
 	olc::vf2d vecCamViewSize{};
 
+	float fSpeed = 15.0f;													// Used by LerpCamera, bigger is slower - v1.2
+	float fZoom = 1.0f;														// v1.2
+	float fRotation = 0.0f;													// Radians, around the centre of the view - v1.2
+	float fGuardBand = 0.0f;												// Screen pixels added around the view for visibility tests - v1.2
+
 private:
 	olc::vf2d vfTextScale{ 1.0f, 1.0f };
-	olc::vi2d viDisplaySize{ 160, 52 };
+	olc::vi2d viDisplaySize{ 160, 64 };
 	olc::vi2d viMargin{ 4, 4 };
 
 	int nYIterator = 12;
+	int nDebugSlots[4] = { -1, -1, -1, -1 };								// Text cache slots, one per changing line - v1.4
 
 	const olc::Pixel pDebugRect = olc::PixelF( 0.5f, 0.75f, 1.0f, 0.25f );
 
+	// The transform only changes when the camera does, so it is worked out once and reused
+	struct sTransform
+	{
+		olc::vf2d vecCamPos{};
+		olc::vf2d vecCamViewSize{};
+		float fZoom = 0.0f;
+		float fRotation = 0.0f;
+		float fGuardBand = 0.0f;
+
+		float fCos = 1.0f;
+		float fSin = 0.0f;
+		olc::vf2d vecWorldCentre{};
+		sRect visibleRect;
+	};
+	mutable sTransform transform;
+
+	// Created on the first TweenTo / TweenZoomTo - v1.3
+	int nTweenX = -1;
+	int nTweenY = -1;
+	int nTweenZoom = -1;
+	bool bTweeningPos = false;
+	bool bTweeningZoom = false;
+
+	void i_CreateTweens();
+	void i_DestroyTweens();
+	void i_FreeDebugSlots();
+	void i_CopyView(const olcPGEX_Camera2D& other);
 	void UpdateDebugProperties(const int textScale);
+	const sTransform& i_Transform() const;
 
 public:
 	void InitialiseCamera(const olc::vf2d camPos, const olc::vf2d viewSize);
-	olc::vf2d LerpCamera(const olc::vf2d desiredPos, const float fSpeed);
+	olc::vf2d LerpCamera(const olc::vf2d desiredPos, const float speed, const float fElapsedTime);
+
+	void TweenTo(const olc::vf2d vecPos, const float fDuration, const olcPGEX_Tween::Ease ease = olcPGEX_Tween::Ease::SMOOTHSTEP);
+	void TweenZoomTo(const float zoom, const float fDuration, const olcPGEX_Tween::Ease ease = olcPGEX_Tween::Ease::SMOOTHSTEP);
+	bool IsTweening() const { return bTweeningPos || bTweeningZoom; }
 
 	void ClampCamera(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight);
 	olc::vf2d ClampVector(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight, const olc::vf2d vecOriginalVector);
 
+	olc::vf2d WorldViewSize() const { return vecCamViewSize / fZoom; }
+	olc::vf2d DecalScale() const { return { fZoom, fZoom }; }
+
+	olc::vf2d WorldToScreen(const olc::vf2d vecWorldPos) const;
+	olc::vf2d ScreenToWorld(const olc::vf2d vecScreenPos) const;
+	void WorldToScreen(const olc::vf2d* pWorldPos, olc::vf2d* pScreenPos, const size_t nCount) const;
+	void ScreenToWorld(const olc::vf2d* pScreenPos, olc::vf2d* pWorldPos, const size_t nCount) const;
+
+	sRect VisibleWorldRect() const;
+	bool IsVisible(const olc::vf2d vecPos, const olc::vf2d vecSize) const;
+
 	void DrawDebugInfo(olc::vi2d screenPos, int textScale = 1);
 };
 
+// World space draw commands, submitted once and replayed by every viewport - v1.2
+class olcPGEX_DrawList2D
+{
+public:
+	enum class CommandType { DECAL, FILL_RECT };
+
+	struct sDrawCommand
+	{
+		CommandType type = CommandType::DECAL;
+		olc::Decal* decal = nullptr;
+		olc::vf2d vecCorners[4];												// World positions, clockwise from the top left of the source
+		olc::vf2d vecSourcePos{};
+		olc::vf2d vecSourceSize{};
+		olc::Pixel tint = olc::WHITE;
+		bool bAxisAligned = true;
+	};
+
+	std::vector<sDrawCommand> vCommands;
+
+	// World bounding box of each command, kept separately so culling only touches what it needs
+	std::vector<float> vMinX, vMinY, vMaxX, vMaxY;
+
+private:
+	void i_AddCommand(const sDrawCommand& cmd);
+
+public:
+	void Clear();
+	size_t Size() const { return vCommands.size(); }
+
+	void DrawDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& scale = { 1.0f, 1.0f }, const olc::Pixel& tint = olc::WHITE);
+	void DrawPartialDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale = { 1.0f, 1.0f }, const olc::Pixel& tint = olc::WHITE);
+	void DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint = olc::WHITE);
+	void DrawRotatedDecal(const olc::vf2d& pos, olc::Decal* decal, const float fAngle, const olc::vf2d& center = { 0.0f, 0.0f }, const olc::vf2d& scale = { 1.0f, 1.0f }, const olc::Pixel& tint = olc::WHITE);
+	void FillRectDecal(const olc::vf2d& pos, const olc::vf2d& size, const olc::Pixel col = olc::WHITE);
+};
+
+// Several cameras, each drawing the same draw list into its own part of the screen - v1.2
+class olcPGEX_ViewportSet2D : public olc::PGEX
+{
+public:
+	olcPGEX_ViewportSet2D() = default;
+	~olcPGEX_ViewportSet2D();
+
+	olcPGEX_ViewportSet2D(const olcPGEX_ViewportSet2D&) = delete;
+	olcPGEX_ViewportSet2D& operator=(const olcPGEX_ViewportSet2D&) = delete;
+
+	struct sViewport
+	{
+		olcPGEX_Camera2D camera;												// camera.vecCamViewSize is the size of the viewport on screen
+		olc::vf2d vecScreenPos{};
+		olc::Pixel pBackground = olc::BLANK;									// Filled before drawing, unless BLANK
+		bool bEnabled = true;
+	};
+
+	std::vector<sViewport> vViewports;
+
+	int nCommandsDrawn = 0;
+	int nCommandsCulled = 0;
+
+private:
+	olc::Sprite* sprWhite = nullptr;
+	olc::Decal* decWhite = nullptr;
+
+	std::vector<olc::vf2d> vClipPos[2];											// Scratch space for clipping
+	std::vector<olc::vf2d> vClipUV[2];
+
+	void i_DrawCommand(const sViewport& viewport, const olcPGEX_DrawList2D::sDrawCommand& cmd);
+
+public:
+	int AddViewport(const olc::vf2d vecScreenPos, const olc::vf2d vecScreenSize, const olc::vf2d vecCamPos = { 0.0f, 0.0f });
+	void Render(const olcPGEX_DrawList2D& drawList);
+};
+
 #ifdef OLC_PGEX_CAMERA2D_IMPLEMENTATION
 #undef OLC_PGEX_CAMERA2D_IMPLEMENTATION
 
@@ -155,17 +395,152 @@ void olcPGEX_Camera2D::InitialiseCamera(const olc::vf2d camPos, const olc::vf2d
 	vecCamViewSize = camViewSize;
 }
 
-olc::vf2d olcPGEX_Camera2D::LerpCamera(const olc::vf2d desiredPos, const float fSpeed)
+olc::vf2d olcPGEX_Camera2D::LerpCamera(const olc::vf2d desiredPos, const float speed, const float fElapsedTime)
+{
+	// A tweened move takes over until it has finished, the last call returns exactly where it ends
+	if (bTweeningZoom || bTweeningPos)
+	{
+		auto& tweens = olcPGEX_Tween::Shared();
+
+		if (bTweeningZoom)
+		{
+			fZoom = tweens.Get(nTweenZoom);
+			bTweeningZoom = tweens.IsActive(nTweenZoom);
+		}
+
+		if (bTweeningPos)
+		{
+			bTweeningPos = tweens.IsActive(nTweenX) || tweens.IsActive(nTweenY);
+			return { tweens.Get(nTweenX), tweens.Get(nTweenY) };
+		}
+	}
+
+	// Moving 1 / speed of the way every 60th of a second is exponential damping, so scale the
+	// exponent by elapsed time to get the same motion at any frame rate
+	if (speed <= 1.0f)
+		return desiredPos;
+
+	const float fBlend = 1.0f - std::pow(1.0f - 1.0f / speed, fElapsedTime * 60.0f);
+	return { vecCamPos + (desiredPos - vecCamPos) * fBlend };
+}
+
+void olcPGEX_Camera2D::i_CreateTweens()
+{
+	if (nTweenX >= 0)
+		return;
+
+	auto& tweens = olcPGEX_Tween::Shared();
+	nTweenX = tweens.Create(vecCamPos.x);
+	nTweenY = tweens.Create(vecCamPos.y);
+	nTweenZoom = tweens.Create(fZoom);
+}
+
+void olcPGEX_Camera2D::i_DestroyTweens()
+{
+	if (nTweenX < 0)
+		return;
+
+	auto& tweens = olcPGEX_Tween::Shared();
+	tweens.Destroy(nTweenX);
+	tweens.Destroy(nTweenY);
+	tweens.Destroy(nTweenZoom);
+	nTweenX = nTweenY = nTweenZoom = -1;
+	bTweeningPos = bTweeningZoom = false;
+}
+
+void olcPGEX_Camera2D::i_FreeDebugSlots()
+{
+	if (nDebugSlots[0] < 0)
+		return;
+
+	auto& text = olcPGEX_TextCache::Shared();
+	for (int& nSlot : nDebugSlots)
+	{
+		text.FreeSlot(nSlot);
+		nSlot = -1;
+	}
+}
+
+void olcPGEX_Camera2D::i_CopyView(const olcPGEX_Camera2D& other)
+{
+	// Everything except the tweens and the debug text slots, which belong to each camera
+	vecCamPos =			other.vecCamPos;
+	vecDesiredPos =		other.vecDesiredPos;
+	vecCamViewSize =	other.vecCamViewSize;
+	fSpeed =			other.fSpeed;
+	fZoom =				other.fZoom;
+	fRotation =			other.fRotation;
+	fGuardBand =		other.fGuardBand;
+
+	vfTextScale =		other.vfTextScale;
+	viDisplaySize =		other.viDisplaySize;
+	viMargin =			other.viMargin;
+	nYIterator =		other.nYIterator;
+	transform =			other.transform;
+}
+
+olcPGEX_Camera2D& olcPGEX_Camera2D::operator=(const olcPGEX_Camera2D& other)
 {
-	return { vecCamPos + (desiredPos - vecCamPos) / fSpeed };
+	if (this == &other)
+		return *this;
+
+	// Any tween we were running is left behind, the camera holds the copied view instead.  The debug text is
+	// about a different view now, so its slots go back to the text cache and fresh ones are taken when drawn
+	i_FreeDebugSlots();
+	i_CopyView(other);
+	bTweeningPos = bTweeningZoom = false;
+	return *this;
+}
+
+olcPGEX_Camera2D& olcPGEX_Camera2D::operator=(olcPGEX_Camera2D&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	i_DestroyTweens();
+	i_FreeDebugSlots();
+	i_CopyView(other);
+
+	nTweenX =			other.nTweenX;
+	nTweenY =			other.nTweenY;
+	nTweenZoom =		other.nTweenZoom;
+	bTweeningPos =		other.bTweeningPos;
+	bTweeningZoom =		other.bTweeningZoom;
+	for (int i = 0; i < 4; i++)
+		nDebugSlots[i] = other.nDebugSlots[i];
+
+	other.nTweenX = other.nTweenY = other.nTweenZoom = -1;
+	other.bTweeningPos = other.bTweeningZoom = false;
+	for (int& nSlot : other.nDebugSlots)
+		nSlot = -1;
+	return *this;
+}
+
+void olcPGEX_Camera2D::TweenTo(const olc::vf2d vecPos, const float fDuration, const olcPGEX_Tween::Ease ease)
+{
+	i_CreateTweens();
+
+	auto& tweens = olcPGEX_Tween::Shared();
+	tweens.Start(nTweenX, vecCamPos.x, vecPos.x, fDuration, ease);
+	tweens.Start(nTweenY, vecCamPos.y, vecPos.y, fDuration, ease);
+	bTweeningPos = true;
+}
+
+void olcPGEX_Camera2D::TweenZoomTo(const float zoom, const float fDuration, const olcPGEX_Tween::Ease ease)
+{
+	i_CreateTweens();
+
+	olcPGEX_Tween::Shared().Start(nTweenZoom, fZoom, zoom, fDuration, ease);
+	bTweeningZoom = true;
 }
 
 void olcPGEX_Camera2D::ClampCamera(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight)
 {
 	if (vecCamPos.x < vecTopLeft.x) vecCamPos.x = vecTopLeft.x;
 	if (vecCamPos.y < vecTopLeft.y) vecCamPos.y = vecTopLeft.y;
-	if (vecCamPos.x + vecCamViewSize.x > vecBottomRight.x) vecCamPos.x = vecBottomRight.x - vecCamViewSize.x;
-	if (vecCamPos.y + vecCamViewSize.y > vecBottomRight.y) vecCamPos.y = vecBottomRight.y - vecCamViewSize.y;
+	const olc::vf2d vecWorldViewSize = WorldViewSize();
+	if (vecCamPos.x + vecWorldViewSize.x > vecBottomRight.x) vecCamPos.x = vecBottomRight.x - vecWorldViewSize.x;
+	if (vecCamPos.y + vecWorldViewSize.y > vecBottomRight.y) vecCamPos.y = vecBottomRight.y - vecWorldViewSize.y;
 }
 
 olc::vf2d olcPGEX_Camera2D::ClampVector(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight, const olc::vf2d vecOriginalVector)
@@ -173,28 +548,117 @@ olc::vf2d olcPGEX_Camera2D::ClampVector(const olc::vf2d vecTopLeft, const olc::v
 	olc::vf2d vecAdjustedVector = vecOriginalVector;
 	if (vecOriginalVector.x < vecTopLeft.x) vecAdjustedVector.x = vecTopLeft.x;
 	if (vecOriginalVector.y < vecTopLeft.y) vecAdjustedVector.y = vecTopLeft.y;
-	if (vecOriginalVector.x + vecCamViewSize.x > vecBottomRight.x) vecAdjustedVector.x = vecBottomRight.x - vecCamViewSize.x;
-	if (vecOriginalVector.y + vecCamViewSize.y > vecBottomRight.y) vecAdjustedVector.y = vecBottomRight.y - vecCamViewSize.y;
+	const olc::vf2d vecWorldViewSize = WorldViewSize();
+	if (vecOriginalVector.x + vecWorldViewSize.x > vecBottomRight.x) vecAdjustedVector.x = vecBottomRight.x - vecWorldViewSize.x;
+	if (vecOriginalVector.y + vecWorldViewSize.y > vecBottomRight.y) vecAdjustedVector.y = vecBottomRight.y - vecWorldViewSize.y;
 
 	return vecAdjustedVector;
 }
 
+const olcPGEX_Camera2D::sTransform& olcPGEX_Camera2D::i_Transform() const
+{
+	if (transform.vecCamPos == vecCamPos && transform.vecCamViewSize == vecCamViewSize && transform.fZoom == fZoom
+		&& transform.fRotation == fRotation && transform.fGuardBand == fGuardBand)
+		return transform;
+
+	transform.vecCamPos = vecCamPos;
+	transform.vecCamViewSize = vecCamViewSize;
+	transform.fZoom = fZoom;
+	transform.fRotation = fRotation;
+	transform.fGuardBand = fGuardBand;
+
+	transform.fCos = std::cos(fRotation);
+	transform.fSin = std::sin(fRotation);
+	transform.vecWorldCentre = vecCamPos + WorldViewSize() / 2.0f;
+
+	// Bounding box of the (possibly rotated) view plus the guard band, in world units
+	const olc::vf2d vecHalfSize = (vecCamViewSize / 2.0f + olc::vf2d{ fGuardBand, fGuardBand }) / fZoom;
+	const olc::vf2d vecHalfExtent = {
+		std::fabs(transform.fCos) * vecHalfSize.x + std::fabs(transform.fSin) * vecHalfSize.y,
+		std::fabs(transform.fSin) * vecHalfSize.x + std::fabs(transform.fCos) * vecHalfSize.y };
+
+	transform.visibleRect.vecPos = transform.vecWorldCentre - vecHalfExtent;
+	transform.visibleRect.vecSize = vecHalfExtent * 2.0f;
+	return transform;
+}
+
+olc::vf2d olcPGEX_Camera2D::WorldToScreen(const olc::vf2d vecWorldPos) const
+{
+	olc::vf2d vecScreenPos;
+	WorldToScreen(&vecWorldPos, &vecScreenPos, 1);
+	return vecScreenPos;
+}
+
+olc::vf2d olcPGEX_Camera2D::ScreenToWorld(const olc::vf2d vecScreenPos) const
+{
+	olc::vf2d vecWorldPos;
+	ScreenToWorld(&vecScreenPos, &vecWorldPos, 1);
+	return vecWorldPos;
+}
+
+void olcPGEX_Camera2D::WorldToScreen(const olc::vf2d* pWorldPos, olc::vf2d* pScreenPos, const size_t nCount) const
+{
+	const sTransform& t = i_Transform();
+	const olc::vf2d vecScreenCentre = vecCamViewSize / 2.0f;
+
+	// Rotate the opposite way to the camera around the centre of the view, then zoom
+	for (size_t i = 0; i < nCount; i++)
+	{
+		const olc::vf2d d = pWorldPos[i] - t.vecWorldCentre;
+		pScreenPos[i] = olc::vf2d{ d.x * t.fCos + d.y * t.fSin, d.y * t.fCos - d.x * t.fSin } * fZoom + vecScreenCentre;
+	}
+}
+
+void olcPGEX_Camera2D::ScreenToWorld(const olc::vf2d* pScreenPos, olc::vf2d* pWorldPos, const size_t nCount) const
+{
+	const sTransform& t = i_Transform();
+	const olc::vf2d vecScreenCentre = vecCamViewSize / 2.0f;
+
+	for (size_t i = 0; i < nCount; i++)
+	{
+		const olc::vf2d d = (pScreenPos[i] - vecScreenCentre) / fZoom;
+		pWorldPos[i] = olc::vf2d{ d.x * t.fCos - d.y * t.fSin, d.x * t.fSin + d.y * t.fCos } + t.vecWorldCentre;
+	}
+}
+
+olcPGEX_Camera2D::sRect olcPGEX_Camera2D::VisibleWorldRect() const
+{
+	return i_Transform().visibleRect;
+}
+
+bool olcPGEX_Camera2D::IsVisible(const olc::vf2d vecPos, const olc::vf2d vecSize) const
+{
+	const sRect& view = i_Transform().visibleRect;
+	return vecPos.x < view.vecPos.x + view.vecSize.x && vecPos.x + vecSize.x > view.vecPos.x
+		&& vecPos.y < view.vecPos.y + view.vecSize.y && vecPos.y + vecSize.y > view.vecPos.y;
+}
+
 void olcPGEX_Camera2D::DrawDebugInfo(olc::vi2d screenPos, int textScale)
 {
 	UpdateDebugProperties(textScale);
 
 	pge->FillRectDecal(screenPos - viMargin, viDisplaySize, pDebugRect);
 
-	pge->DrawStringPropDecal(screenPos, "CAMERA", olc::CYAN, vfTextScale);
+	auto& text = olcPGEX_TextCache::Shared();
+	if (nDebugSlots[0] < 0)
+	{
+		for (int& nSlot : nDebugSlots)
+			nSlot = text.NewSlot();
+	}
+
+	text.DrawString(screenPos, "CAMERA", olc::CYAN, vfTextScale, true);
 	screenPos.y += nYIterator;
 
-	pge->DrawStringPropDecal(screenPos, "Position: " + std::to_string((int)vecCamPos.x) + ", " + std::to_string((int)vecCamPos.y), olc::CYAN, vfTextScale);
+	text.DrawString(nDebugSlots[0], screenPos, "Position: " + std::to_string((int)vecCamPos.x) + ", " + std::to_string((int)vecCamPos.y), olc::CYAN, vfTextScale, true);
 	screenPos.y += nYIterator;
 
-	pge->DrawStringPropDecal(screenPos, "Desired Pos: " + std::to_string((int)vecDesiredPos.x) + ", " + std::to_string((int)vecDesiredPos.y), olc::CYAN, vfTextScale);
+	text.DrawString(nDebugSlots[1], screenPos, "Desired Pos: " + std::to_string((int)vecDesiredPos.x) + ", " + std::to_string((int)vecDesiredPos.y), olc::CYAN, vfTextScale, true);
 	screenPos.y += nYIterator;
 
-	pge->DrawStringPropDecal(screenPos, "Cam Size: " + std::to_string((int)vecCamViewSize.x) + ", " + std::to_string((int)vecCamViewSize.y), olc::CYAN, vfTextScale);
+	text.DrawString(nDebugSlots[2], screenPos, "Cam Size: " + std::to_string((int)vecCamViewSize.x) + ", " + std::to_string((int)vecCamViewSize.y), olc::CYAN, vfTextScale, true);
+	screenPos.y += nYIterator;
+
+	text.DrawString(nDebugSlots[3], screenPos, "Zoom: " + std::to_string(fZoom).substr(0, 4) + "  Rot: " + std::to_string(fRotation).substr(0, 5), olc::CYAN, vfTextScale, true);
 }
 
 void olcPGEX_Camera2D::UpdateDebugProperties(const int textScale)
@@ -205,12 +669,245 @@ void olcPGEX_Camera2D::UpdateDebugProperties(const int textScale)
 	if (textScale > 0 && textScale < 11)
 	{
 		vfTextScale = { (float)textScale, (float)textScale };
-		viDisplaySize = { 160 * textScale, 52 * textScale };
+		viDisplaySize = { 160 * textScale, 64 * textScale };
 		viMargin = { 4 * textScale, 4 * textScale };
 
 		nYIterator = 12 * textScale;
 	}
 }
 
+void olcPGEX_DrawList2D::Clear()
+{
+	vCommands.clear();
+	vMinX.clear();
+	vMinY.clear();
+	vMaxX.clear();
+	vMaxY.clear();
+}
+
+void olcPGEX_DrawList2D::i_AddCommand(const sDrawCommand& cmd)
+{
+	olc::vf2d vecMin = cmd.vecCorners[0];
+	olc::vf2d vecMax = cmd.vecCorners[0];
+	for (int i = 1; i < 4; i++)
+	{
+		vecMin = vecMin.min(cmd.vecCorners[i]);
+		vecMax = vecMax.max(cmd.vecCorners[i]);
+	}
+
+	vCommands.push_back(cmd);
+	vMinX.push_back(vecMin.x);
+	vMinY.push_back(vecMin.y);
+	vMaxX.push_back(vecMax.x);
+	vMaxY.push_back(vecMax.y);
+}
+
+void olcPGEX_DrawList2D::DrawDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& scale, const olc::Pixel& tint)
+{
+	const olc::vf2d vecSourceSize = { (float)decal->sprite->width, (float)decal->sprite->height };
+	DrawPartialDecal(pos, vecSourceSize * scale, decal, { 0.0f, 0.0f }, vecSourceSize, tint);
+}
+
+void olcPGEX_DrawList2D::DrawPartialDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale, const olc::Pixel& tint)
+{
+	DrawPartialDecal(pos, source_size * scale, decal, source_pos, source_size, tint);
+}
+
+void olcPGEX_DrawList2D::DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
+{
+	sDrawCommand cmd;
+	cmd.decal = decal;
+	cmd.vecCorners[0] = pos;
+	cmd.vecCorners[1] = pos + olc::vf2d{ size.x, 0.0f };
+	cmd.vecCorners[2] = pos + size;
+	cmd.vecCorners[3] = pos + olc::vf2d{ 0.0f, size.y };
+	cmd.vecSourcePos = source_pos;
+	cmd.vecSourceSize = source_size;
+	cmd.tint = tint;
+	i_AddCommand(cmd);
+}
+
+void olcPGEX_DrawList2D::DrawRotatedDecal(const olc::vf2d& pos, olc::Decal* decal, const float fAngle, const olc::vf2d& center, const olc::vf2d& scale, const olc::Pixel& tint)
+{
+	sDrawCommand cmd;
+	cmd.decal = decal;
+	cmd.vecSourceSize = { (float)decal->sprite->width, (float)decal->sprite->height };
+	cmd.tint = tint;
+	cmd.bAxisAligned = false;
+
+	// Same as the PGE, the decal is rotated around center (in source pixels) which is placed at pos
+	const float c = std::cos(fAngle), s = std::sin(fAngle);
+	const olc::vf2d vecLocal[4] = { { 0.0f, 0.0f }, { cmd.vecSourceSize.x, 0.0f }, cmd.vecSourceSize, { 0.0f, cmd.vecSourceSize.y } };
+	for (int i = 0; i < 4; i++)
+	{
+		const olc::vf2d d = (vecLocal[i] - center) * scale;
+		cmd.vecCorners[i] = pos + olc::vf2d{ d.x * c - d.y * s, d.x * s + d.y * c };
+	}
+
+	i_AddCommand(cmd);
+}
+
+void olcPGEX_DrawList2D::FillRectDecal(const olc::vf2d& pos, const olc::vf2d& size, const olc::Pixel col)
+{
+	sDrawCommand cmd;
+	cmd.type = CommandType::FILL_RECT;
+	cmd.vecCorners[0] = pos;
+	cmd.vecCorners[1] = pos + olc::vf2d{ size.x, 0.0f };
+	cmd.vecCorners[2] = pos + size;
+	cmd.vecCorners[3] = pos + olc::vf2d{ 0.0f, size.y };
+	cmd.vecSourceSize = { 1.0f, 1.0f };
+	cmd.tint = col;
+	i_AddCommand(cmd);
+}
+
+olcPGEX_ViewportSet2D::~olcPGEX_ViewportSet2D()
+{
+	delete decWhite;
+	delete sprWhite;
+}
+
+int olcPGEX_ViewportSet2D::AddViewport(const olc::vf2d vecScreenPos, const olc::vf2d vecScreenSize, const olc::vf2d vecCamPos)
+{
+	sViewport viewport;
+	viewport.camera.InitialiseCamera(vecCamPos, vecScreenSize);
+	viewport.vecScreenPos = vecScreenPos;
+	vViewports.push_back(viewport);
+	return (int)vViewports.size() - 1;
+}
+
+void olcPGEX_ViewportSet2D::Render(const olcPGEX_DrawList2D& drawList)
+{
+	// Filled rectangles are drawn as a tinted white decal so they can be clipped like everything else
+	if (decWhite == nullptr)
+	{
+		sprWhite = new olc::Sprite(1, 1);
+		sprWhite->SetPixel(0, 0, olc::WHITE);
+		decWhite = new olc::Decal(sprWhite);
+	}
+
+	nCommandsDrawn = 0;
+	nCommandsCulled = 0;
+
+	for (const auto& viewport : vViewports)
+	{
+		if (!viewport.bEnabled)
+			continue;
+
+		if (viewport.pBackground != olc::BLANK)
+			pge->FillRectDecal(viewport.vecScreenPos, viewport.camera.vecCamViewSize, viewport.pBackground);
+
+		const olcPGEX_Camera2D::sRect view = viewport.camera.VisibleWorldRect();
+		const float fViewMaxX = view.vecPos.x + view.vecSize.x;
+		const float fViewMaxY = view.vecPos.y + view.vecSize.y;
+
+		for (size_t i = 0; i < drawList.Size(); i++)
+		{
+			if (drawList.vMaxX[i] <= view.vecPos.x || drawList.vMinX[i] >= fViewMaxX || drawList.vMaxY[i] <= view.vecPos.y || drawList.vMinY[i] >= fViewMaxY)
+			{
+				nCommandsCulled++;
+				continue;
+			}
+
+			i_DrawCommand(viewport, drawList.vCommands[i]);
+			nCommandsDrawn++;
+		}
+	}
+}
+
+void olcPGEX_ViewportSet2D::i_DrawCommand(const sViewport& viewport, const olcPGEX_DrawList2D::sDrawCommand& cmd)
+{
+	const olcPGEX_Camera2D& camera = viewport.camera;
+	olc::Decal* decal = cmd.type == olcPGEX_DrawList2D::CommandType::FILL_RECT ? decWhite : cmd.decal;
+
+	const olc::vf2d vecClipMin = viewport.vecScreenPos;
+	const olc::vf2d vecClipMax = viewport.vecScreenPos + camera.vecCamViewSize;
+
+	olc::vf2d vecScreen[4];
+	camera.WorldToScreen(cmd.vecCorners, vecScreen, 4);
+	for (auto& p : vecScreen)
+		p += viewport.vecScreenPos;
+
+	// The common case - nothing is rotated, so clipping is just trimming the rectangle and its source
+	if (cmd.bAxisAligned && camera.fRotation == 0.0f)
+	{
+		olc::vf2d vecPos = vecScreen[0];
+		olc::vf2d vecSize = vecScreen[2] - vecScreen[0];
+		olc::vf2d vecSourcePos = cmd.vecSourcePos;
+		olc::vf2d vecSourceSize = cmd.vecSourceSize;
+
+		const olc::vf2d vecNewMin = vecPos.max(vecClipMin);
+		const olc::vf2d vecNewMax = (vecPos + vecSize).min(vecClipMax);
+		if (vecNewMin.x >= vecNewMax.x || vecNewMin.y >= vecNewMax.y)
+			return;
+
+		if (vecNewMin != vecPos || vecNewMax != vecPos + vecSize)
+		{
+			const olc::vf2d vecSourcePerPixel = vecSourceSize / vecSize;
+			vecSourcePos += (vecNewMin - vecPos) * vecSourcePerPixel;
+			vecSourceSize = (vecNewMax - vecNewMin) * vecSourcePerPixel;
+			vecPos = vecNewMin;
+			vecSize = vecNewMax - vecNewMin;
+		}
+
+		pge->DrawPartialDecal(vecPos, vecSize, decal, vecSourcePos, vecSourceSize, cmd.tint);
+		return;
+	}
+
+	// Otherwise clip the quad against each side of the viewport in turn (Sutherland-Hodgman),
+	// carrying the texture coordinates along, and draw whatever is left as a polygon
+	const olc::vf2d vecUVScale = decal->vUVScale;
+	const olc::vf2d vecSourceCorners[4] = { cmd.vecSourcePos, cmd.vecSourcePos + olc::vf2d{ cmd.vecSourceSize.x, 0.0f },
+		cmd.vecSourcePos + cmd.vecSourceSize, cmd.vecSourcePos + olc::vf2d{ 0.0f, cmd.vecSourceSize.y } };
+
+	vClipPos[0].assign(vecScreen, vecScreen + 4);
+	vClipUV[0].clear();
+	for (const auto& p : vecSourceCorners)
+		vClipUV[0].push_back(p * vecUVScale);
+
+	for (int nSide = 0; nSide < 4; nSide++)
+	{
+		const int nAxis = nSide % 2;
+		const bool bMin = nSide < 2;
+		const float fLimit = bMin ? (nAxis == 0 ? vecClipMin.x : vecClipMin.y) : (nAxis == 0 ? vecClipMax.x : vecClipMax.y);
+		auto inside = [&](const olc::vf2d& p) { const float v = nAxis == 0 ? p.x : p.y; return bMin ? v >= fLimit : v <= fLimit; };
+
+		const auto& vInPos = vClipPos[0];
+		const auto& vInUV = vClipUV[0];
+		auto& vOutPos = vClipPos[1];
+		auto& vOutUV = vClipUV[1];
+		vOutPos.clear();
+		vOutUV.clear();
+
+		for (size_t i = 0; i < vInPos.size(); i++)
+		{
+			const size_t j = (i + 1) % vInPos.size();
+			const bool bInsideI = inside(vInPos[i]);
+			const bool bInsideJ = inside(vInPos[j]);
+
+			if (bInsideI)
+			{
+				vOutPos.push_back(vInPos[i]);
+				vOutUV.push_back(vInUV[i]);
+			}
+
+			if (bInsideI != bInsideJ)
+			{
+				const float a = nAxis == 0 ? vInPos[i].x : vInPos[i].y;
+				const float b = nAxis == 0 ? vInPos[j].x : vInPos[j].y;
+				const float t = (fLimit - a) / (b - a);
+				vOutPos.push_back(vInPos[i] + (vInPos[j] - vInPos[i]) * t);
+				vOutUV.push_back(vInUV[i] + (vInUV[j] - vInUV[i]) * t);
+			}
+		}
+
+		std::swap(vClipPos[0], vClipPos[1]);
+		std::swap(vClipUV[0], vClipUV[1]);
+		if (vClipPos[0].size() < 3)
+			return;
+	}
+
+	pge->DrawPolygonDecal(decal, vClipPos[0], vClipUV[0], cmd.tint);
+}
+
 #endif	// implementation guard
 #endif	// header guard
@@ -0,0 +1,589 @@
+/*
+	olcPGEX_LightMap2D.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                   LightMap2D - v1.0                         |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It lights your 2D scene with point lights that are blocked by the
+	walls of your level, so light doesn't leak into the next room.
+
+	Each light (position, radius and colour) is shaded using a
+	visibility polygon from olcPGEX_RayCast2D, then all of the lights
+	are added together into a small low resolution light map on the
+	CPU (SSE2 saturating adds where available).  The light map is then
+	multiplied over your scene as a single decal, so the GPU cost is
+	the same however many lights you have.
+
+	Static lights are only shaded once and kept in a cache, and are only
+	shaded again if something that can block them moves nearby.  So a
+	level full of wall torches costs little more than adding a few
+	small images together each frame.
+
+
+	How to use it?
+	~~~~~~~~~~~~~~
+	The light map needs the RayCast2D extension (and olcPGEX_ThreadPool.h
+	which RayCast2D includes).  Include both headers after the
+	olcPixelGameEngine, and define the implementation guards once...
+
+		#include "olcPixelGameEngine.h"
+
+		#define OLC_PGEX_RAYCAST2D_IMPLEMENTATION
+		#include "olcPGEX_RayCast2D.h"
+
+		#define OLC_PGEX_LIGHTMAP2D_IMPLEMENTATION
+		#include "olcPGEX_LightMap2D.h"
+
+	Create the light map once in OnUserCreate.  Pass in your screen size
+	and the size of each light map texel in pixels (4 is a good start,
+	bigger is faster but blurrier).  Then give it the edges of your level
+	and set the ambient light for areas no light reaches...
+
+		olcPGEX_LightMap2D lightMap;
+
+		lightMap.Create({ ScreenWidth(), ScreenHeight() }, 4);
+		lightMap.SetOccluders(&levelEdges, &dynamicEdges);		// dynamic edges are optional
+		lightMap.SetAmbient(olc::Pixel(20, 20, 40));
+
+	levelEdges is an olcPGEX_RayCast2D::sEdgeSet and dynamicEdges an
+	olcPGEX_RayCast2D::sDynamicEdgeSet (doors, moving platforms etc).
+	Both must outlive the light map.  Add your lights...
+
+		int nTorchID = lightMap.AddLight(vecTorchPos, 120.0f, olc::Pixel(255, 180, 100));
+		int nPlayerLightID = lightMap.AddLight(vecPlayerPos, 200.0f, olc::WHITE, false);	// moves every frame
+
+	The last parameter says whether the light is static (the default)
+	or dynamic.  Dynamic lights are shaded every frame, static lights
+	only when they need to be.  Move and remove lights using their ID...
+
+		lightMap.MoveLight(nPlayerLightID, vecPlayerPos);
+		lightMap.RemoveLight(nTorchID);
+
+	Then, after drawing your scene each frame, update and draw the light
+	map using your camera position (top left of the view in the world)...
+
+		lightMap.Update(camera.vecCamPos, &threadPool);			// thread pool is optional
+		lightMap.Draw(camera.vecCamPos);
+
+	Moving dynamic edges are found automatically, any static light they
+	come near is shaded again.  If you change the static edge set (tiles
+	destroyed for example) tell the light map where it happened...
+
+		lightMap.InvalidateArea(vecTileTopLeft, vecTileBottomRight);
+
+	NOTE: Anything drawn with decals after Draw is not lit, which is
+	handy for your HUD.  Define OLC_PGEX_LIGHTMAP2D_NO_SIMD before
+	including the header to force the scalar version of the blending.
+
+
+
+	License (OLC-3)
+	~~~~~~~~~~~~~~~
+
+	Copyright 2018 - 2019 OneLoneCoder.com
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	1. Redistributions or derivations of source code must retain the above
+	copyright notice, this list of conditions and the following disclaimer.
+
+	2. Redistributions or derivative works in binary form must reproduce
+	the above copyright notice. This list of conditions and the following
+	disclaimer must be reproduced in the documentation and/or other
+	materials provided with the distribution.
+
+	3. Neither the name of the copyright holder nor the names of its
+	contributors may be used to endorse or promote products derived
+	from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+	LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+	DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+	THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	Author
+	~~~~~~
+	Justin Richards
+
+*/
+
+#ifndef OLC_PGEX_LIGHTMAP2D
+#define OLC_PGEX_LIGHTMAP2D
+
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_RayCast2D.h"
+#include <cstring>
+
+#if !defined(OLC_PGEX_LIGHTMAP2D_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define OLC_PGEX_LIGHTMAP2D_SSE2
+		#include <emmintrin.h>
+	#endif
+#endif
+
+class olcPGEX_LightMap2D : public olc::PGEX
+{
+public:
+	olcPGEX_LightMap2D() = default;
+	~olcPGEX_LightMap2D();
+
+	olcPGEX_LightMap2D(const olcPGEX_LightMap2D&) = delete;
+	olcPGEX_LightMap2D& operator=(const olcPGEX_LightMap2D&) = delete;
+
+private:
+	struct sLight
+	{
+		olc::vf2d vecPos{};
+		float fRadius =					0.0f;
+		olc::Pixel pColour =				olc::WHITE;
+		bool bStatic =					true;
+		bool bAlive =					false;
+		bool bDirty =					true;
+
+		// Shaded light in world texels, alpha is left at zero so it never changes the light map alpha
+		olc::vi2d vecTexelMin{};
+		olc::vi2d vecTexelSize{};
+		std::vector<uint32_t> vTexels;
+
+		uint64_t nOccluderHash =			0;					// Dynamic edges near the light when it was last shaded
+		olcPGEX_RayCast2D::sEdgeSet occluders;							// Scratch space, edges within reach of the light
+		olcPGEX_RayCast2D::sVisibilityPolygon poly;
+	};
+
+	olcPGEX_RayCast2D rayCaster2D;
+
+	const olcPGEX_RayCast2D::sEdgeSet* pStaticEdges =		nullptr;
+	const olcPGEX_RayCast2D::sDynamicEdgeSet* pDynamicEdges =	nullptr;
+
+	std::vector<sLight> vLights;
+	std::vector<int> vFreeIDs;
+	std::vector<int> vDirtyIDs;
+
+	int nTexelSize =					4;
+	olc::vi2d vecViewTexels{};
+	olc::vi2d vecViewTexelMin{};
+	olc::Pixel pAmbient =					olc::BLACK;
+
+	std::vector<uint32_t> vLightMap;
+	olc::Sprite* sprLightMap =				nullptr;
+	olc::Decal* decLightMap =				nullptr;
+
+public:
+	int nLightsShaded =					0;					// Lights shaded during the last Update
+	int nLightsDrawn =					0;					// Lights added into the light map during the last Update
+
+private:
+	template<typename EdgeFunc>
+	void			i_ForEachDynamicEdge		(const sLight& light, EdgeFunc&& edgeFunc) const;
+	uint64_t		i_OccluderHash			(const sLight& light) const;
+	void			i_ShadeLight			(sLight& light);
+	void			i_FillTriangle			(sLight& light, olc::vf2d a, olc::vf2d b, olc::vf2d c);
+	static void		i_AddRow			(uint32_t* pDst, const uint32_t* pSrc, const int nCount);
+
+public:
+	void			Create				(const olc::vi2d vecScreenSize, const int texelSize = 4);
+	void			SetOccluders			(const olcPGEX_RayCast2D::sEdgeSet* staticEdges, const olcPGEX_RayCast2D::sDynamicEdgeSet* dynamicEdges = nullptr);
+	void			SetAmbient			(const olc::Pixel ambient);
+
+	int			AddLight			(const olc::vf2d vecPos, const float radius, const olc::Pixel colour, const bool isStatic = true);
+	void			RemoveLight			(const int nID);
+	void			MoveLight			(const int nID, const olc::vf2d vecPos);
+	void			SetLightColour			(const int nID, const olc::Pixel colour);
+	void			SetLightRadius			(const int nID, const float radius);
+
+	void			InvalidateArea			(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight);
+	void			InvalidateAll			();
+
+	void			Update				(const olc::vf2d vecCamPos, olcPGEX_ThreadPool* pThreadPool = nullptr);
+	void			Draw				(const olc::vf2d vecCamPos);
+};
+
+#ifdef OLC_PGEX_LIGHTMAP2D_IMPLEMENTATION
+#undef OLC_PGEX_LIGHTMAP2D_IMPLEMENTATION
+
+olcPGEX_LightMap2D::~olcPGEX_LightMap2D()
+{
+	delete decLightMap;
+	delete sprLightMap;
+}
+
+void olcPGEX_LightMap2D::Create(const olc::vi2d vecScreenSize, const int texelSize)
+{
+	nTexelSize = std::max(1, texelSize);
+
+	// One extra texel each way so the map still covers the screen when the camera is part way across a texel
+	vecViewTexels = { vecScreenSize.x / nTexelSize + 2, vecScreenSize.y / nTexelSize + 2 };
+	vLightMap.assign((size_t)vecViewTexels.x * vecViewTexels.y, 0);
+
+	delete decLightMap;
+	delete sprLightMap;
+	sprLightMap = new olc::Sprite(vecViewTexels.x, vecViewTexels.y);
+	decLightMap = new olc::Decal(sprLightMap, true);
+
+	// Texel size changed, so every cached light is out of date
+	InvalidateAll();
+}
+
+void olcPGEX_LightMap2D::SetOccluders(const olcPGEX_RayCast2D::sEdgeSet* staticEdges, const olcPGEX_RayCast2D::sDynamicEdgeSet* dynamicEdges)
+{
+	pStaticEdges = staticEdges;
+	pDynamicEdges = dynamicEdges;
+	InvalidateAll();
+}
+
+void olcPGEX_LightMap2D::SetAmbient(const olc::Pixel ambient)
+{
+	pAmbient = ambient;
+}
+
+int olcPGEX_LightMap2D::AddLight(const olc::vf2d vecPos, const float radius, const olc::Pixel colour, const bool isStatic)
+{
+	int nID;
+	if (!vFreeIDs.empty())
+	{
+		nID = vFreeIDs.back();
+		vFreeIDs.pop_back();
+	}
+	else
+	{
+		nID = (int)vLights.size();
+		vLights.emplace_back();
+	}
+
+	sLight& light = vLights[nID];
+	light.vecPos = vecPos;
+	light.fRadius = radius;
+	light.pColour = colour;
+	light.bStatic = isStatic;
+	light.bAlive = true;
+	light.bDirty = true;
+	return nID;
+}
+
+void olcPGEX_LightMap2D::RemoveLight(const int nID)
+{
+	if (nID < 0 || nID >= (int)vLights.size() || !vLights[nID].bAlive)
+		return;
+
+	vLights[nID].bAlive = false;
+	vLights[nID].vTexels.clear();
+	vFreeIDs.push_back(nID);
+}
+
+void olcPGEX_LightMap2D::MoveLight(const int nID, const olc::vf2d vecPos)
+{
+	if (nID < 0 || nID >= (int)vLights.size() || !vLights[nID].bAlive)
+		return;
+
+	if (vLights[nID].vecPos != vecPos)
+	{
+		vLights[nID].vecPos = vecPos;
+		vLights[nID].bDirty = true;
+	}
+}
+
+void olcPGEX_LightMap2D::SetLightColour(const int nID, const olc::Pixel colour)
+{
+	if (nID < 0 || nID >= (int)vLights.size() || !vLights[nID].bAlive)
+		return;
+
+	vLights[nID].pColour = colour;
+	vLights[nID].bDirty = true;
+}
+
+void olcPGEX_LightMap2D::SetLightRadius(const int nID, const float radius)
+{
+	if (nID < 0 || nID >= (int)vLights.size() || !vLights[nID].bAlive)
+		return;
+
+	vLights[nID].fRadius = radius;
+	vLights[nID].bDirty = true;
+}
+
+void olcPGEX_LightMap2D::InvalidateArea(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight)
+{
+	for (auto& light : vLights)
+	{
+		// Closest point of the area to the light
+		const olc::vf2d vecClosest = light.vecPos.max(vecTopLeft).min(vecBottomRight);
+		if ((vecClosest - light.vecPos).mag2() <= light.fRadius * light.fRadius)
+			light.bDirty = true;
+	}
+}
+
+void olcPGEX_LightMap2D::InvalidateAll()
+{
+	for (auto& light : vLights)
+		light.bDirty = true;
+}
+
+void olcPGEX_LightMap2D::Update(const olc::vf2d vecCamPos, olcPGEX_ThreadPool* pThreadPool)
+{
+	if (sprLightMap == nullptr)
+		return;
+
+	// Find every light that needs shading this frame
+	vDirtyIDs.clear();
+	for (int i = 0; i < (int)vLights.size(); i++)
+	{
+		sLight& light = vLights[i];
+		if (!light.bAlive)
+			continue;
+
+		if (light.bStatic && !light.bDirty && pDynamicEdges != nullptr && i_OccluderHash(light) != light.nOccluderHash)
+			light.bDirty = true;
+
+		if (!light.bStatic || light.bDirty)
+			vDirtyIDs.push_back(i);
+	}
+
+	// Each light has its own scratch space, so they can be shaded on any thread
+	auto shadeRange = [&](const size_t nBegin, const size_t nEnd)
+	{
+		for (size_t i = nBegin; i < nEnd; i++)
+			i_ShadeLight(vLights[vDirtyIDs[i]]);
+	};
+
+	if (pThreadPool != nullptr)
+		pThreadPool->ParallelFor(vDirtyIDs.size(), 1, shadeRange);
+	else
+		shadeRange(0, vDirtyIDs.size());
+
+	nLightsShaded = (int)vDirtyIDs.size();
+
+	// Start from the ambient light, with full alpha so the multiply leaves the scene alpha alone
+	olc::Pixel pClear = pAmbient;
+	pClear.a = 255;
+	std::fill(vLightMap.begin(), vLightMap.end(), pClear.n);
+
+	vecViewTexelMin = { (int)std::floor(vecCamPos.x / nTexelSize), (int)std::floor(vecCamPos.y / nTexelSize) };
+	const olc::vi2d vecViewTexelMax = vecViewTexelMin + vecViewTexels;
+
+	// Add each visible light in, one row at a time
+	nLightsDrawn = 0;
+	for (const auto& light : vLights)
+	{
+		if (!light.bAlive || light.vTexels.empty())
+			continue;
+
+		const olc::vi2d vecMin = light.vecTexelMin.max(vecViewTexelMin);
+		const olc::vi2d vecMax = (light.vecTexelMin + light.vecTexelSize).min(vecViewTexelMax);
+		if (vecMin.x >= vecMax.x || vecMin.y >= vecMax.y)
+			continue;
+
+		for (int y = vecMin.y; y < vecMax.y; y++)
+		{
+			uint32_t* pDst = &vLightMap[(size_t)(y - vecViewTexelMin.y) * vecViewTexels.x + (vecMin.x - vecViewTexelMin.x)];
+			const uint32_t* pSrc = &light.vTexels[(size_t)(y - light.vecTexelMin.y) * light.vecTexelSize.x + (vecMin.x - light.vecTexelMin.x)];
+			i_AddRow(pDst, pSrc, vecMax.x - vecMin.x);
+		}
+
+		nLightsDrawn++;
+	}
+
+	std::memcpy((void*)sprLightMap->GetData(), vLightMap.data(), vLightMap.size() * sizeof(uint32_t));
+	decLightMap->Update();
+}
+
+void olcPGEX_LightMap2D::Draw(const olc::vf2d vecCamPos)
+{
+	if (decLightMap == nullptr)
+		return;
+
+	const olc::vf2d vecScreenPos = olc::vf2d{ (float)vecViewTexelMin.x, (float)vecViewTexelMin.y } * (float)nTexelSize - vecCamPos;
+
+	pge->SetDecalMode(olc::DecalMode::MULTIPLICATIVE);
+	pge->DrawDecal(vecScreenPos, decLightMap, { (float)nTexelSize, (float)nTexelSize });
+	pge->SetDecalMode(olc::DecalMode::NORMAL);
+}
+
+template<typename EdgeFunc>
+void olcPGEX_LightMap2D::i_ForEachDynamicEdge(const sLight& light, EdgeFunc&& edgeFunc) const
+{
+	// Only the grid cells under the light's square, plus the edges that leave the grid
+	const auto& dynamicEdges = *pDynamicEdges;
+	for (const int nID : dynamicEdges.vOutside)
+		edgeFunc(dynamicEdges.vIDToDense[nID]);
+
+	const olc::vf2d vecLow = (light.vecPos - olc::vf2d{ light.fRadius, light.fRadius } - dynamicEdges.vecOrigin) / dynamicEdges.vecCellSize;
+	const olc::vf2d vecHigh = (light.vecPos + olc::vf2d{ light.fRadius, light.fRadius } - dynamicEdges.vecOrigin) / dynamicEdges.vecCellSize;
+	if (vecHigh.x < 0.0f || vecHigh.y < 0.0f || vecLow.x >= (float)dynamicEdges.vecCells.x || vecLow.y >= (float)dynamicEdges.vecCells.y)
+		return;
+
+	const olc::vi2d vecMin = { std::max((int)vecLow.x, 0), std::max((int)vecLow.y, 0) };
+	const olc::vi2d vecMax = { std::min((int)vecHigh.x, dynamicEdges.vecCells.x - 1), std::min((int)vecHigh.y, dynamicEdges.vecCells.y - 1) };
+
+	for (int y = vecMin.y; y <= vecMax.y; y++)
+		for (int x = vecMin.x; x <= vecMax.x; x++)
+			for (const int nID : dynamicEdges.vCells[y * dynamicEdges.vecCells.x + x])
+			{
+				// An edge covering several cells is only visited from the first of them under the light.  No marks
+				// are needed, so lights can still be shaded on any thread
+				const olc::vi2d vecFirst = dynamicEdges.vCellMin[nID].max(vecMin);
+				if (x == vecFirst.x && y == vecFirst.y)
+					edgeFunc(dynamicEdges.vIDToDense[nID]);
+			}
+}
+
+uint64_t olcPGEX_LightMap2D::i_OccluderHash(const sLight& light) const
+{
+	// FNV-1a over each dynamic edge whose bounding box reaches the light, summed so the order the grid hands
+	// them over in doesn't matter
+	uint64_t nSum = 0;
+	const auto& edges = pDynamicEdges->edges;
+	i_ForEachDynamicEdge(light, [&](const int i)
+	{
+		const olc::vf2d vecStart = { edges.vStartX[i], edges.vStartY[i] };
+		const olc::vf2d vecEnd = vecStart + olc::vf2d{ edges.vDeltaX[i], edges.vDeltaY[i] };
+		const olc::vf2d vecClosest = light.vecPos.max(vecStart.min(vecEnd)).min(vecStart.max(vecEnd));
+		if ((vecClosest - light.vecPos).mag2() > light.fRadius * light.fRadius)
+			return;
+
+		uint64_t nHash = 14695981039346656037ULL;
+		auto mix = [&nHash](const uint32_t n) { nHash = (nHash ^ n) * 1099511628211ULL; };
+
+		uint32_t nBits[4];
+		std::memcpy(nBits, &vecStart, sizeof(float) * 2);
+		std::memcpy(nBits + 2, &vecEnd, sizeof(float) * 2);
+		mix((uint32_t)pDynamicEdges->vDenseToID[i]);
+		for (const uint32_t n : nBits)
+			mix(n);
+
+		nSum += nHash;
+	});
+
+	return nSum;
+}
+
+void olcPGEX_LightMap2D::i_ShadeLight(sLight& light)
+{
+	light.bDirty = false;
+	if (pDynamicEdges != nullptr)
+		light.nOccluderHash = i_OccluderHash(light);
+
+	const float fTexelSize = (float)nTexelSize;
+	light.vecTexelMin = { (int)std::floor((light.vecPos.x - light.fRadius) / fTexelSize), (int)std::floor((light.vecPos.y - light.fRadius) / fTexelSize) };
+	const olc::vi2d vecTexelMax = { (int)std::floor((light.vecPos.x + light.fRadius) / fTexelSize), (int)std::floor((light.vecPos.y + light.fRadius) / fTexelSize) };
+	light.vecTexelSize = vecTexelMax - light.vecTexelMin + olc::vi2d{ 1, 1 };
+	light.vTexels.assign((size_t)light.vecTexelSize.x * light.vecTexelSize.y, 0);
+
+	if (light.fRadius <= 0.0f)
+		return;
+
+	// Only edges within reach of the light can cast a shadow, from both tiers
+	light.occluders.Clear();
+	auto gather = [&](const olcPGEX_RayCast2D::sEdgeSet& edges, const size_t i)
+	{
+		const olc::vf2d vecStart = { edges.vStartX[i], edges.vStartY[i] };
+		const olc::vf2d vecDelta = { edges.vDeltaX[i], edges.vDeltaY[i] };
+		const float fLength2 = vecDelta.mag2();
+		const float t = fLength2 > 0.0f ? std::min(std::max((light.vecPos - vecStart).dot(vecDelta) / fLength2, 0.0f), 1.0f) : 0.0f;
+
+		if ((vecStart + vecDelta * t - light.vecPos).mag2() <= light.fRadius * light.fRadius)
+			light.occluders.AddEdge(vecStart, vecStart + vecDelta);
+	};
+
+	if (pStaticEdges != nullptr)
+		for (size_t i = 0; i < pStaticEdges->Size(); i++)
+			gather(*pStaticEdges, i);
+
+	// The dynamic edges are already in a grid, so only the cells near the light are looked at
+	if (pDynamicEdges != nullptr)
+		i_ForEachDynamicEdge(light, [&](const int i) { gather(pDynamicEdges->edges, (size_t)i); });
+
+	rayCaster2D.CalculateVisibilityPolygon(light.vecPos, light.occluders, light.poly, light.fRadius);
+
+	// Fill the fan in light texel space, texel centres sit on the half texels
+	const olc::vf2d vecOffset = { (float)light.vecTexelMin.x, (float)light.vecTexelMin.y };
+	auto toTexels = [&](const olc::vf2d& p) { return p / fTexelSize - vecOffset; };
+
+	const auto& vPoints = light.poly.vPoints;
+	for (size_t n = 1; n + 1 < vPoints.size(); n++)
+		i_FillTriangle(light, toTexels(vPoints[0]), toTexels(vPoints[n]), toTexels(vPoints[n + 1]));
+}
+
+void olcPGEX_LightMap2D::i_FillTriangle(sLight& light, olc::vf2d a, olc::vf2d b, olc::vf2d c)
+{
+	// Sort by y so each edge is always interpolated the same way round.  Neighbouring triangles of
+	// the fan then agree exactly on their shared edges, and no texel is filled twice or missed
+	if (b.y < a.y) std::swap(a, b);
+	if (c.y < a.y) std::swap(a, c);
+	if (c.y < b.y) std::swap(b, c);
+
+	auto edgeX = [](const olc::vf2d& p0, const olc::vf2d& p1, const float y) { return p0.x + (p1.x - p0.x) * (y - p0.y) / (p1.y - p0.y); };
+
+	const int nRowStart = std::max(0, (int)std::ceil(a.y - 0.5f));
+	const int nRowEnd = std::min(light.vecTexelSize.y, (int)std::ceil(c.y - 0.5f));
+
+	const olc::vf2d vecLightTexel = light.vecPos / (float)nTexelSize - olc::vf2d{ (float)light.vecTexelMin.x, (float)light.vecTexelMin.y };
+	const float fRadius = light.fRadius / (float)nTexelSize;
+	const float fInvRadius2 = 1.0f / (fRadius * fRadius);
+
+	for (int y = nRowStart; y < nRowEnd; y++)
+	{
+		// The long edge (a - c) spans every row, the other side is a - b or b - c
+		const float fY = (float)y + 0.5f;
+		float fX0 = edgeX(a, c, fY);
+		float fX1 = fY < b.y ? edgeX(a, b, fY) : edgeX(b, c, fY);
+		if (fX1 < fX0) std::swap(fX0, fX1);
+
+		const int nStart = std::max(0, (int)std::ceil(fX0 - 0.5f));
+		const int nEnd = std::min(light.vecTexelSize.x, (int)std::ceil(fX1 - 0.5f));
+
+		uint32_t* pRow = &light.vTexels[(size_t)y * light.vecTexelSize.x];
+		const float fDY2 = (fY - vecLightTexel.y) * (fY - vecLightTexel.y);
+
+		for (int x = nStart; x < nEnd; x++)
+		{
+			// Smooth fall off to nothing at the radius
+			const float fDX = (float)x + 0.5f - vecLightTexel.x;
+			const float fFalloff = 1.0f - (fDX * fDX + fDY2) * fInvRadius2;
+			if (fFalloff <= 0.0f)
+				continue;
+
+			const float fIntensity = fFalloff * fFalloff;
+			pRow[x] = olc::Pixel((uint8_t)(light.pColour.r * fIntensity), (uint8_t)(light.pColour.g * fIntensity), (uint8_t)(light.pColour.b * fIntensity), 0).n;
+		}
+	}
+}
+
+void olcPGEX_LightMap2D::i_AddRow(uint32_t* pDst, const uint32_t* pSrc, const int nCount)
+{
+	int i = 0;
+
+#if defined(OLC_PGEX_LIGHTMAP2D_SSE2)
+	// 4 pixels (16 channels) at a time, saturating at 255 so bright overlaps don't wrap around
+	for (; i + 4 <= nCount; i += 4)
+	{
+		const __m128i mDst = _mm_loadu_si128((const __m128i*)(pDst + i));
+		const __m128i mSrc = _mm_loadu_si128((const __m128i*)(pSrc + i));
+		_mm_storeu_si128((__m128i*)(pDst + i), _mm_adds_epu8(mDst, mSrc));
+	}
+#endif
+
+	for (; i < nCount; i++)
+	{
+		const uint8_t* pS = (const uint8_t*)(pSrc + i);
+		uint8_t* pD = (uint8_t*)(pDst + i);
+		for (int c = 0; c < 4; c++)
+			pD[c] = (uint8_t)std::min(255, pD[c] + pS[c]);
+	}
+}
+
+#endif			// Implementation Guard
+#endif			// Header Guard
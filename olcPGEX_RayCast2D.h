@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|         OneLoneCoder Pixel Game Engine Extension            |
-	|                   RayCast2D - v1.1                          |
+	|                   RayCast2D - v2.0                          |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -56,6 +56,179 @@
 	in many different ways to suit your own program.
 	
 	I hope this will be useful for others as it has been for me :-)
+
+
+
+	-----------------------
+	  v2.0 - NEW FEATURES
+	-----------------------
+
+	Added a batched ray versus edge set query.  Instead of calling
+	RayCastVsEdge for every edge in your level and tracking the closest
+	hit yourself, add your edges to an sEdgeSet once (usually at level
+	load) and let the ray caster find the closest hit for you...
+
+		olcPGEX_RayCast2D::sEdgeSet edges;
+		edges.AddEdge(vecWallEdgeStart, vecWallEdgeEnd);	// repeat for every edge
+
+		olcPGEX_RayCast2D::sRayHit hit;
+		if (rayCaster2D.RayCastVsEdgeSet(vecPlayerRayStart, vecPlayerRayEnd, edges, hit))
+		{
+			// hit.fDistance, hit.vecHit, hit.nEdgeIndex and hit.vecNormal
+			// describe the closest intersection along the ray
+		}
+
+	The edge set is stored as a Structure of Arrays (start x / y and
+	delta x / y per edge) so the intersection tests can be performed on
+	4 (SSE) or 8 (AVX) edges at a time.  The instruction set is chosen
+	at compile time from your compiler settings, and a scalar fallback
+	is used on all other platforms.  Define OLC_PGEX_RAYCAST2D_NO_SIMD
+	before including the header to force the scalar version.
+
+	The returned normal is the unit length edge normal facing back
+	towards the start of the ray.
+
+	For large static levels you can also build a uniform grid over the
+	edge set once at load time.  Ray queries then walk (DDA) only the
+	cells the ray passes through, and stop as soon as the closest hit
+	is confirmed...
+
+		olcPGEX_RayCast2D::sEdgeGrid grid;
+		rayCaster2D.BuildEdgeGrid(edges, grid);		// cell size is chosen for you, or pass your own
+
+		if (rayCaster2D.RayCastVsEdgeGrid(vecPlayerRayStart, vecPlayerRayEnd, grid, hit))
+		{
+			// same results as RayCastVsEdgeSet
+		}
+
+	The grid keeps a pointer to the edge set, so the edge set must
+	outlive the grid and be rebuilt if the edges change.  A benchmark
+	comparing both paths can be found in the RayCast2D_Benchmark folder.
+
+	Field of view and fog of war can be calculated with a visibility
+	polygon.  Rays are only cast towards the edge end points (plus a
+	tiny angle either side) so the cost depends on the number of edges
+	near the origin, not on a fixed number of rays...
+
+		olcPGEX_RayCast2D::sVisibilityPolygon fov;
+		rayCaster2D.CalculateVisibilityPolygon(vecEnemyPos, edges, fov, 300.0f, fFacingAngle - 0.5f, 1.0f);
+
+		rayCaster2D.DrawVisibilityPolygon(fov, olc::Pixel(255, 255, 0, 64), decalWHITE1x1);
+		bool bPlayerSeen = fov.Contains(vecPlayerPos);
+
+	The radius and angular range (start angle and range in radians) are
+	optional, leave them out for a full 360 degree view limited only by
+	the edges.  The polygon is stored as a triangle fan (origin first)
+	which can be drawn directly with DrawPolygonDecal.
+
+	Tile maps don't need four edges per solid tile.  Let the ray caster
+	extract just the outline of the solid areas instead, with internal
+	edges removed and straight runs merged into single edges...
+
+		olcPGEX_RayCast2D::sTileEdgeMap tileEdges;
+		rayCaster2D.BuildTileEdges(tileEdges, vecMapSize, { 32.0f, 32.0f }, levelTiles.data(), edges);
+
+	levelTiles is one byte per tile (row by row), anything non-zero is
+	solid.  When a tile changes at runtime, only the rows and columns
+	around it are extracted again...
+
+		rayCaster2D.SetTile(tileEdges, { 10, 4 }, false);		// destroy a wall
+		if (rayCaster2D.UpdateTileEdges(tileEdges, edges))
+			rayCaster2D.BuildEdgeGrid(edges, grid);			// only if you use a grid
+
+	Alternatively, skip the edges altogether and cast rays straight
+	through the tile grid.  Only the tiles the ray crosses are visited,
+	so the cost depends on the length of the ray, not the size of the
+	level.  The results use the same vecHit / fDistance form as
+	RayCastVsEdge, plus the tile that was hit and the face normal...
+
+		olc::vi2d vecTileHit;
+		olc::vf2d vecNormal;
+		if (rayCaster2D.RayCastVsTileGrid(vecPlayerRayStart, vecPlayerRayEnd, levelTiles.data(), vecMapSize, { 32.0f, 32.0f }, vecHitPosition, fHitDistance, vecTileHit, vecNormal))
+		{
+			// vecHitPosition is where the ray first enters a solid tile
+		}
+
+	Instead of a byte array you can pass any callable that takes a tile
+	x and y and returns true if it is solid (handy for infinite or
+	procedural maps).  The grid starts at world position 0, 0 and the
+	tile the ray starts in is never reported as a hit.
+
+	Circles, boxes and convex polygons don't need to be broken up into
+	edges either.  Each of these is a single closed form test using the
+	same vecHit / fDistance form as RayCastVsEdge, plus the surface
+	normal at the hit point...
+
+		rayCaster2D.RayCastVsCircle(vecRayStart, vecRayEnd, vecCenter, fRadius, vecHit, fDistance, vecNormal);
+		rayCaster2D.RayCastVsAABB(vecRayStart, vecRayEnd, vecRectPos, vecRectSize, vecHit, fDistance, vecNormal);
+		rayCaster2D.RayCastVsOBB(vecRayStart, vecRayEnd, vecCenter, vecHalfSize, fAngle, vecHit, fDistance, vecNormal);
+		rayCaster2D.RayCastVsConvexPolygon(vecRayStart, vecRayEnd, vPoints, vecHit, fDistance, vecNormal);
+
+	For fast moving objects there are also swept (continuous) tests
+	which find the time of impact during this frame's movement, so
+	bullets can't tunnel through thin walls however low the physics
+	step rate is.  vecVelocity is the distance moved this step, and
+	fTime is the normalised time of impact (0 - 1)...
+
+		if (rayCaster2D.SweptAABBVsAABB(vecPlayerPos, vecPlayerSize, vecVelocity * fElapsedTime, vecWallPos, vecWallSize, vecContactPos, fTime, vecNormal))
+			vecPlayerPos = vecContactPos;		// or slide along the normal etc...
+
+		rayCaster2D.SweptCircleVsCircle(vecBulletPos, fBulletRadius, vecBulletVelocity * fElapsedTime, vecTargetPos, fTargetRadius, vecContactPos, fTime, vecNormal);
+		rayCaster2D.SweptCircleVsEdge(vecBulletPos, fBulletRadius, vecBulletVelocity * fElapsedTime, vecWallEdgeStart, vecWallEdgeEnd, vecContactPos, fTime, vecNormal);
+
+	vecContactPos is where the moving object (top left corner for boxes,
+	center for circles) is at the moment of impact.  Rays that start
+	inside a shape do not report a hit, swept shapes that are already
+	touching report a hit at fTime 0.
+
+	When you have lots of rays to cast at once (line of sight for every
+	agent, a fan of rays for lighting) submit them as a batch.  If you
+	pass in an olcPGEX_ThreadPool the rays are shared between your CPU
+	cores...
+
+		std::vector<olcPGEX_RayCast2D::sRay> vRays;				// fill with start / end points
+		std::vector<olcPGEX_RayCast2D::sRayHit> vHits;			// one result per ray, same order
+
+		rayCaster2D.RayCastBatch(vRays, edges, vHits, &threadPool);
+		rayCaster2D.RayCastBatch(vRays, grid, vHits, &threadPool);	// or through a grid
+
+	The results are always identical to calling RayCastVsEdgeSet /
+	RayCastVsEdgeGrid per ray.
+	Leave out the thread pool to run the batch on the calling thread.
+
+	Doors, moving platforms and destructible walls belong in an
+	sDynamicEdgeSet instead.  Every edge gets an ID that stays the same
+	for as long as the edge exists, so you can move or remove it later.
+	The set keeps its own grid which is updated as edges change, only
+	touching the cells an edge has left or entered...
+
+		olcPGEX_RayCast2D::sDynamicEdgeSet dynamicEdges;
+		dynamicEdges.Init({ 0.0f, 0.0f }, vecLevelSize, 64.0f);		// area and cell size of the grid
+
+		int nDoorID = dynamicEdges.AddEdge(vecDoorStart, vecDoorEnd);
+		dynamicEdges.MoveEdge(nDoorID, vecDoorStart + vecOffset, vecDoorEnd + vecOffset);
+		dynamicEdges.RemoveEdge(nDoorID);						// the ID may be reused by a later AddEdge
+
+	Keep the level itself in a static sEdgeGrid and query both tiers at
+	once, so a mostly static level only pays for what has moved...
+
+		if (rayCaster2D.RayCastVsEdgeTiers(vecPlayerRayStart, vecPlayerRayEnd, grid, dynamicEdges, hit))
+		{
+			// hit.bDynamic tells you which tier was hit, hit.nEdgeIndex is
+			// the static edge index or the dynamic edge ID
+		}
+
+	RayCastVsDynamicEdges queries the dynamic tier on its own.  Edges
+	that stick out of the Init area still work, they are simply tested
+	by every ray, so keep the area large enough to cover your level.
+
+	BUG FIX: RayCastVsEdge used to skip any edge whose x or y delta was
+	the same as the ray's (an axis aligned ray against an axis aligned
+	wall for example) even though they may well cross.  It now only
+	rejects parallel edges, and uses exactly the same maths as the edge
+	set queries so the results always agree.  The fuzzer in the
+	RayCast2D_Benchmark folder checks every query against a high
+	precision reference if you want to see for yourself.
 		
 
 
@@ -103,13 +276,324 @@
 #define OLC_PGEX_RAYCAST2D
 
 #include "olcPixelGameEngine.h"
+#include "olcPGEX_ThreadPool.h"
+#include <limits>
+
+#if !defined(OLC_PGEX_RAYCAST2D_NO_SIMD)
+	#if defined(__AVX__)
+		#define OLC_PGEX_RAYCAST2D_AVX
+		#include <immintrin.h>
+	#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+		#define OLC_PGEX_RAYCAST2D_SSE
+		#include <xmmintrin.h>
+	#endif
+#endif
 
 class olcPGEX_RayCast2D : public olc::PGEX
 {
+public:
+	// Edges stored as a Structure of Arrays so they can be tested several at a time - v2.0
+	struct sEdgeSet
+	{
+		std::vector<float> vStartX;
+		std::vector<float> vStartY;
+		std::vector<float> vDeltaX;
+		std::vector<float> vDeltaY;
+
+		void AddEdge(const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd);
+		void Clear();
+		size_t Size() const { return vStartX.size(); }
+	};
+
+	// Uniform grid of edge indices for static edge sets, see BuildEdgeGrid - v2.0
+	struct sEdgeGrid
+	{
+		const sEdgeSet* pEdgeSet = nullptr;
+
+		olc::vf2d vecOrigin{};
+		olc::vf2d vecCellSize{ 1.0f, 1.0f };
+		olc::vi2d vecCells{};
+
+		std::vector<int> vCellStart;											// Offset into vCellEdges for each cell (one extra entry at the end)
+		std::vector<int> vCellEdges;											// Edge indices, grouped by cell
+	};
+
+	// Edges with stable IDs that can be added, removed and moved at runtime, indexed by their own grid - v2.0
+	struct sDynamicEdgeSet
+	{
+		sEdgeSet edges;															// Always packed, so the SIMD kernels can run straight over it
+		std::vector<int> vDenseToID;											// ID of each edge in edges
+		std::vector<int> vIDToDense;											// Index into edges for each ID, -1 if the ID is free
+		std::vector<int> vFreeIDs;
+
+		olc::vf2d vecOrigin{};
+		olc::vf2d vecCellSize{ 64.0f, 64.0f };
+		olc::vi2d vecCells{};
+
+		std::vector<std::vector<int>> vCells;									// Edge IDs listed in each cell
+		std::vector<int> vOutside;												// Edge IDs that leave the grid, tested by every ray
+		std::vector<olc::vi2d> vCellMin;										// Cells covered by each ID (inclusive), x = -1 if outside
+		std::vector<olc::vi2d> vCellMax;
+
+		void Init(const olc::vf2d vecWorldOrigin, const olc::vf2d vecWorldSize, const float fCellSize = 64.0f);
+		int AddEdge(const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd);
+		bool RemoveEdge(const int nID);
+		bool MoveEdge(const int nID, const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd);
+		bool IsValid(const int nID) const { return nID >= 0 && nID < (int)vIDToDense.size() && vIDToDense[nID] >= 0; }
+		void Clear();
+		size_t Size() const { return edges.Size(); }
+
+		void i_CellRange(const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd, olc::vi2d& vecMin, olc::vi2d& vecMax) const;
+		void i_Link(const int nID);
+		void i_Unlink(const int nID);
+	};
+
+	// Visibility polygon stored as a triangle fan, see CalculateVisibilityPolygon - v2.0
+	struct sVisibilityPolygon
+	{
+		olc::vf2d vecOrigin{};
+		std::vector<olc::vf2d> vPoints;											// Triangle fan, vPoints[0] is the origin
+		std::vector<float> vAngles;												// Angle of each point after the origin, relative to the start angle
+
+		float fRadius = 0.0f;
+		float fAngleStart = 0.0f;
+		bool bFullCircle = true;
+		int nArcSegments = 32;													// Rays used to round off the radius over a full circle
+
+		sEdgeSet localEdges;													// Scratch space reused between calculations
+
+		bool Contains(const olc::vf2d& point) const;
+	};
+
+	// Solid / empty tile grid and its merged outline edges, see BuildTileEdges - v2.0
+	struct sTileEdgeMap
+	{
+		olc::vi2d vecTiles{};
+		olc::vf2d vecTileSize{ 1.0f, 1.0f };
+		olc::vf2d vecOrigin{};
+
+		std::vector<uint8_t> vTiles;											// Non-zero is solid
+
+		// Merged runs (start and end tile) along each horizontal and vertical grid line
+		std::vector<std::vector<std::pair<int, int>>> vRowRuns;					// vecTiles.y + 1 lines
+		std::vector<std::vector<std::pair<int, int>>> vColumnRuns;				// vecTiles.x + 1 lines
+
+		bool bEdgesChanged = false;
+
+		bool IsSolid(const int x, const int y) const { return x >= 0 && y >= 0 && x < vecTiles.x && y < vecTiles.y && vTiles[y * vecTiles.x + x] != 0; }
+	};
+
+	// A single ray for the batch queries - v2.0
+	struct sRay
+	{
+		olc::vf2d vecStart{};
+		olc::vf2d vecEnd{};
+	};
+
+	// Closest hit information returned by the batched queries - v2.0
+	struct sRayHit
+	{
+		olc::vf2d vecHit{};
+		olc::vf2d vecNormal{};
+		float fDistance = 1.0f;											// Normalised distance along the ray (same as RayCastVsEdge)
+		int nEdgeIndex = -1;											// Index into the edge set, -1 if nothing was hit
+		bool bDynamic = false;											// True if nEdgeIndex is an sDynamicEdgeSet edge ID
+	};
+
 public:
 	bool RayCastVsEdge(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd, olc::vf2d& vecHit, float& fDistance);
+	bool RayCastVsEdgeSet(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sEdgeSet& edgeSet, sRayHit& hit);
+
+	void BuildEdgeGrid(const sEdgeSet& edgeSet, sEdgeGrid& grid, const float fCellSize = 0.0f);
+	bool RayCastVsEdgeGrid(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sEdgeGrid& grid, sRayHit& hit);
+
+	bool RayCastVsDynamicEdges(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sDynamicEdgeSet& dynamicEdges, sRayHit& hit);
+	bool RayCastVsEdgeTiers(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sEdgeGrid& staticGrid, const sDynamicEdgeSet& dynamicEdges, sRayHit& hit);
+
+	void RayCastBatch(const std::vector<sRay>& vRays, const sEdgeSet& edgeSet, std::vector<sRayHit>& vHits, olcPGEX_ThreadPool* pThreadPool = nullptr);
+	void RayCastBatch(const std::vector<sRay>& vRays, const sEdgeGrid& grid, std::vector<sRayHit>& vHits, olcPGEX_ThreadPool* pThreadPool = nullptr);
+
+	void CalculateVisibilityPolygon(const olc::vf2d vecOrigin, const sEdgeSet& edgeSet, sVisibilityPolygon& poly, const float fRadius = 0.0f, const float fAngleStart = 0.0f, const float fAngleRange = 6.2831853f);
+	void DrawVisibilityPolygon(const sVisibilityPolygon& poly, const olc::Pixel tint = olc::WHITE, olc::Decal* decal = nullptr);
+
+	void BuildTileEdges(sTileEdgeMap& tileMap, const olc::vi2d vecTiles, const olc::vf2d vecTileSize, const uint8_t* pTiles, sEdgeSet& edgeSet, const olc::vf2d vecOrigin = { 0.0f, 0.0f });
+	void SetTile(sTileEdgeMap& tileMap, const olc::vi2d vecTile, const bool bSolid);
+	bool UpdateTileEdges(sTileEdgeMap& tileMap, sEdgeSet& edgeSet);
+
+	bool RayCastVsCircle(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecCenter, const float fRadius, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal);
+	bool RayCastVsAABB(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecRectPos, const olc::vf2d vecRectSize, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal);
+	bool RayCastVsOBB(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecCenter, const olc::vf2d vecHalfSize, const float fAngle, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal);
+	bool RayCastVsConvexPolygon(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const std::vector<olc::vf2d>& vPoints, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal);
+
+	bool SweptAABBVsAABB(const olc::vf2d vecPos, const olc::vf2d vecSize, const olc::vf2d vecVelocity, const olc::vf2d vecTargetPos, const olc::vf2d vecTargetSize, olc::vf2d& vecContactPos, float& fTime, olc::vf2d& vecNormal);
+	bool SweptCircleVsCircle(const olc::vf2d vecPos, const float fRadius, const olc::vf2d vecVelocity, const olc::vf2d vecTargetPos, const float fTargetRadius, olc::vf2d& vecContactPos, float& fTime, olc::vf2d& vecNormal);
+	bool SweptCircleVsEdge(const olc::vf2d vecPos, const float fRadius, const olc::vf2d vecVelocity, const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd, olc::vf2d& vecContactPos, float& fTime, olc::vf2d& vecNormal);
+
+	template<typename IsSolidFunc>
+	bool RayCastVsTileGrid(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, IsSolidFunc&& isSolid, const olc::vf2d vecTileSize, olc::vf2d& vecHit, float& fDistance, olc::vi2d& vecTile, olc::vf2d& vecNormal);
+	bool RayCastVsTileGrid(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const uint8_t* pTiles, const olc::vi2d vecTiles, const olc::vf2d vecTileSize, olc::vf2d& vecHit, float& fDistance, olc::vi2d& vecTile, olc::vf2d& vecNormal);
+
+private:
+	static inline bool i_EdgeIntersection(const olc::vf2d& vecRayStart, const olc::vf2d& vecRayDistance, const sEdgeSet& edgeSet, const size_t nEdge, float& t1);
+	template<typename CellFunc>
+	static void i_WalkGrid(const olc::vf2d vecOrigin, const olc::vf2d vecCellSize, const olc::vi2d vecCells, const olc::vf2d vecStart, const olc::vf2d vecEnd, CellFunc&& cellFunc);
+
+	int i_ClosestDynamicEdge(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const sDynamicEdgeSet& dynamicEdges, float& fClosest);
+	int i_ClosestEdgeInRange(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const sEdgeSet& edgeSet, const size_t nBegin, const size_t nEnd, float& fClosest);
+	void i_FillHit(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const sEdgeSet& edgeSet, const int nEdgeIndex, const float fClosest, sRayHit& hit);
+	bool i_RayVsCircle(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const olc::vf2d vecCenter, const float fRadius, const float fMinT, float& t, olc::vf2d& vecNormal);
+	bool i_RayVsBox(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const olc::vf2d vecMin, const olc::vf2d vecMax, const float fMinT, float& t, olc::vf2d& vecNormal);
+	void i_ExtractRowRuns(sTileEdgeMap& tileMap, const int nRow);
+	void i_ExtractColumnRuns(sTileEdgeMap& tileMap, const int nColumn);
 };
 
+bool olcPGEX_RayCast2D::i_EdgeIntersection(const olc::vf2d& vecRayStart, const olc::vf2d& vecRayDistance, const sEdgeSet& edgeSet, const size_t nEdge, float& t1)
+{
+	const float fDX = edgeSet.vStartX[nEdge] - vecRayStart.x;
+	const float fDY = edgeSet.vStartY[nEdge] - vecRayStart.y;
+
+	const float fDenom = edgeSet.vDeltaX[nEdge] * vecRayDistance.y - edgeSet.vDeltaY[nEdge] * vecRayDistance.x;
+	if (fDenom == 0.0f)
+		return false;
+
+	const float fInvDenom = 1.0f / fDenom;
+	t1 = (fDY * edgeSet.vDeltaX[nEdge] - fDX * edgeSet.vDeltaY[nEdge]) * fInvDenom;
+	const float t2 = (vecRayDistance.x * fDY - vecRayDistance.y * fDX) * fInvDenom;
+
+	return t1 > 0.0f && t2 > 0.0f && t2 <= 1.0f;
+}
+
+// Visits every grid cell the segment passes through in order, calling cellFunc(cellIndex, tCellExit).
+// tCellExit is the normalised distance along the segment at which it leaves the cell.  Return
+// true from cellFunc to stop the walk early.
+template<typename CellFunc>
+void olcPGEX_RayCast2D::i_WalkGrid(const olc::vf2d vecOrigin, const olc::vf2d vecCellSize, const olc::vi2d vecCells, const olc::vf2d vecStart, const olc::vf2d vecEnd, CellFunc&& cellFunc)
+{
+	if (vecCells.x <= 0 || vecCells.y <= 0)
+		return;
+
+	// Work in cell units from here on
+	const olc::vf2d vecGridStart = (vecStart - vecOrigin) / vecCellSize;
+	const olc::vf2d vecGridDistance = (vecEnd - vecStart) / vecCellSize;
+
+	// Clip the segment to the grid bounds (slab test)
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+	const float fStart[2] = { vecGridStart.x, vecGridStart.y };
+	const float fDistance[2] = { vecGridDistance.x, vecGridDistance.y };
+	const float fCells[2] = { (float)vecCells.x, (float)vecCells.y };
+
+	for (int a = 0; a < 2; a++)
+	{
+		if (fDistance[a] == 0.0f)
+		{
+			if (fStart[a] < 0.0f || fStart[a] > fCells[a])
+				return;
+		}
+		else
+		{
+			float t0 = (0.0f - fStart[a]) / fDistance[a];
+			float t1 = (fCells[a] - fStart[a]) / fDistance[a];
+			if (t0 > t1) std::swap(t0, t1);
+			if (t0 > tEnter) tEnter = t0;
+			if (t1 < tExit) tExit = t1;
+		}
+	}
+
+	if (tEnter > tExit)
+		return;
+
+	// Starting cell, clamped in case the entry point sits exactly on the far boundary
+	const olc::vf2d vecEntry = vecGridStart + vecGridDistance * tEnter;
+	int nX = std::min(std::max((int)std::floor(vecEntry.x), 0), vecCells.x - 1);
+	int nY = std::min(std::max((int)std::floor(vecEntry.y), 0), vecCells.y - 1);
+
+	const int nStepX = vecGridDistance.x > 0.0f ? 1 : (vecGridDistance.x < 0.0f ? -1 : 0);
+	const int nStepY = vecGridDistance.y > 0.0f ? 1 : (vecGridDistance.y < 0.0f ? -1 : 0);
+
+	const float fInfinity = std::numeric_limits<float>::infinity();
+	const float tDeltaX = nStepX != 0 ? std::fabs(1.0f / vecGridDistance.x) : fInfinity;
+	const float tDeltaY = nStepY != 0 ? std::fabs(1.0f / vecGridDistance.y) : fInfinity;
+	float tMaxX = nStepX != 0 ? ((float)(nStepX > 0 ? nX + 1 : nX) - vecGridStart.x) / vecGridDistance.x : fInfinity;
+	float tMaxY = nStepY != 0 ? ((float)(nStepY > 0 ? nY + 1 : nY) - vecGridStart.y) / vecGridDistance.y : fInfinity;
+
+	while (true)
+	{
+		const float tCellExit = std::min(std::min(tMaxX, tMaxY), tExit);
+
+		if (cellFunc(nY * vecCells.x + nX, tCellExit) || tCellExit >= tExit)
+			return;
+
+		if (tMaxX < tMaxY)
+		{
+			nX += nStepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			nY += nStepY;
+			tMaxY += tDeltaY;
+		}
+
+		if (nX < 0 || nY < 0 || nX >= vecCells.x || nY >= vecCells.y)
+			return;
+	}
+}
+
+template<typename IsSolidFunc>
+bool olcPGEX_RayCast2D::RayCastVsTileGrid(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, IsSolidFunc&& isSolid, const olc::vf2d vecTileSize, olc::vf2d& vecHit, float& fDistance, olc::vi2d& vecTile, olc::vf2d& vecNormal)
+{
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+
+	// Walk the grid in tile units, t is the normalised distance along the ray
+	const olc::vf2d vecGridStart = vecRayStart / vecTileSize;
+	const olc::vf2d vecGridDistance = vecRayDistance / vecTileSize;
+
+	int nX = (int)std::floor(vecGridStart.x);
+	int nY = (int)std::floor(vecGridStart.y);
+
+	const int nStepX = vecGridDistance.x > 0.0f ? 1 : (vecGridDistance.x < 0.0f ? -1 : 0);
+	const int nStepY = vecGridDistance.y > 0.0f ? 1 : (vecGridDistance.y < 0.0f ? -1 : 0);
+
+	const float fInfinity = std::numeric_limits<float>::infinity();
+	const float tDeltaX = nStepX != 0 ? std::fabs(1.0f / vecGridDistance.x) : fInfinity;
+	const float tDeltaY = nStepY != 0 ? std::fabs(1.0f / vecGridDistance.y) : fInfinity;
+	float tMaxX = nStepX != 0 ? ((float)(nStepX > 0 ? nX + 1 : nX) - vecGridStart.x) / vecGridDistance.x : fInfinity;
+	float tMaxY = nStepY != 0 ? ((float)(nStepY > 0 ? nY + 1 : nY) - vecGridStart.y) / vecGridDistance.y : fInfinity;
+
+	while (true)
+	{
+		// Step into the next tile, remembering which face we crossed
+		float t = 0.0f;
+		if (tMaxX < tMaxY)
+		{
+			t = tMaxX;
+			nX += nStepX;
+			tMaxX += tDeltaX;
+			vecNormal = { (float)-nStepX, 0.0f };
+		}
+		else
+		{
+			t = tMaxY;
+			nY += nStepY;
+			tMaxY += tDeltaY;
+			vecNormal = { 0.0f, (float)-nStepY };
+		}
+
+		// Same bounds as RayCastVsEdge, the end of the ray is not a hit
+		if (!(t < 1.0f))
+			return false;
+
+		if (isSolid(nX, nY))
+		{
+			vecTile = { nX, nY };
+			vecHit = vecRayStart + vecRayDistance * t;
+			fDistance = t;
+			return true;
+		}
+	}
+}
+
 #ifdef OLC_PGEX_RAYCAST2D_IMPLEMENTATION
 #undef OLC_PGEX_RAYCAST2D_IMPLEMENTATION
 
@@ -117,14 +601,18 @@ bool olcPGEX_RayCast2D::RayCastVsEdge(const olc::vf2d vecRayStart, const olc::vf
 {
 	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
 	const olc::vf2d vecEdgeDistance = vecEdgeEnd - vecEdgeStart;
+	const olc::vf2d vecStartDistance = vecEdgeStart - vecRayStart;
 
-	// Test if the edges could possibly overlap given their start and end positions
-	// otherwise, no need to test further
-	if (fabs(vecEdgeDistance.x - vecRayDistance.x) > 0.0f && fabs(vecEdgeDistance.y - vecRayDistance.y) > 0.0f)
+	// Parallel (or zero length) edges can never cross, otherwise there is always an
+	// intersection somewhere along the infinite lines so no need to test further - v2.0
+	const float fDenom = vecEdgeDistance.x * vecRayDistance.y - vecEdgeDistance.y * vecRayDistance.x;
+	if (fDenom != 0.0f)
 	{
-		// Calculate the distance (normalised) along each ray to where the intersection point is
-		const float t2 = (vecRayDistance.x * (vecEdgeStart.y - vecRayStart.y) + (vecRayDistance.y * (vecRayStart.x - vecEdgeStart.x))) / (vecEdgeDistance.x * vecRayDistance.y - vecEdgeDistance.y * vecRayDistance.x);
-		const float t1 = (vecEdgeStart.x + vecEdgeDistance.x * t2 - vecRayStart.x) / vecRayDistance.x;
+		// Calculate the distance (normalised) along each ray to where the intersection point is.
+		// This is exactly the same maths as the edge set queries, so the results always agree
+		const float fInvDenom = 1.0f / fDenom;
+		const float t1 = (vecStartDistance.y * vecEdgeDistance.x - vecStartDistance.x * vecEdgeDistance.y) * fInvDenom;
+		const float t2 = (vecRayDistance.x * vecStartDistance.y - vecRayDistance.y * vecStartDistance.x) * fInvDenom;
 	
 		// If there is an intersection we need to record it
 		if (t1 > 0.0f && t1 < 1.0f && t2 > 0.0f && t2 <= 1.0f)
@@ -144,5 +632,1071 @@ bool olcPGEX_RayCast2D::RayCastVsEdge(const olc::vf2d vecRayStart, const olc::vf
 	return false;
 }
 
+void olcPGEX_RayCast2D::sEdgeSet::AddEdge(const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd)
+{
+	vStartX.push_back(vecEdgeStart.x);
+	vStartY.push_back(vecEdgeStart.y);
+	vDeltaX.push_back(vecEdgeEnd.x - vecEdgeStart.x);
+	vDeltaY.push_back(vecEdgeEnd.y - vecEdgeStart.y);
+}
+
+void olcPGEX_RayCast2D::sEdgeSet::Clear()
+{
+	vStartX.clear();
+	vStartY.clear();
+	vDeltaX.clear();
+	vDeltaY.clear();
+}
+
+bool olcPGEX_RayCast2D::RayCastVsEdgeSet(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sEdgeSet& edgeSet, sRayHit& hit)
+{
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+
+	// Anything at or beyond the end of the ray is not a hit, so start searching from there
+	float fClosest = 1.0f;
+	const int nClosestEdge = i_ClosestEdgeInRange(vecRayStart, vecRayDistance, edgeSet, 0, edgeSet.Size(), fClosest);
+
+	if (nClosestEdge < 0)
+	{
+		hit = sRayHit{};
+		return false;
+	}
+
+	i_FillHit(vecRayStart, vecRayDistance, edgeSet, nClosestEdge, fClosest, hit);
+	return true;
+}
+
+int olcPGEX_RayCast2D::i_ClosestEdgeInRange(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const sEdgeSet& edgeSet, const size_t nBegin, const size_t nEnd, float& fClosest)
+{
+	// For each edge (start S, delta E) and the ray (start O, delta R), with D = S - O
+	//
+	//		denominator	=	E.x * R.y - E.y * R.x
+	//		t1 (ray)	=	(D.y * E.x - D.x * E.y) * (1 / denominator)
+	//		t2 (edge)	=	(R.x * D.y - R.y * D.x) * (1 / denominator)
+	//
+	// A hit is valid if 0 < t1 < fClosest and 0 < t2 <= 1 (the same bounds RayCastVsEdge uses).
+	// Parallel edges give a zero denominator, which produces inf / nan and fails the comparisons.
+
+	int nClosestEdge = -1;
+	size_t i = nBegin;
+
+#if defined(OLC_PGEX_RAYCAST2D_AVX) || defined(OLC_PGEX_RAYCAST2D_SSE)
+	const float* pSX = edgeSet.vStartX.data();
+	const float* pSY = edgeSet.vStartY.data();
+	const float* pEX = edgeSet.vDeltaX.data();
+	const float* pEY = edgeSet.vDeltaY.data();
+#endif
+
+#if defined(OLC_PGEX_RAYCAST2D_AVX)
+	if (nEnd - i >= 8)
+	{
+		const __m256 mOX = _mm256_set1_ps(vecRayStart.x), mOY = _mm256_set1_ps(vecRayStart.y);
+		const __m256 mRX = _mm256_set1_ps(vecRayDistance.x), mRY = _mm256_set1_ps(vecRayDistance.y);
+		const __m256 mZero = _mm256_setzero_ps(), mOne = _mm256_set1_ps(1.0f), mEight = _mm256_set1_ps(8.0f);
+
+		__m256 mBestT = _mm256_set1_ps(fClosest);
+		__m256 mBestI = _mm256_set1_ps(-1.0f);
+		__m256 mIndex = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+		mIndex = _mm256_add_ps(mIndex, _mm256_set1_ps((float)i));
+
+		for (; i + 8 <= nEnd; i += 8)
+		{
+			const __m256 mEX = _mm256_loadu_ps(pEX + i), mEY = _mm256_loadu_ps(pEY + i);
+			const __m256 mDX = _mm256_sub_ps(_mm256_loadu_ps(pSX + i), mOX);
+			const __m256 mDY = _mm256_sub_ps(_mm256_loadu_ps(pSY + i), mOY);
+
+			const __m256 mDenom = _mm256_sub_ps(_mm256_mul_ps(mEX, mRY), _mm256_mul_ps(mEY, mRX));
+			const __m256 mInvDenom = _mm256_div_ps(mOne, mDenom);
+			const __m256 mT1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(mDY, mEX), _mm256_mul_ps(mDX, mEY)), mInvDenom);
+			const __m256 mT2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(mRX, mDY), _mm256_mul_ps(mRY, mDX)), mInvDenom);
+
+			__m256 mHit = _mm256_and_ps(_mm256_cmp_ps(mT1, mZero, _CMP_GT_OQ), _mm256_cmp_ps(mT1, mBestT, _CMP_LT_OQ));
+			mHit = _mm256_and_ps(mHit, _mm256_and_ps(_mm256_cmp_ps(mT2, mZero, _CMP_GT_OQ), _mm256_cmp_ps(mT2, mOne, _CMP_LE_OQ)));
+
+			mBestT = _mm256_blendv_ps(mBestT, mT1, mHit);
+			mBestI = _mm256_blendv_ps(mBestI, mIndex, mHit);
+			mIndex = _mm256_add_ps(mIndex, mEight);
+		}
+
+		alignas(32) float fLaneT[8];
+		alignas(32) float fLaneI[8];
+		_mm256_store_ps(fLaneT, mBestT);
+		_mm256_store_ps(fLaneI, mBestI);
+
+		for (int n = 0; n < 8; n++)
+			if (fLaneI[n] >= 0.0f && (fLaneT[n] < fClosest || (fLaneT[n] == fClosest && (int)fLaneI[n] < nClosestEdge)))
+			{
+				fClosest = fLaneT[n];
+				nClosestEdge = (int)fLaneI[n];
+			}
+	}
+#elif defined(OLC_PGEX_RAYCAST2D_SSE)
+	if (nEnd - i >= 4)
+	{
+		const __m128 mOX = _mm_set1_ps(vecRayStart.x), mOY = _mm_set1_ps(vecRayStart.y);
+		const __m128 mRX = _mm_set1_ps(vecRayDistance.x), mRY = _mm_set1_ps(vecRayDistance.y);
+		const __m128 mZero = _mm_setzero_ps(), mOne = _mm_set1_ps(1.0f), mFour = _mm_set1_ps(4.0f);
+
+		__m128 mBestT = _mm_set1_ps(fClosest);
+		__m128 mBestI = _mm_set1_ps(-1.0f);
+		__m128 mIndex = _mm_add_ps(_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f), _mm_set1_ps((float)i));
+
+		for (; i + 4 <= nEnd; i += 4)
+		{
+			const __m128 mEX = _mm_loadu_ps(pEX + i), mEY = _mm_loadu_ps(pEY + i);
+			const __m128 mDX = _mm_sub_ps(_mm_loadu_ps(pSX + i), mOX);
+			const __m128 mDY = _mm_sub_ps(_mm_loadu_ps(pSY + i), mOY);
+
+			const __m128 mDenom = _mm_sub_ps(_mm_mul_ps(mEX, mRY), _mm_mul_ps(mEY, mRX));
+			const __m128 mInvDenom = _mm_div_ps(mOne, mDenom);
+			const __m128 mT1 = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(mDY, mEX), _mm_mul_ps(mDX, mEY)), mInvDenom);
+			const __m128 mT2 = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(mRX, mDY), _mm_mul_ps(mRY, mDX)), mInvDenom);
+
+			__m128 mHit = _mm_and_ps(_mm_cmpgt_ps(mT1, mZero), _mm_cmplt_ps(mT1, mBestT));
+			mHit = _mm_and_ps(mHit, _mm_and_ps(_mm_cmpgt_ps(mT2, mZero), _mm_cmple_ps(mT2, mOne)));
+
+			// No blend in plain SSE, so select with and / andnot / or
+			mBestT = _mm_or_ps(_mm_and_ps(mHit, mT1), _mm_andnot_ps(mHit, mBestT));
+			mBestI = _mm_or_ps(_mm_and_ps(mHit, mIndex), _mm_andnot_ps(mHit, mBestI));
+			mIndex = _mm_add_ps(mIndex, mFour);
+		}
+
+		alignas(16) float fLaneT[4];
+		alignas(16) float fLaneI[4];
+		_mm_store_ps(fLaneT, mBestT);
+		_mm_store_ps(fLaneI, mBestI);
+
+		for (int n = 0; n < 4; n++)
+			if (fLaneI[n] >= 0.0f && (fLaneT[n] < fClosest || (fLaneT[n] == fClosest && (int)fLaneI[n] < nClosestEdge)))
+			{
+				fClosest = fLaneT[n];
+				nClosestEdge = (int)fLaneI[n];
+			}
+	}
+#endif
+
+	// Scalar fallback, also used for any edges left over after the SIMD loop
+	for (; i < nEnd; i++)
+	{
+		float t1 = 0.0f;
+		if (i_EdgeIntersection(vecRayStart, vecRayDistance, edgeSet, i, t1) && t1 < fClosest)
+		{
+			fClosest = t1;
+			nClosestEdge = (int)i;
+		}
+	}
+
+	return nClosestEdge;
+}
+
+void olcPGEX_RayCast2D::RayCastBatch(const std::vector<sRay>& vRays, const sEdgeSet& edgeSet, std::vector<sRayHit>& vHits, olcPGEX_ThreadPool* pThreadPool)
+{
+	vHits.resize(vRays.size());
+
+	// Each ray runs the single ray kernel (SIMD across the edges), which streams the edge set
+	// faster than packing rays into lanes and broadcasting every edge to them
+	auto traceRange = [&](const size_t nBegin, const size_t nEnd)
+	{
+		for (size_t r = nBegin; r < nEnd; r++)
+			RayCastVsEdgeSet(vRays[r].vecStart, vRays[r].vecEnd, edgeSet, vHits[r]);
+	};
+
+	if (pThreadPool != nullptr)
+		pThreadPool->ParallelFor(vRays.size(), 64, traceRange);
+	else
+		traceRange(0, vRays.size());
+}
+
+void olcPGEX_RayCast2D::RayCastBatch(const std::vector<sRay>& vRays, const sEdgeGrid& grid, std::vector<sRayHit>& vHits, olcPGEX_ThreadPool* pThreadPool)
+{
+	vHits.resize(vRays.size());
+
+	// Rays through a grid visit different cells, so they are traced one at a time
+	auto traceRange = [&](const size_t nBegin, const size_t nEnd)
+	{
+		for (size_t r = nBegin; r < nEnd; r++)
+			RayCastVsEdgeGrid(vRays[r].vecStart, vRays[r].vecEnd, grid, vHits[r]);
+	};
+
+	if (pThreadPool != nullptr)
+		pThreadPool->ParallelFor(vRays.size(), 64, traceRange);
+	else
+		traceRange(0, vRays.size());
+}
+
+void olcPGEX_RayCast2D::BuildEdgeGrid(const sEdgeSet& edgeSet, sEdgeGrid& grid, const float fCellSize)
+{
+	grid.pEdgeSet = &edgeSet;
+	grid.vCellStart.clear();
+	grid.vCellEdges.clear();
+	grid.vecCells = { 0, 0 };
+
+	const size_t nEdges = edgeSet.Size();
+	if (nEdges == 0)
+		return;
+
+	// Bounding box of every edge, padded slightly so nothing sits exactly on the outer boundary
+	olc::vf2d vecMin = { edgeSet.vStartX[0], edgeSet.vStartY[0] };
+	olc::vf2d vecMax = vecMin;
+	for (size_t i = 0; i < nEdges; i++)
+	{
+		const olc::vf2d vecStart = { edgeSet.vStartX[i], edgeSet.vStartY[i] };
+		const olc::vf2d vecEnd = vecStart + olc::vf2d{ edgeSet.vDeltaX[i], edgeSet.vDeltaY[i] };
+		vecMin = vecMin.min(vecStart).min(vecEnd);
+		vecMax = vecMax.max(vecStart).max(vecEnd);
+	}
+
+	const olc::vf2d vecPadding = { 1.0f, 1.0f };
+	vecMin -= vecPadding;
+	vecMax += vecPadding;
+	const olc::vf2d vecExtent = vecMax - vecMin;
+
+	// If no cell size is given, aim for roughly one edge per cell
+	float fSize = fCellSize;
+	if (fSize <= 0.0f)
+		fSize = std::sqrt(vecExtent.x * vecExtent.y / (float)nEdges);
+
+	// Keep the grid to a sensible size however the level is shaped
+	const int nMaxCellsPerAxis = 1024;
+	fSize = std::max(fSize, std::max(vecExtent.x, vecExtent.y) / (float)nMaxCellsPerAxis);
+
+	grid.vecOrigin = vecMin;
+	grid.vecCellSize = { fSize, fSize };
+	grid.vecCells = { std::max(1, (int)std::ceil(vecExtent.x / fSize)), std::max(1, (int)std::ceil(vecExtent.y / fSize)) };
+
+	// Two passes over the edges (count, then fill) to build a compact cell list
+	const int nCellCount = grid.vecCells.x * grid.vecCells.y;
+	grid.vCellStart.assign(nCellCount + 1, 0);
+
+	auto edgeStart = [&](const size_t i) { return olc::vf2d{ edgeSet.vStartX[i], edgeSet.vStartY[i] }; };
+	auto edgeEnd = [&](const size_t i) { return olc::vf2d{ edgeSet.vStartX[i] + edgeSet.vDeltaX[i], edgeSet.vStartY[i] + edgeSet.vDeltaY[i] }; };
+
+	for (size_t i = 0; i < nEdges; i++)
+		i_WalkGrid(grid.vecOrigin, grid.vecCellSize, grid.vecCells, edgeStart(i), edgeEnd(i), [&](const int nCell, const float) { grid.vCellStart[nCell + 1]++; return false; });
+
+	for (int c = 0; c < nCellCount; c++)
+		grid.vCellStart[c + 1] += grid.vCellStart[c];
+
+	grid.vCellEdges.resize(grid.vCellStart[nCellCount]);
+	std::vector<int> vFill(grid.vCellStart.begin(), grid.vCellStart.end() - 1);
+
+	for (size_t i = 0; i < nEdges; i++)
+		i_WalkGrid(grid.vecOrigin, grid.vecCellSize, grid.vecCells, edgeStart(i), edgeEnd(i), [&](const int nCell, const float) { grid.vCellEdges[vFill[nCell]++] = (int)i; return false; });
+}
+
+bool olcPGEX_RayCast2D::RayCastVsEdgeGrid(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sEdgeGrid& grid, sRayHit& hit)
+{
+	hit = sRayHit{};
+	if (grid.pEdgeSet == nullptr)
+		return false;
+
+	const sEdgeSet& edgeSet = *grid.pEdgeSet;
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+
+	float fClosest = 1.0f;
+	int nClosestEdge = -1;
+
+	i_WalkGrid(grid.vecOrigin, grid.vecCellSize, grid.vecCells, vecRayStart, vecRayEnd, [&](const int nCell, const float tCellExit)
+	{
+		for (int c = grid.vCellStart[nCell]; c < grid.vCellStart[nCell + 1]; c++)
+		{
+			// Long edges are listed in every cell they cross, ties are broken on the lowest
+			// edge index so the result always matches RayCastVsEdgeSet
+			const int nEdge = grid.vCellEdges[c];
+			float t1 = 0.0f;
+			if (i_EdgeIntersection(vecRayStart, vecRayDistance, edgeSet, nEdge, t1) && (t1 < fClosest || (t1 == fClosest && nEdge < nClosestEdge)))
+			{
+				fClosest = t1;
+				nClosestEdge = nEdge;
+			}
+		}
+
+		// An edge in this cell may be hit in a later cell, so only stop once the hit is inside this one
+		return nClosestEdge >= 0 && fClosest < tCellExit;
+	});
+
+	if (nClosestEdge < 0)
+		return false;
+
+	i_FillHit(vecRayStart, vecRayDistance, edgeSet, nClosestEdge, fClosest, hit);
+	return true;
+}
+
+void olcPGEX_RayCast2D::sDynamicEdgeSet::Init(const olc::vf2d vecWorldOrigin, const olc::vf2d vecWorldSize, const float fCellSize)
+{
+	vecOrigin = vecWorldOrigin;
+	vecCellSize = { fCellSize, fCellSize };
+	vecCells = { std::max(1, (int)std::ceil(vecWorldSize.x / fCellSize)), std::max(1, (int)std::ceil(vecWorldSize.y / fCellSize)) };
+
+	vCells.clear();
+	vCells.resize((size_t)vecCells.x * vecCells.y);
+	vOutside.clear();
+
+	// Anything added before Init is placed in the new grid
+	for (const int nID : vDenseToID)
+		i_Link(nID);
+}
+
+int olcPGEX_RayCast2D::sDynamicEdgeSet::AddEdge(const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd)
+{
+	int nID;
+	if (!vFreeIDs.empty())
+	{
+		nID = vFreeIDs.back();
+		vFreeIDs.pop_back();
+	}
+	else
+	{
+		nID = (int)vIDToDense.size();
+		vIDToDense.push_back(-1);
+		vCellMin.push_back({ -1, -1 });
+		vCellMax.push_back({ -1, -1 });
+	}
+
+	vIDToDense[nID] = (int)edges.Size();
+	vDenseToID.push_back(nID);
+	edges.AddEdge(vecEdgeStart, vecEdgeEnd);
+
+	i_Link(nID);
+	return nID;
+}
+
+bool olcPGEX_RayCast2D::sDynamicEdgeSet::RemoveEdge(const int nID)
+{
+	if (!IsValid(nID))
+		return false;
+
+	i_Unlink(nID);
+
+	// Keep the edges packed by moving the last edge into the gap
+	const int nDense = vIDToDense[nID];
+	const int nLast = (int)edges.Size() - 1;
+	if (nDense != nLast)
+	{
+		edges.vStartX[nDense] = edges.vStartX[nLast];
+		edges.vStartY[nDense] = edges.vStartY[nLast];
+		edges.vDeltaX[nDense] = edges.vDeltaX[nLast];
+		edges.vDeltaY[nDense] = edges.vDeltaY[nLast];
+		vDenseToID[nDense] = vDenseToID[nLast];
+		vIDToDense[vDenseToID[nDense]] = nDense;
+	}
+
+	edges.vStartX.pop_back();
+	edges.vStartY.pop_back();
+	edges.vDeltaX.pop_back();
+	edges.vDeltaY.pop_back();
+	vDenseToID.pop_back();
+
+	vIDToDense[nID] = -1;
+	vFreeIDs.push_back(nID);
+	return true;
+}
+
+bool olcPGEX_RayCast2D::sDynamicEdgeSet::MoveEdge(const int nID, const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd)
+{
+	if (!IsValid(nID))
+		return false;
+
+	// Most moves stay within the cells the edge already covers, so the grid needs no changes at all
+	olc::vi2d vecMin, vecMax;
+	i_CellRange(vecEdgeStart, vecEdgeEnd, vecMin, vecMax);
+	const bool bSameCells = vecMin == vCellMin[nID] && vecMax == vCellMax[nID];
+
+	if (!bSameCells)
+		i_Unlink(nID);
+
+	const int nDense = vIDToDense[nID];
+	edges.vStartX[nDense] = vecEdgeStart.x;
+	edges.vStartY[nDense] = vecEdgeStart.y;
+	edges.vDeltaX[nDense] = vecEdgeEnd.x - vecEdgeStart.x;
+	edges.vDeltaY[nDense] = vecEdgeEnd.y - vecEdgeStart.y;
+
+	if (!bSameCells)
+		i_Link(nID);
+
+	return true;
+}
+
+void olcPGEX_RayCast2D::sDynamicEdgeSet::Clear()
+{
+	edges.Clear();
+	vDenseToID.clear();
+	vIDToDense.clear();
+	vFreeIDs.clear();
+	vCellMin.clear();
+	vCellMax.clear();
+	vOutside.clear();
+	for (auto& cell : vCells)
+		cell.clear();
+}
+
+void olcPGEX_RayCast2D::sDynamicEdgeSet::i_CellRange(const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd, olc::vi2d& vecMin, olc::vi2d& vecMax) const
+{
+	// Cells covered by the edge's bounding box, or -1 if any of it is outside the grid
+	const olc::vf2d vecLow = (vecEdgeStart.min(vecEdgeEnd) - vecOrigin) / vecCellSize;
+	const olc::vf2d vecHigh = (vecEdgeStart.max(vecEdgeEnd) - vecOrigin) / vecCellSize;
+
+	if (!(vecLow.x >= 0.0f && vecLow.y >= 0.0f && vecHigh.x < (float)vecCells.x && vecHigh.y < (float)vecCells.y))
+	{
+		vecMin = { -1, -1 };
+		vecMax = { -1, -1 };
+		return;
+	}
+
+	vecMin = { (int)vecLow.x, (int)vecLow.y };
+	vecMax = { (int)vecHigh.x, (int)vecHigh.y };
+}
+
+void olcPGEX_RayCast2D::sDynamicEdgeSet::i_Link(const int nID)
+{
+	const int nDense = vIDToDense[nID];
+	const olc::vf2d vecStart = { edges.vStartX[nDense], edges.vStartY[nDense] };
+	const olc::vf2d vecEnd = vecStart + olc::vf2d{ edges.vDeltaX[nDense], edges.vDeltaY[nDense] };
+	i_CellRange(vecStart, vecEnd, vCellMin[nID], vCellMax[nID]);
+
+	if (vCellMin[nID].x < 0)
+	{
+		vOutside.push_back(nID);
+		return;
+	}
+
+	for (int y = vCellMin[nID].y; y <= vCellMax[nID].y; y++)
+		for (int x = vCellMin[nID].x; x <= vCellMax[nID].x; x++)
+			vCells[y * vecCells.x + x].push_back(nID);
+}
+
+void olcPGEX_RayCast2D::sDynamicEdgeSet::i_Unlink(const int nID)
+{
+	// Order within a cell doesn't matter, so swap the ID with the last one and pop it
+	auto erase = [nID](std::vector<int>& vList)
+	{
+		for (size_t i = 0; i < vList.size(); i++)
+			if (vList[i] == nID)
+			{
+				vList[i] = vList.back();
+				vList.pop_back();
+				return;
+			}
+	};
+
+	if (vCellMin[nID].x < 0)
+		erase(vOutside);
+	else
+	{
+		for (int y = vCellMin[nID].y; y <= vCellMax[nID].y; y++)
+			for (int x = vCellMin[nID].x; x <= vCellMax[nID].x; x++)
+				erase(vCells[y * vecCells.x + x]);
+	}
+
+	vCellMin[nID] = { -1, -1 };
+	vCellMax[nID] = { -1, -1 };
+}
+
+bool olcPGEX_RayCast2D::RayCastVsDynamicEdges(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sDynamicEdgeSet& dynamicEdges, sRayHit& hit)
+{
+	hit = sRayHit{};
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+
+	float fClosest = 1.0f;
+	const int nClosestEdge = i_ClosestDynamicEdge(vecRayStart, vecRayDistance, dynamicEdges, fClosest);
+	if (nClosestEdge < 0)
+		return false;
+
+	i_FillHit(vecRayStart, vecRayDistance, dynamicEdges.edges, nClosestEdge, fClosest, hit);
+	hit.nEdgeIndex = dynamicEdges.vDenseToID[nClosestEdge];
+	hit.bDynamic = true;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::RayCastVsEdgeTiers(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const sEdgeGrid& staticGrid, const sDynamicEdgeSet& dynamicEdges, sRayHit& hit)
+{
+	RayCastVsEdgeGrid(vecRayStart, vecRayEnd, staticGrid, hit);
+
+	// The dynamic tier only needs to find something closer than the static hit
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+	float fClosest = hit.fDistance;
+	const int nClosestEdge = i_ClosestDynamicEdge(vecRayStart, vecRayDistance, dynamicEdges, fClosest);
+
+	if (nClosestEdge >= 0)
+	{
+		i_FillHit(vecRayStart, vecRayDistance, dynamicEdges.edges, nClosestEdge, fClosest, hit);
+		hit.nEdgeIndex = dynamicEdges.vDenseToID[nClosestEdge];
+		hit.bDynamic = true;
+	}
+
+	return hit.nEdgeIndex >= 0;
+}
+
+int olcPGEX_RayCast2D::i_ClosestDynamicEdge(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const sDynamicEdgeSet& dynamicEdges, float& fClosest)
+{
+	const sEdgeSet& edgeSet = dynamicEdges.edges;
+	int nClosestEdge = -1;
+
+	// Ties are broken on the lowest ID so the result doesn't depend on the packed order
+	auto testEdge = [&](const int nID)
+	{
+		const int nDense = dynamicEdges.vIDToDense[nID];
+		float t1 = 0.0f;
+		if (i_EdgeIntersection(vecRayStart, vecRayDistance, edgeSet, nDense, t1)
+			&& (t1 < fClosest || (t1 == fClosest && nClosestEdge >= 0 && nID < dynamicEdges.vDenseToID[nClosestEdge])))
+		{
+			fClosest = t1;
+			nClosestEdge = nDense;
+		}
+	};
+
+	for (const int nID : dynamicEdges.vOutside)
+		testEdge(nID);
+
+	i_WalkGrid(dynamicEdges.vecOrigin, dynamicEdges.vecCellSize, dynamicEdges.vecCells, vecRayStart, vecRayStart + vecRayDistance, [&](const int nCell, const float tCellExit)
+	{
+		for (const int nID : dynamicEdges.vCells[nCell])
+			testEdge(nID);
+
+		// Same early out as the static grid, an edge in this cell may be hit in a later cell
+		return nClosestEdge >= 0 && fClosest < tCellExit;
+	});
+
+	return nClosestEdge;
+}
+
+void olcPGEX_RayCast2D::CalculateVisibilityPolygon(const olc::vf2d vecOrigin, const sEdgeSet& edgeSet, sVisibilityPolygon& poly, const float fRadius, const float fAngleStart, const float fAngleRange)
+{
+	const float fTwoPi = 6.2831853f;
+	const float fEpsilon = 0.0001f;
+
+	poly.vecOrigin = vecOrigin;
+	poly.fAngleStart = fAngleStart;
+	poly.bFullCircle = fAngleRange >= fTwoPi;
+	poly.vPoints.clear();
+	poly.vAngles.clear();
+	poly.localEdges.Clear();
+
+	auto edgeStart = [&](const size_t i) { return olc::vf2d{ edgeSet.vStartX[i], edgeSet.vStartY[i] }; };
+	auto edgeEnd = [&](const size_t i) { return olc::vf2d{ edgeSet.vStartX[i] + edgeSet.vDeltaX[i], edgeSet.vStartY[i] + edgeSet.vDeltaY[i] }; };
+
+	// Without a radius, reach just past the furthest end point so every edge can be seen
+	float fReach = fRadius;
+	if (fReach <= 0.0f)
+	{
+		for (size_t i = 0; i < edgeSet.Size(); i++)
+			fReach = std::max(fReach, std::max((edgeStart(i) - vecOrigin).mag2(), (edgeEnd(i) - vecOrigin).mag2()));
+
+		fReach = std::sqrt(fReach) * 1.01f + 1.0f;
+	}
+	poly.fRadius = fReach;
+
+	// Angle relative to the start of the view, wrapped into 0 -> 2pi
+	auto relativeAngle = [&](const float fAngle)
+	{
+		float fRelative = std::fmod(fAngle - fAngleStart, fTwoPi);
+		return fRelative < 0.0f ? fRelative + fTwoPi : fRelative;
+	};
+
+	auto addAngle = [&](const float fRelative)
+	{
+		if (poly.bFullCircle || (fRelative >= 0.0f && fRelative <= fAngleRange))
+			poly.vAngles.push_back(fRelative);
+	};
+
+	// Only edges that come within reach of the origin can block the view
+	for (size_t i = 0; i < edgeSet.Size(); i++)
+	{
+		const olc::vf2d vecStart = edgeStart(i);
+		const olc::vf2d vecDelta = { edgeSet.vDeltaX[i], edgeSet.vDeltaY[i] };
+		const float fLength2 = vecDelta.mag2();
+		const float t = fLength2 > 0.0f ? std::min(std::max((vecOrigin - vecStart).dot(vecDelta) / fLength2, 0.0f), 1.0f) : 0.0f;
+
+		if ((vecStart + vecDelta * t - vecOrigin).mag2() > fReach * fReach)
+			continue;
+
+		poly.localEdges.AddEdge(vecStart, vecStart + vecDelta);
+
+		for (const olc::vf2d& vecPoint : { vecStart, vecStart + vecDelta })
+		{
+			const float fRelative = relativeAngle(std::atan2(vecPoint.y - vecOrigin.y, vecPoint.x - vecOrigin.x));
+			addAngle(fRelative - fEpsilon);
+			addAngle(fRelative);
+			addAngle(fRelative + fEpsilon);
+		}
+	}
+
+	// Round off the outer radius and always include both sides of a limited view
+	const float fViewRange = poly.bFullCircle ? fTwoPi : fAngleRange;
+	const int nArcRays = std::max(2, (int)std::ceil(poly.nArcSegments * fViewRange / fTwoPi));
+	for (int n = 0; n <= nArcRays; n++)
+		addAngle(poly.bFullCircle && n == nArcRays ? 0.0f : fViewRange * (float)n / (float)nArcRays);
+
+	std::sort(poly.vAngles.begin(), poly.vAngles.end());
+	poly.vAngles.erase(std::unique(poly.vAngles.begin(), poly.vAngles.end()), poly.vAngles.end());
+
+	// Cast one ray per angle against the nearby edges only
+	poly.vPoints.reserve(poly.vAngles.size() + 2);
+	poly.vPoints.push_back(vecOrigin);
+
+	sRayHit hit;
+	for (const float fRelative : poly.vAngles)
+	{
+		const float fAngle = fAngleStart + fRelative;
+		const olc::vf2d vecRayEnd = vecOrigin + olc::vf2d{ std::cos(fAngle), std::sin(fAngle) } * fReach;
+
+		poly.vPoints.push_back(RayCastVsEdgeSet(vecOrigin, vecRayEnd, poly.localEdges, hit) ? hit.vecHit : vecRayEnd);
+	}
+
+	// Close the fan when looking all the way around
+	if (poly.bFullCircle && poly.vPoints.size() > 1)
+	{
+		poly.vPoints.push_back(poly.vPoints[1]);
+		poly.vAngles.push_back(poly.vAngles.front() + fTwoPi);
+	}
+}
+
+bool olcPGEX_RayCast2D::sVisibilityPolygon::Contains(const olc::vf2d& point) const
+{
+	if (vAngles.size() < 2)
+		return false;
+
+	const float fTwoPi = 6.2831853f;
+	float fRelative = std::fmod(std::atan2(point.y - vecOrigin.y, point.x - vecOrigin.x) - fAngleStart, fTwoPi);
+	if (fRelative < 0.0f) fRelative += fTwoPi;
+	if (bFullCircle && fRelative < vAngles.front()) fRelative += fTwoPi;
+
+	// Find the triangle of the fan that covers this angle (a point exactly on the last angle is in the last triangle)
+	auto it = std::upper_bound(vAngles.begin(), vAngles.end(), fRelative);
+	if (it == vAngles.end() && fRelative == vAngles.back())
+		--it;
+
+	if (it == vAngles.begin() || it == vAngles.end())
+		return false;
+
+	// vPoints is offset by one because the origin comes first
+	const size_t n = (size_t)(it - vAngles.begin());
+	const olc::vf2d& vecA = vPoints[n];
+	const olc::vf2d& vecB = vPoints[n + 1];
+
+	// Inside if the point is on the same side of the outer edge as the origin
+	return (vecB - vecA).cross(point - vecA) * (vecB - vecA).cross(vecOrigin - vecA) >= 0.0f;
+}
+
+void olcPGEX_RayCast2D::DrawVisibilityPolygon(const sVisibilityPolygon& poly, const olc::Pixel tint, olc::Decal* decal)
+{
+	if (poly.vPoints.size() < 3)
+		return;
+
+	if (decal != nullptr)
+	{
+		// The fan can go straight to the GPU as a single polygon
+		const std::vector<olc::vf2d> vUV(poly.vPoints.size(), olc::vf2d{ 0.0f, 0.0f });
+		pge->DrawPolygonDecal(decal, poly.vPoints, vUV, tint);
+	}
+	else
+	{
+		for (size_t n = 1; n + 1 < poly.vPoints.size(); n++)
+			pge->FillTriangle(poly.vPoints[0], poly.vPoints[n], poly.vPoints[n + 1], tint);
+	}
+}
+
+void olcPGEX_RayCast2D::BuildTileEdges(sTileEdgeMap& tileMap, const olc::vi2d vecTiles, const olc::vf2d vecTileSize, const uint8_t* pTiles, sEdgeSet& edgeSet, const olc::vf2d vecOrigin)
+{
+	tileMap.vecTiles = vecTiles;
+	tileMap.vecTileSize = vecTileSize;
+	tileMap.vecOrigin = vecOrigin;
+	tileMap.vTiles.assign(pTiles, pTiles + vecTiles.x * vecTiles.y);
+
+	tileMap.vRowRuns.assign(vecTiles.y + 1, {});
+	tileMap.vColumnRuns.assign(vecTiles.x + 1, {});
+
+	for (int y = 0; y <= vecTiles.y; y++)
+		i_ExtractRowRuns(tileMap, y);
+
+	for (int x = 0; x <= vecTiles.x; x++)
+		i_ExtractColumnRuns(tileMap, x);
+
+	tileMap.bEdgesChanged = true;
+	UpdateTileEdges(tileMap, edgeSet);
+}
+
+void olcPGEX_RayCast2D::SetTile(sTileEdgeMap& tileMap, const olc::vi2d vecTile, const bool bSolid)
+{
+	if (vecTile.x < 0 || vecTile.y < 0 || vecTile.x >= tileMap.vecTiles.x || vecTile.y >= tileMap.vecTiles.y)
+		return;
+
+	uint8_t& nTile = tileMap.vTiles[vecTile.y * tileMap.vecTiles.x + vecTile.x];
+	if ((nTile != 0) == bSolid)
+		return;
+
+	nTile = bSolid ? 1 : 0;
+
+	// A tile only touches the grid lines on each of its four sides
+	i_ExtractRowRuns(tileMap, vecTile.y);
+	i_ExtractRowRuns(tileMap, vecTile.y + 1);
+	i_ExtractColumnRuns(tileMap, vecTile.x);
+	i_ExtractColumnRuns(tileMap, vecTile.x + 1);
+
+	tileMap.bEdgesChanged = true;
+}
+
+bool olcPGEX_RayCast2D::UpdateTileEdges(sTileEdgeMap& tileMap, sEdgeSet& edgeSet)
+{
+	if (!tileMap.bEdgesChanged)
+		return false;
+
+	edgeSet.Clear();
+
+	for (int y = 0; y < (int)tileMap.vRowRuns.size(); y++)
+		for (const auto& run : tileMap.vRowRuns[y])
+			edgeSet.AddEdge(tileMap.vecOrigin + olc::vf2d{ (float)run.first, (float)y } * tileMap.vecTileSize,
+							tileMap.vecOrigin + olc::vf2d{ (float)run.second, (float)y } * tileMap.vecTileSize);
+
+	for (int x = 0; x < (int)tileMap.vColumnRuns.size(); x++)
+		for (const auto& run : tileMap.vColumnRuns[x])
+			edgeSet.AddEdge(tileMap.vecOrigin + olc::vf2d{ (float)x, (float)run.first } * tileMap.vecTileSize,
+							tileMap.vecOrigin + olc::vf2d{ (float)x, (float)run.second } * tileMap.vecTileSize);
+
+	tileMap.bEdgesChanged = false;
+	return true;
+}
+
+void olcPGEX_RayCast2D::i_ExtractRowRuns(sTileEdgeMap& tileMap, const int nRow)
+{
+	// The horizontal line at nRow separates tile row nRow - 1 from tile row nRow.  There is
+	// an edge wherever exactly one of the two tiles is solid, consecutive edges are merged.
+	auto& vRuns = tileMap.vRowRuns[nRow];
+	vRuns.clear();
+
+	int nRunStart = -1;
+	for (int x = 0; x <= tileMap.vecTiles.x; x++)
+	{
+		const bool bEdge = x < tileMap.vecTiles.x && tileMap.IsSolid(x, nRow - 1) != tileMap.IsSolid(x, nRow);
+
+		if (bEdge && nRunStart < 0)
+			nRunStart = x;
+		else if (!bEdge && nRunStart >= 0)
+		{
+			vRuns.push_back({ nRunStart, x });
+			nRunStart = -1;
+		}
+	}
+}
+
+void olcPGEX_RayCast2D::i_ExtractColumnRuns(sTileEdgeMap& tileMap, const int nColumn)
+{
+	// Same as above, for the vertical line between tile columns nColumn - 1 and nColumn
+	auto& vRuns = tileMap.vColumnRuns[nColumn];
+	vRuns.clear();
+
+	int nRunStart = -1;
+	for (int y = 0; y <= tileMap.vecTiles.y; y++)
+	{
+		const bool bEdge = y < tileMap.vecTiles.y && tileMap.IsSolid(nColumn - 1, y) != tileMap.IsSolid(nColumn, y);
+
+		if (bEdge && nRunStart < 0)
+			nRunStart = y;
+		else if (!bEdge && nRunStart >= 0)
+		{
+			vRuns.push_back({ nRunStart, y });
+			nRunStart = -1;
+		}
+	}
+}
+
+bool olcPGEX_RayCast2D::RayCastVsTileGrid(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const uint8_t* pTiles, const olc::vi2d vecTiles, const olc::vf2d vecTileSize, olc::vf2d& vecHit, float& fDistance, olc::vi2d& vecTile, olc::vf2d& vecNormal)
+{
+	return RayCastVsTileGrid(vecRayStart, vecRayEnd, [&](const int x, const int y)
+	{
+		return x >= 0 && y >= 0 && x < vecTiles.x && y < vecTiles.y && pTiles[y * vecTiles.x + x] != 0;
+	}, vecTileSize, vecHit, fDistance, vecTile, vecNormal);
+}
+
+bool olcPGEX_RayCast2D::RayCastVsCircle(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecCenter, const float fRadius, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal)
+{
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+
+	float t = 0.0f;
+	if (!i_RayVsCircle(vecRayStart, vecRayDistance, vecCenter, fRadius, 0.0f, t, vecNormal) || t <= 0.0f)
+		return false;
+
+	vecHit = vecRayStart + vecRayDistance * t;
+	fDistance = t;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::RayCastVsAABB(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecRectPos, const olc::vf2d vecRectSize, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal)
+{
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+
+	float t = 0.0f;
+	if (!i_RayVsBox(vecRayStart, vecRayDistance, vecRectPos, vecRectPos + vecRectSize, 0.0f, t, vecNormal) || t <= 0.0f)
+		return false;
+
+	vecHit = vecRayStart + vecRayDistance * t;
+	fDistance = t;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::RayCastVsOBB(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const olc::vf2d vecCenter, const olc::vf2d vecHalfSize, const float fAngle, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal)
+{
+	// Rotate the ray into the box's space, where the box is just an AABB around the origin
+	const float fCos = std::cos(fAngle);
+	const float fSin = std::sin(fAngle);
+	auto toLocal = [&](const olc::vf2d v) { return olc::vf2d{ v.x * fCos + v.y * fSin, -v.x * fSin + v.y * fCos }; };
+
+	const olc::vf2d vecLocalStart = toLocal(vecRayStart - vecCenter);
+	const olc::vf2d vecLocalDistance = toLocal(vecRayEnd - vecRayStart);
+
+	float t = 0.0f;
+	olc::vf2d vecLocalNormal;
+	if (!i_RayVsBox(vecLocalStart, vecLocalDistance, -vecHalfSize, vecHalfSize, 0.0f, t, vecLocalNormal) || t <= 0.0f)
+		return false;
+
+	vecNormal = { vecLocalNormal.x * fCos - vecLocalNormal.y * fSin, vecLocalNormal.x * fSin + vecLocalNormal.y * fCos };
+	vecHit = vecRayStart + (vecRayEnd - vecRayStart) * t;
+	fDistance = t;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::RayCastVsConvexPolygon(const olc::vf2d vecRayStart, const olc::vf2d vecRayEnd, const std::vector<olc::vf2d>& vPoints, olc::vf2d& vecHit, float& fDistance, olc::vf2d& vecNormal)
+{
+	const size_t nPoints = vPoints.size();
+	if (nPoints < 3)
+		return false;
+
+	const olc::vf2d vecRayDistance = vecRayEnd - vecRayStart;
+
+	// Clip the ray against the half plane of each side (Cyrus-Beck), works for either winding
+	const float fWinding = (vPoints[1] - vPoints[0]).cross(vPoints[2] - vPoints[1]) < 0.0f ? -1.0f : 1.0f;
+
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+	olc::vf2d vecEnterNormal{};
+
+	for (size_t i = 0; i < nPoints; i++)
+	{
+		const olc::vf2d& vecA = vPoints[i];
+		const olc::vf2d& vecB = vPoints[(i + 1) % nPoints];
+		const olc::vf2d vecOutward = olc::vf2d{ vecB.y - vecA.y, vecA.x - vecB.x } * fWinding;
+
+		const float fDenom = vecOutward.dot(vecRayDistance);
+		const float fNumer = vecOutward.dot(vecA - vecRayStart);
+
+		if (fDenom == 0.0f)
+		{
+			// Parallel to this side, outside it means no hit at all
+			if (fNumer < 0.0f)
+				return false;
+		}
+		else
+		{
+			const float t = fNumer / fDenom;
+			if (fDenom < 0.0f)
+			{
+				if (t > tEnter)
+				{
+					tEnter = t;
+					vecEnterNormal = vecOutward;
+				}
+			}
+			else if (t < tExit)
+				tExit = t;
+
+			if (tEnter > tExit)
+				return false;
+		}
+	}
+
+	// An entry normal is only set if the ray started outside the polygon
+	if (tEnter <= 0.0f || tEnter >= 1.0f || vecEnterNormal.mag2() == 0.0f)
+		return false;
+
+	vecNormal = vecEnterNormal.norm();
+	vecHit = vecRayStart + vecRayDistance * tEnter;
+	fDistance = tEnter;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::SweptAABBVsAABB(const olc::vf2d vecPos, const olc::vf2d vecSize, const olc::vf2d vecVelocity, const olc::vf2d vecTargetPos, const olc::vf2d vecTargetSize, olc::vf2d& vecContactPos, float& fTime, olc::vf2d& vecNormal)
+{
+	// Grow the target by the size of the moving box, then trace its top left corner as a ray
+	float t = 0.0f;
+	if (!i_RayVsBox(vecPos, vecVelocity, vecTargetPos - vecSize, vecTargetPos + vecTargetSize, -1.0f, t, vecNormal) || t < 0.0f)
+		return false;
+
+	vecContactPos = vecPos + vecVelocity * t;
+	fTime = t;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::SweptCircleVsCircle(const olc::vf2d vecPos, const float fRadius, const olc::vf2d vecVelocity, const olc::vf2d vecTargetPos, const float fTargetRadius, olc::vf2d& vecContactPos, float& fTime, olc::vf2d& vecNormal)
+{
+	// Grow the target by the moving circle's radius, then trace its center as a ray
+	float t = 0.0f;
+	if (!i_RayVsCircle(vecPos, vecVelocity, vecTargetPos, fRadius + fTargetRadius, -1.0f, t, vecNormal) || t < 0.0f)
+		return false;
+
+	vecContactPos = vecPos + vecVelocity * t;
+	fTime = t;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::SweptCircleVsEdge(const olc::vf2d vecPos, const float fRadius, const olc::vf2d vecVelocity, const olc::vf2d vecEdgeStart, const olc::vf2d vecEdgeEnd, olc::vf2d& vecContactPos, float& fTime, olc::vf2d& vecNormal)
+{
+	// The edge grown by the radius is a capsule: two offset sides and a circle at each end
+	float fClosest = 2.0f;
+	olc::vf2d vecClosestNormal{};
+
+	const olc::vf2d vecEdgeDistance = vecEdgeEnd - vecEdgeStart;
+	const float fEdgeLength2 = vecEdgeDistance.mag2();
+
+	// Already touching the edge is a hit at time 0, as long as we are moving towards it rather than away
+	const float fNearest = fEdgeLength2 > 0.0f ? std::min(std::max((vecPos - vecEdgeStart).dot(vecEdgeDistance) / fEdgeLength2, 0.0f), 1.0f) : 0.0f;
+	const olc::vf2d vecToEdge = vecEdgeStart + vecEdgeDistance * fNearest - vecPos;
+	if (vecToEdge.mag2() <= fRadius * fRadius && vecToEdge.dot(vecVelocity) > 0.0f)
+	{
+		vecContactPos = vecPos;
+		fTime = 0.0f;
+		vecNormal = -vecToEdge.norm();
+		return true;
+	}
+
+	if (fEdgeLength2 > 0.0f)
+	{
+		olc::vf2d vecSide = olc::vf2d{ -vecEdgeDistance.y, vecEdgeDistance.x }.norm();
+		if (vecSide.dot(vecVelocity) > 0.0f)
+			vecSide = -vecSide;
+
+		// Only the side facing the circle can be hit first
+		const olc::vf2d vecOffsetStart = vecEdgeStart + vecSide * fRadius;
+		const float fDenom = vecVelocity.dot(vecSide);
+		if (fDenom < 0.0f)
+		{
+			const float t = (vecOffsetStart - vecPos).dot(vecSide) / fDenom;
+			const float fAlong = (vecPos + vecVelocity * t - vecOffsetStart).dot(vecEdgeDistance) / fEdgeLength2;
+
+			if (t >= 0.0f && t <= 1.0f && fAlong >= 0.0f && fAlong <= 1.0f)
+			{
+				fClosest = t;
+				vecClosestNormal = vecSide;
+			}
+		}
+	}
+
+	for (const olc::vf2d& vecEnd : { vecEdgeStart, vecEdgeEnd })
+	{
+		float t = 0.0f;
+		olc::vf2d vecEndNormal;
+		if (i_RayVsCircle(vecPos, vecVelocity, vecEnd, fRadius, -1.0f, t, vecEndNormal) && t >= 0.0f && t < fClosest)
+		{
+			fClosest = t;
+			vecClosestNormal = vecEndNormal;
+		}
+	}
+
+	if (fClosest > 1.0f)
+		return false;
+
+	vecContactPos = vecPos + vecVelocity * fClosest;
+	fTime = fClosest;
+	vecNormal = vecClosestNormal;
+	return true;
+}
+
+bool olcPGEX_RayCast2D::i_RayVsCircle(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const olc::vf2d vecCenter, const float fRadius, const float fMinT, float& t, olc::vf2d& vecNormal)
+{
+	// Solve |start + distance * t - center| = radius for the first (entry) root
+	const olc::vf2d vecOffset = vecRayStart - vecCenter;
+	const float a = vecRayDistance.dot(vecRayDistance);
+	const float b = vecOffset.dot(vecRayDistance);
+	const float c = vecOffset.dot(vecOffset) - fRadius * fRadius;
+
+	if (a == 0.0f)
+		return false;
+
+	// b * b - a * c cancels badly for grazing rays, so measure how far inside the circle the closest approach is
+	const olc::vf2d vecClosest = vecOffset - vecRayDistance * (b / a);
+	const float fDiscriminant = a * (fRadius * fRadius - vecClosest.mag2());
+	if (fDiscriminant < 0.0f)
+		return false;
+
+	t = (-b - std::sqrt(fDiscriminant)) / a;
+
+	// Already overlapping counts as an immediate hit for swept tests (fMinT < 0) as long as we are not moving away
+	if (c <= 0.0f && fMinT < 0.0f && b < 0.0f)
+		t = 0.0f;
+
+	if (t < fMinT || t >= 1.0f)
+		return false;
+
+	vecNormal = (vecRayStart + vecRayDistance * t - vecCenter).norm();
+	return true;
+}
+
+bool olcPGEX_RayCast2D::i_RayVsBox(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const olc::vf2d vecMin, const olc::vf2d vecMax, const float fMinT, float& t, olc::vf2d& vecNormal)
+{
+	// Slab test, the last slab to be entered gives the entry time and normal
+	float tEnter = -std::numeric_limits<float>::infinity();
+	float tExit = std::numeric_limits<float>::infinity();
+
+	const float fStart[2] = { vecRayStart.x, vecRayStart.y };
+	const float fDistance[2] = { vecRayDistance.x, vecRayDistance.y };
+	const float fMin[2] = { vecMin.x, vecMin.y };
+	const float fMax[2] = { vecMax.x, vecMax.y };
+
+	for (int a = 0; a < 2; a++)
+	{
+		if (fDistance[a] == 0.0f)
+		{
+			if (fStart[a] < fMin[a] || fStart[a] > fMax[a])
+				return false;
+
+			continue;
+		}
+
+		float t0 = (fMin[a] - fStart[a]) / fDistance[a];
+		float t1 = (fMax[a] - fStart[a]) / fDistance[a];
+		if (t0 > t1) std::swap(t0, t1);
+
+		if (t0 > tEnter)
+		{
+			tEnter = t0;
+			vecNormal = a == 0 ? olc::vf2d{ fDistance[a] > 0.0f ? -1.0f : 1.0f, 0.0f } : olc::vf2d{ 0.0f, fDistance[a] > 0.0f ? -1.0f : 1.0f };
+		}
+		if (t1 < tExit)
+			tExit = t1;
+	}
+
+	// Entering after leaving, leaving before the start, or a ray with no length
+	if (tEnter > tExit || tExit <= 0.0f || tEnter == -std::numeric_limits<float>::infinity())
+		return false;
+
+	// Swept boxes that are already touching (fMinT < 0) are a hit at time 0, as long as we are moving in towards
+	// the middle of the box rather than out of it (otherwise an overlapping box could never get free)
+	if (tEnter < 0.0f && fMinT < 0.0f)
+	{
+		if (vecRayDistance.dot((vecMin + vecMax) * 0.5f - vecRayStart) <= 0.0f)
+			return false;
+
+		tEnter = 0.0f;
+	}
+
+	if (tEnter < fMinT || tEnter >= 1.0f)
+		return false;
+
+	t = tEnter;
+	return true;
+}
+
+void olcPGEX_RayCast2D::i_FillHit(const olc::vf2d vecRayStart, const olc::vf2d vecRayDistance, const sEdgeSet& edgeSet, const int nEdgeIndex, const float fClosest, sRayHit& hit)
+{
+	hit.fDistance = fClosest;
+	hit.nEdgeIndex = nEdgeIndex;
+	hit.vecHit = vecRayStart + vecRayDistance * fClosest;
+
+	// Only the winning edge needs a normal, so it is calculated once here rather than per edge
+	const olc::vf2d vecEdgeDistance = { edgeSet.vDeltaX[nEdgeIndex], edgeSet.vDeltaY[nEdgeIndex] };
+	hit.vecNormal = olc::vf2d{ -vecEdgeDistance.y, vecEdgeDistance.x }.norm();
+	if (hit.vecNormal.dot(vecRayDistance) > 0.0f)
+		hit.vecNormal = -hit.vecNormal;
+}
+
 #endif			// Implementation Guard
 #endif			// Header Guard
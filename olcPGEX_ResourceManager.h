@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|         OneLoneCoder Pixel Game Engine Extension            |
-	|                ResourceManager - v1.2				          |
+	|                ResourceManager - v1.3				          |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -108,6 +108,29 @@
 
 
 
+	-----------------------
+	  v1.3 - NEW FEATURES
+	-----------------------
+
+	Sprites can be loaded in the background on an olcPGEX_ThreadPool, so
+	a level's images load while a transition or loading screen plays
+	rather than freezing the game...
+
+			rm.RM_PreloadSprite("level2_tiles.png", &threadPool);
+			rm.RM_PreloadSprite(IMG_BOSS, "boss.png", &threadPool);
+
+	Only the image file is loaded on the worker, decals have to be made on
+	the main thread.  So once a frame call...
+
+			int nStillLoading = rm.RM_UpdatePreloads();
+
+	... which turns any finished sprites into normal resources (with their
+	decals) and tells you how many are still loading.  If you ask for a
+	sprite with RM_Sprite while it is still loading, RM_Sprite waits for
+	it rather than loading it a second time.
+
+
+
 	Hopefully this quick explanation and example code should be sufficient
 	for most users to get this PGEX working without too much effort.
 
@@ -153,6 +176,7 @@
 */
 #pragma once
 #include "olcPixelGameEngine.h"
+#include "olcPGEX_ThreadPool.h"
 
 #ifndef OLC_PGEX_RESOURCE_MANAGER
 #define OLC_PGEX_RESOURCE_MANAGER
@@ -168,9 +192,24 @@ private:
 		int ID = -1;
 	};
 
+	// A sprite being loaded on a worker, shared with the job so the job never outlives it
+	struct spritePreload
+	{
+		olc::Sprite* spr = nullptr;
+		std::string fileName = "";
+		int ID = -1;
+		std::atomic<bool> bLoaded{ false };
+
+		// So i_FinishPreload can sleep until the job is done
+		std::mutex muxLoaded;
+		std::condition_variable cvLoaded;
+	};
+
 	std::vector<spriteResource> resSprites;
-	bool i_NewSpriteResource(spriteResource& sprRes, const std::string& sprFileName);
+	std::vector<std::shared_ptr<spritePreload>> resPreloads;
+	bool i_NewSpriteResource(spriteResource& sprRes, const std::string& sprFileName, olc::Sprite* preloadedSprite = nullptr);
 	bool i_UnloadSpriteData(spriteResource& sprRes);
+	void i_FinishPreload(const std::string& sprFileName, const int fileNameID);
 
 public:
 	std::string strError = "";																// Should always be "", if not - you have an error (check the console log)
@@ -180,14 +219,19 @@ public:
 
 	void RM_FreeSpriteData(const std::string& spriteFileName); 								// Locate a Sprite Resource by File Name and delete its Sprite Data (Will invalidate existing Sprite References, use with caution)
 	void RM_FreeSpriteData(const int fileNameID);											// Locate a Sprite Resource by ID and delete its Sprite Data (Will invalidate existing Sprite References, use with caution)
+
+	void RM_PreloadSprite(const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool);					// Start loading a sprite on the thread pool, it becomes a normal resource in RM_UpdatePreloads
+	void RM_PreloadSprite(const int fileNameID, const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool);		// As above but with an ID
+	int RM_UpdatePreloads();																// Call once a frame on the main thread, returns the number of sprites still loading
+	int RM_PreloadsPending() const { return (int)resPreloads.size(); }						// Sprites still loading (or loaded but waiting for RM_UpdatePreloads)
 };
 
 #ifdef OLC_PGEX_RESOURCE_MANAGER_IMPLEMENTATION
 #undef OLC_PGEX_RESOURCE_MANAGER_IMPLEMENTATION
 
-bool olcPGEX_ResourceManager::i_NewSpriteResource(spriteResource& sprRes, const std::string& sprFileName)
+bool olcPGEX_ResourceManager::i_NewSpriteResource(spriteResource& sprRes, const std::string& sprFileName, olc::Sprite* preloadedSprite)
 {
-	sprRes.spr = new olc::Sprite(sprFileName);
+	sprRes.spr = preloadedSprite != nullptr ? preloadedSprite : new olc::Sprite(sprFileName);
 	sprRes.dec = new olc::Decal(sprRes.spr);
 	sprRes.fileName = sprFileName;
 	if (sprRes.ID == -1)
@@ -217,6 +261,7 @@ bool olcPGEX_ResourceManager::i_UnloadSpriteData(spriteResource& sprRes)
 olc::Decal* olcPGEX_ResourceManager::RM_Sprite(const std::string& spriteFileName)
 {
 	strError = "";
+	i_FinishPreload(spriteFileName, -1);
 
 	for (auto& s : resSprites)
 		if (s.fileName == spriteFileName)
@@ -233,6 +278,7 @@ olc::Decal* olcPGEX_ResourceManager::RM_Sprite(const std::string& spriteFileName
 olc::Decal* olcPGEX_ResourceManager::RM_Sprite(const int fileNameID, const std::string& spriteFileName)
 {
 	strError = "";
+	i_FinishPreload(spriteFileName, fileNameID);
 
 	if (spriteFileName != "")
 	{
@@ -293,6 +339,86 @@ void olcPGEX_ResourceManager::RM_FreeSpriteData(const int fileNameID)
 	strError = "ERROR: RM_FreeSpriteData - Sprite ID Not Found";
 }
 
+void olcPGEX_ResourceManager::RM_PreloadSprite(const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool)
+{
+	RM_PreloadSprite(-1, spriteFileName, threadPool);
+}
+
+void olcPGEX_ResourceManager::RM_PreloadSprite(const int fileNameID, const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool)
+{
+	strError = "";
+
+	// Already loaded, or already on its way
+	for (auto& s : resSprites)
+		if (s.fileName == spriteFileName)
+			return;
+
+	for (auto& p : resPreloads)
+		if (p->fileName == spriteFileName)
+			return;
+
+	auto preload = std::make_shared<spritePreload>();
+	preload->fileName = spriteFileName;
+	preload->ID = fileNameID;
+	resPreloads.push_back(preload);
+
+	// Only the file is loaded on the worker, nothing here touches the renderer
+	auto job = [preload]()
+	{
+		preload->spr = new olc::Sprite(preload->fileName);
+		{
+			std::lock_guard<std::mutex> lock(preload->muxLoaded);
+			preload->bLoaded = true;
+		}
+		preload->cvLoaded.notify_all();
+	};
+
+	if (threadPool != nullptr)
+		threadPool->AddJob(job);
+	else
+		job();
+}
+
+int olcPGEX_ResourceManager::RM_UpdatePreloads()
+{
+	for (size_t i = 0; i < resPreloads.size(); )
+	{
+		if (!resPreloads[i]->bLoaded)
+		{
+			i++;
+			continue;
+		}
+
+		// Finished, so it becomes a normal resource (decals can only be made on the main thread)
+		auto preload = resPreloads[i];
+		resPreloads.erase(resPreloads.begin() + i);
+
+		spriteResource resCurrentSprite{};
+		resCurrentSprite.ID = preload->ID;
+		if (!i_NewSpriteResource(resCurrentSprite, preload->fileName, preload->spr))
+			strError = "ERROR: RM_UpdatePreloads - Sprite data was empty...";
+	}
+
+	return (int)resPreloads.size();
+}
+
+void olcPGEX_ResourceManager::i_FinishPreload(const std::string& sprFileName, const int fileNameID)
+{
+	for (auto& p : resPreloads)
+		if ((sprFileName != "" && p->fileName == sprFileName) || (fileNameID != -1 && p->ID == fileNameID))
+		{
+			// Asked for before it finished loading, so wait for it rather than loading it twice.  The lock is
+			// let go first, RM_UpdatePreloads may destroy the preload (and its mutex)
+			{
+				std::unique_lock<std::mutex> lock(p->muxLoaded);
+				p->cvLoaded.wait(lock, [&p] { return p->bLoaded.load(); });
+			}
+
+			RM_UpdatePreloads();
+			return;
+		}
+}
+
 #endif // Implementation Guard
 #endif // Header Guard
 
@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|         OneLoneCoder Pixel Game Engine Extension            |
-	|                  Scrolling Tile - v1.1                      |
+	|                  Scrolling Tile - v1.2                      |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -26,6 +26,67 @@
 	That's it... Enjoy.
 
 
+	v1.2 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+
+	Drawing one decal per tile gets expensive with small tiles on a big
+	window (32 x 32 tiles at 1920 x 1080 is over 2000 decals a frame
+	just for the background).  Switch to one of the single draw modes
+	and the whole background is drawn as one quad, however many tiles
+	are on screen...
+
+		tileBackground.SetDrawMode(olcPGEX_ScrollingTile::DrawMode::CACHED_STRIP);
+
+	CACHED_STRIP builds a decal the size of the screen plus one tile
+	with the tile already repeated across it (once, the first time it
+	is drawn) and just slides it around as the camera moves.  Works
+	everywhere, costs a screen plus one tile sized sprite and texture
+	of memory (about 9MB for 1920 x 1080 with 256 x 256 tiles).  The
+	strip is copied a row at a time, but it is still a texture upload
+	on the frame it is built, so draw once during loading if that
+	first frame matters.
+
+	REPEAT draws one quad straight from a second decal of your tile
+	image that wraps around rather than clamping at its edges, so
+	there is no extra memory at all.  Your tile image must be exactly
+	the tile size, and on web builds (WebGL 1) its width and height
+	must also be powers of 2 or the tiles won't wrap.
+
+	An alternative tile can also be given and swapped in at any time...
+
+		tileBackground.SetTileValues(camera.vecCamViewSize, { 256, 256 }, decalDay, decalNight);
+		tileBackground.bShowAltTile = true;
+
+	BUG FIX - Negative camera positions no longer shift the tiles by a
+	tile (the C++ % operator keeps the sign of a negative number).
+
+	Parallax backgrounds (sky, far hills, near hills...) are made with
+	a layer stack rather than lots of separate scrolling tiles.  Add the
+	layers from the back to the front...
+
+		olcPGEX_ParallaxStack parallax;
+		parallax.SetScreenSize(camera.vecCamViewSize);
+
+		parallax.AddLayer(decalSky, { 0.0f, 0.0f });					// never moves
+		parallax.AddLayer(decalFarHills, { 0.25f, 0.1f }, true, false);	// repeats across, not down
+		parallax.AddLayer(decalNearHills, { 0.6f, 0.3f }, true, false);
+
+	... and draw them all with one call...
+
+		parallax.DrawAllLayers(camera.vecCamPos);
+
+	Each layer is one draw (using the same draw modes as above, cached
+	strips by default) so the cost never depends on the image sizes.
+	vLayers can be changed at any time to adjust a layer's decal,
+	offset, scroll factor, repeat flags or tint, or to disable it, and
+	layers can be added or erased freely.  The cached strips belong to
+	the stack, one per layer, and are rebuilt or freed as needed.
+
+	Layers hidden behind a layer in front that has no transparent
+	pixels and covers the whole screen are skipped altogether.
+	nLayersDrawn and nLayersSkipped show how many of each last frame.
+
+
 	License (OLC-3)
 	~~~~~~~~~~~~~~~
 
@@ -70,10 +131,43 @@
 
 #pragma once
 #include "olcPixelGameEngine.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 class olcPGEX_ScrollingTile : public olc::PGEX
 {
+public:
+	olcPGEX_ScrollingTile() = default;
+	inline ~olcPGEX_ScrollingTile();
+
+	olcPGEX_ScrollingTile(const olcPGEX_ScrollingTile&) = delete;
+	olcPGEX_ScrollingTile& operator=(const olcPGEX_ScrollingTile&) = delete;
+
+	enum class DrawMode
+	{
+		PER_TILE,			// One decal per tile (original behaviour)
+		CACHED_STRIP,		// One decal, pre-tiled to the screen size plus a tile
+		REPEAT				// One quad sampled from a wrapping copy of the tile
+	};
+
+	bool bShowAltTile = false;
+
+	// Fills sprTarget with sprTile repeated every tileSize pixels, a row at a time (any
+	// part of a tile outside the image is left blank, just as GetPixel() would return)
+	static inline void RepeatSprite(const olc::Sprite* sprTile, const olc::vi2d tileSize, olc::Sprite* sprTarget);
+
 private:
+	// The single draw modes keep their own decal for each tile image, built when first needed
+	struct sTileCache
+	{
+		olc::Decal* decSource = nullptr;
+		olc::Sprite* sprCache = nullptr;
+		olc::Decal* decCache = nullptr;
+	};
+
 	olc::vi2d vecScreenSize{};
 	olc::vi2d vecTileSize{};
 	olc::vi2d vecTilesToDraw{};
@@ -81,44 +175,368 @@ private:
 	olc::vi2d vecCurrentOffset{};
 
 	olc::Decal* decTile = nullptr;
+	olc::Decal* decAltTile = nullptr;
+
+	DrawMode drawMode = DrawMode::PER_TILE;
+	sTileCache cache[2];
 
-	inline void DrawSingleTile(const olc::vi2d screenPos);
+	inline void DrawSingleTile(const olc::vi2d screenPos, olc::Decal* decal);
+	inline void i_ClearCache(sTileCache& tileCache);
+	inline olc::Decal* i_GetCachedDecal(sTileCache& tileCache, olc::Decal* decal);
 
 public:
-	inline void SetTileValues(const olc::vi2d screenSize, const olc::vi2d tileSize, olc::Decal* decal);
+	inline void SetTileValues(const olc::vi2d screenSize, const olc::vi2d tileSize, olc::Decal* decal, olc::Decal* altDecal = nullptr);
+	inline void SetDrawMode(const DrawMode mode);
 	inline void DrawAllTiles(const olc::vf2d camPos);
 };
 
 
-void olcPGEX_ScrollingTile::SetTileValues(const olc::vi2d screenSize, const olc::vi2d tileSize, olc::Decal* decal)
+olcPGEX_ScrollingTile::~olcPGEX_ScrollingTile()
+{
+	i_ClearCache(cache[0]);
+	i_ClearCache(cache[1]);
+}
+
+void olcPGEX_ScrollingTile::SetTileValues(const olc::vi2d screenSize, const olc::vi2d tileSize, olc::Decal* decal, olc::Decal* altDecal)
 {
 	vecScreenSize = screenSize;
 	vecTileSize = tileSize;
 	decTile = decal;
+	decAltTile = altDecal;
+
+	// Enough tiles to cover the screen however far the tiles are offset
+	vecTilesToDraw = ((vecScreenSize + vecTileSize - olc::vi2d(1, 1)) / vecTileSize) + olc::vi2d(1, 1);
+
+	// Sizes may have changed, so the cached decals are rebuilt next time they are drawn
+	i_ClearCache(cache[0]);
+	i_ClearCache(cache[1]);
+}
 
-	vecTilesToDraw = (vecScreenSize / vecTileSize) + olc::vi2d(1, 1);
+void olcPGEX_ScrollingTile::SetDrawMode(const DrawMode mode)
+{
+	if (drawMode == mode)
+		return;
+
+	drawMode = mode;
+	i_ClearCache(cache[0]);
+	i_ClearCache(cache[1]);
+}
+
+void olcPGEX_ScrollingTile::i_ClearCache(sTileCache& tileCache)
+{
+	delete tileCache.decCache;
+	delete tileCache.sprCache;
+	tileCache = sTileCache{};
 }
 
-void olcPGEX_ScrollingTile::DrawSingleTile(const olc::vi2d screenPos)
+olc::Decal* olcPGEX_ScrollingTile::i_GetCachedDecal(sTileCache& tileCache, olc::Decal* decal)
 {
-	pge->DrawDecal(screenPos, decTile);
+	if (tileCache.decSource == decal && tileCache.decCache != nullptr)
+		return tileCache.decCache;
+
+	i_ClearCache(tileCache);
+	tileCache.decSource = decal;
+
+	if (drawMode == DrawMode::REPEAT)
+	{
+		// Same image, but wrapping at its edges instead of clamping (the sprite still belongs to the caller)
+		tileCache.decCache = new olc::Decal(decal->sprite, false, false);
+		return tileCache.decCache;
+	}
+
+	// Tile the image across a sprite one tile bigger than the screen, exactly as
+	// the per tile mode would draw it (any part of a tile outside its image is blank)
+	const olc::Sprite* sprTile = decal->sprite;
+	const olc::vi2d vecCacheSize = vecTilesToDraw * vecTileSize;
+	tileCache.sprCache = new olc::Sprite(vecCacheSize.x, vecCacheSize.y);
+	RepeatSprite(sprTile, vecTileSize, tileCache.sprCache);
+
+	tileCache.decCache = new olc::Decal(tileCache.sprCache);
+	return tileCache.decCache;
+}
+
+void olcPGEX_ScrollingTile::RepeatSprite(const olc::Sprite* sprTile, const olc::vi2d tileSize, olc::Sprite* sprTarget)
+{
+	const int nCopyWidth = std::min(tileSize.x, sprTile->width);
+
+	// The first tile high band comes from the image itself...
+	for (int y = 0; y < std::min(tileSize.y, sprTarget->height); y++)
+	{
+		olc::Pixel* pDst = sprTarget->pColData.data() + y * sprTarget->width;
+		std::fill(pDst, pDst + sprTarget->width, olc::BLANK);
+		if (y >= sprTile->height)
+			continue;
+
+		const olc::Pixel* pSource = sprTile->pColData.data() + y * sprTile->width;
+		for (int x = 0; x < sprTarget->width; x += tileSize.x)
+			std::memcpy((void*)(pDst + x), pSource, std::min(nCopyWidth, sprTarget->width - x) * sizeof(olc::Pixel));
+	}
+
+	// ...and every row below it is the row one tile further up
+	const size_t nRowBytes = sprTarget->width * sizeof(olc::Pixel);
+	for (int y = tileSize.y; y < sprTarget->height; y++)
+		std::memcpy((void*)(sprTarget->pColData.data() + y * sprTarget->width), sprTarget->pColData.data() + (y - tileSize.y) * sprTarget->width, nRowBytes);
+}
+
+void olcPGEX_ScrollingTile::DrawSingleTile(const olc::vi2d screenPos, olc::Decal* decal)
+{
+	pge->DrawDecal(screenPos, decal);
 }
 
 void olcPGEX_ScrollingTile::DrawAllTiles(const olc::vf2d camPos)
 {
-	vecCurrentOffset.x = (int)camPos.x % vecTileSize.x;
-	vecCurrentOffset.y = (int)camPos.y % vecTileSize.y;
+	const bool bAlt = bShowAltTile && decAltTile != nullptr;
+	olc::Decal* decal = bAlt ? decAltTile : decTile;
+	if (decal == nullptr)
+		return;
+
+	// Always between 0 and the tile size, even when the camera is left of or above the origin
+	vecCurrentOffset.x = (int)std::floor(camPos.x) % vecTileSize.x;
+	vecCurrentOffset.y = (int)std::floor(camPos.y) % vecTileSize.y;
+	if (vecCurrentOffset.x < 0) vecCurrentOffset.x += vecTileSize.x;
+	if (vecCurrentOffset.y < 0) vecCurrentOffset.y += vecTileSize.y;
+
+	if (drawMode == DrawMode::CACHED_STRIP)
+	{
+		pge->DrawDecal(olc::vi2d{ 0, 0 } - vecCurrentOffset, i_GetCachedDecal(cache[bAlt], decal));
+		return;
+	}
+
+	if (drawMode == DrawMode::REPEAT)
+	{
+		const olc::vf2d vecSize = vecTilesToDraw * vecTileSize;
+		pge->DrawPartialDecal(olc::vi2d{ 0, 0 } - vecCurrentOffset, vecSize, i_GetCachedDecal(cache[bAlt], decal), { 0.0f, 0.0f }, vecSize);
+		return;
+	}
 
 	olc::vi2d screenPos{};
 
-	for (int y = -1; y < vecTilesToDraw.y + 1; y++)
-		for (int x = -1; x < vecTilesToDraw.x + 1; x++)
+	for (int y = 0; y < vecTilesToDraw.y; y++)
+		for (int x = 0; x < vecTilesToDraw.x; x++)
 		{
 			screenPos.x = x * vecTileSize.x - vecCurrentOffset.x;
 			screenPos.y = y * vecTileSize.y - vecCurrentOffset.y;
-			DrawSingleTile(screenPos);
+			DrawSingleTile(screenPos, decal);
 		}
 
 }
 
+
+
+// A stack of scrolling background layers, drawn from the back to the front - v1.2
+class olcPGEX_ParallaxStack : public olc::PGEX
+{
+public:
+	olcPGEX_ParallaxStack() = default;
+
+	olcPGEX_ParallaxStack(const olcPGEX_ParallaxStack&) = delete;
+	olcPGEX_ParallaxStack& operator=(const olcPGEX_ParallaxStack&) = delete;
+
+	struct sLayer
+	{
+		olc::Decal* decal = nullptr;
+		olc::vf2d vecScrollFactor{ 1.0f, 1.0f };		// 0 = fixed to the screen, 1 = moves with the world
+		olc::vf2d vecOffset{};							// Screen position of the image when the camera is at 0, 0
+		bool bRepeatX = true;
+		bool bRepeatY = true;
+		olc::Pixel tint = olc::WHITE;
+		bool bEnabled = true;
+	};
+
+	std::vector<sLayer> vLayers;
+
+	int nLayersDrawn = 0;
+	int nLayersSkipped = 0;
+
+private:
+	// What the stack works out for the layer at the same index in vLayers.  Each one
+	// remembers what it was built from, so layers being changed, added or erased just
+	// cause a rebuild rather than drawing someone else's cache
+	struct sLayerCache
+	{
+		bool bOpaque = false;							// No transparent pixels in the image
+		olc::Decal* decOpaqueSource = nullptr;			// The decal bOpaque was worked out for
+		olc::Decal* decSource = nullptr;
+		bool bRepeatX = false;
+		bool bRepeatY = false;
+		std::unique_ptr<olc::Sprite> sprCache;
+		std::unique_ptr<olc::Decal> decCache;
+	};
+
+	olc::vi2d vecScreenSize{};
+	olcPGEX_ScrollingTile::DrawMode drawMode = olcPGEX_ScrollingTile::DrawMode::CACHED_STRIP;
+	std::vector<sLayerCache> vCaches;
+
+	// Per layer scratch space for DrawAllLayers, kept to avoid allocating every frame
+	std::vector<olc::vf2d> vStart, vSize;
+	std::vector<uint8_t> vVisible;
+
+	inline void i_ClearCaches();
+	inline void i_UpdateOpaque(const sLayer& layer, sLayerCache& cache);
+	inline olc::Decal* i_GetCachedDecal(const sLayer& layer, sLayerCache& cache, const olc::vf2d vecDrawSize);
+
+	// Where a layer starts on screen and how much of it is drawn, along one axis
+	inline void i_LayerSpan(const float fPos, const float fImageSize, const float fScreenSize, const bool bRepeat, float& fStart, float& fSize) const;
+
+public:
+	inline void SetScreenSize(const olc::vi2d screenSize);
+	inline void SetDrawMode(const olcPGEX_ScrollingTile::DrawMode mode);
+	inline int AddLayer(olc::Decal* decal, const olc::vf2d scrollFactor, const bool repeatX = true, const bool repeatY = true, const olc::vf2d offset = { 0.0f, 0.0f }, const olc::Pixel tint = olc::WHITE);
+	inline void DrawAllLayers(const olc::vf2d camPos);
+};
+
+
+void olcPGEX_ParallaxStack::SetScreenSize(const olc::vi2d screenSize)
+{
+	vecScreenSize = screenSize;
+	i_ClearCaches();
+}
+
+void olcPGEX_ParallaxStack::SetDrawMode(const olcPGEX_ScrollingTile::DrawMode mode)
+{
+	if (drawMode == mode)
+		return;
+
+	drawMode = mode;
+	i_ClearCaches();
+}
+
+int olcPGEX_ParallaxStack::AddLayer(olc::Decal* decal, const olc::vf2d scrollFactor, const bool repeatX, const bool repeatY, const olc::vf2d offset, const olc::Pixel tint)
+{
+	sLayer layer;
+	layer.decal = decal;
+	layer.vecScrollFactor = scrollFactor;
+	layer.vecOffset = offset;
+	layer.bRepeatX = repeatX;
+	layer.bRepeatY = repeatY;
+	layer.tint = tint;
+
+	vLayers.push_back(layer);
+	return (int)vLayers.size() - 1;
+}
+
+void olcPGEX_ParallaxStack::i_ClearCaches()
+{
+	// The opacity only depends on the decal, so that is kept
+	for (auto& cache : vCaches)
+	{
+		cache.decCache.reset();
+		cache.sprCache.reset();
+		cache.decSource = nullptr;
+	}
+}
+
+void olcPGEX_ParallaxStack::i_UpdateOpaque(const sLayer& layer, sLayerCache& cache)
+{
+	// Checked once per decal so occlusion is free every frame, and again if the layer is given a different decal
+	cache.decOpaqueSource = layer.decal;
+	cache.bOpaque = false;
+	if (layer.decal == nullptr || layer.decal->sprite == nullptr)
+		return;
+
+	const olc::Sprite* spr = layer.decal->sprite;
+	cache.bOpaque = true;
+	for (int i = 0; i < spr->width * spr->height && cache.bOpaque; i++)
+		cache.bOpaque = spr->pColData[i].a == 255;
+}
+
+olc::Decal* olcPGEX_ParallaxStack::i_GetCachedDecal(const sLayer& layer, sLayerCache& cache, const olc::vf2d vecDrawSize)
+{
+	if (cache.decCache != nullptr && cache.decSource == layer.decal && cache.bRepeatX == layer.bRepeatX && cache.bRepeatY == layer.bRepeatY)
+		return cache.decCache.get();
+
+	cache.decCache.reset();
+	cache.sprCache.reset();
+	cache.decSource = layer.decal;
+	cache.bRepeatX = layer.bRepeatX;
+	cache.bRepeatY = layer.bRepeatY;
+
+	if (drawMode == olcPGEX_ScrollingTile::DrawMode::REPEAT)
+	{
+		cache.decCache.reset(new olc::Decal(layer.decal->sprite, false, false));
+		return cache.decCache.get();
+	}
+
+	const olc::Sprite* spr = layer.decal->sprite;
+	cache.sprCache.reset(new olc::Sprite((int)vecDrawSize.x, (int)vecDrawSize.y));
+	olcPGEX_ScrollingTile::RepeatSprite(spr, { spr->width, spr->height }, cache.sprCache.get());
+
+	cache.decCache.reset(new olc::Decal(cache.sprCache.get()));
+	return cache.decCache.get();
+}
+
+void olcPGEX_ParallaxStack::i_LayerSpan(const float fPos, const float fImageSize, const float fScreenSize, const bool bRepeat, float& fStart, float& fSize) const
+{
+	if (!bRepeat)
+	{
+		fStart = fPos;
+		fSize = fImageSize;
+		return;
+	}
+
+	// The first repeat at or left of the screen edge, and enough repeats to cover the screen from there
+	fStart = fPos - std::ceil(fPos / fImageSize) * fImageSize;
+	fSize = (std::ceil(fScreenSize / fImageSize) + 1.0f) * fImageSize;
+}
+
+void olcPGEX_ParallaxStack::DrawAllLayers(const olc::vf2d camPos)
+{
+	nLayersDrawn = 0;
+	nLayersSkipped = 0;
+
+	const olc::vf2d vecScreen = vecScreenSize;
+	vStart.resize(vLayers.size());
+	vSize.resize(vLayers.size());
+	vVisible.assign(vLayers.size(), 0);
+	vCaches.resize(vLayers.size());
+	size_t nFirstLayer = 0;
+
+	// Work out every layer's position first, so the back layers that can't be seen are never drawn
+	for (size_t i = 0; i < vLayers.size(); i++)
+	{
+		const sLayer& layer = vLayers[i];
+		if (!layer.bEnabled || layer.decal == nullptr)
+			continue;
+
+		if (vCaches[i].decOpaqueSource != layer.decal)
+			i_UpdateOpaque(layer, vCaches[i]);
+
+		const olc::vf2d vecImage = { (float)layer.decal->sprite->width, (float)layer.decal->sprite->height };
+		const olc::vf2d vecPos = layer.vecOffset - camPos * layer.vecScrollFactor;
+		i_LayerSpan(vecPos.x, vecImage.x, vecScreen.x, layer.bRepeatX, vStart[i].x, vSize[i].x);
+		i_LayerSpan(vecPos.y, vecImage.y, vecScreen.y, layer.bRepeatY, vStart[i].y, vSize[i].y);
+
+		const olc::vf2d vecEnd = vStart[i] + vSize[i];
+		vVisible[i] = vStart[i].x < vecScreen.x && vStart[i].y < vecScreen.y && vecEnd.x > 0.0f && vecEnd.y > 0.0f;
+
+		const bool bCoversScreen = vStart[i].x <= 0.0f && vStart[i].y <= 0.0f && vecEnd.x >= vecScreen.x && vecEnd.y >= vecScreen.y;
+		if (vVisible[i] && bCoversScreen && vCaches[i].bOpaque && layer.tint.a == 255)
+			nFirstLayer = i;
+	}
+
+	for (size_t i = 0; i < vLayers.size(); i++)
+	{
+		if (!vVisible[i] || i < nFirstLayer)
+		{
+			nLayersSkipped++;
+			continue;
+		}
+
+		const sLayer& layer = vLayers[i];
+		nLayersDrawn++;
+
+		if (drawMode == olcPGEX_ScrollingTile::DrawMode::PER_TILE)
+		{
+			const olc::vf2d vecImage = { (float)layer.decal->sprite->width, (float)layer.decal->sprite->height };
+			for (float y = vStart[i].y; y < vStart[i].y + vSize[i].y; y += vecImage.y)
+				for (float x = vStart[i].x; x < vStart[i].x + vSize[i].x; x += vecImage.x)
+					pge->DrawDecal({ x, y }, layer.decal, { 1.0f, 1.0f }, layer.tint);
+		}
+		else if (drawMode == olcPGEX_ScrollingTile::DrawMode::REPEAT)
+			pge->DrawPartialDecal(vStart[i], vSize[i], i_GetCachedDecal(layer, vCaches[i], vSize[i]), { 0.0f, 0.0f }, vSize[i], layer.tint);
+		else
+			pge->DrawDecal(vStart[i], i_GetCachedDecal(layer, vCaches[i], vSize[i]), { 1.0f, 1.0f }, layer.tint);
+	}
+}
+
 #endif		// header guard
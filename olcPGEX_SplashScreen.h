@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|         OneLoneCoder Pixel Game Engine Extension            |
-	|                   SplashScreen - v1.2                       |
+	|                   SplashScreen - v1.5                       |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -86,6 +86,57 @@
 	General code cleanup and refactoring.
 
 
+	---------------------
+	  v1.3 NEW FEATURES
+	---------------------
+
+	The fades and the sliding text are now run by the shared
+	olcPGEX_Tween engine, so the fade lengths are exact whatever the
+	frame rate.  This header includes olcPGEX_Tween.h itself, the file
+	just needs to be next to it (or on your include path).
+
+
+	---------------------
+	  v1.4 NEW FEATURES
+	---------------------
+
+	Load your game while the splash screen is playing instead of
+	after it.  Hand it sprites (loaded by olcPGEX_ResourceManager)
+	or any other loading jobs (audio samples, level data, etc) in
+	OnUserCreate and they are run on an olcPGEX_ThreadPool while
+	the splash screen animates...
+
+	   splashScreen.AddPreloadSprite(rm, "./assets/tiles.png", &threadPool);
+	   splashScreen.AddPreloadJob([&]() { level.LoadFromFile("level1.dat"); }, &threadPool);
+
+	The splash screen still plays for its usual length, but if
+	anything is still loading it holds on the logo (rather than
+	fading out) until everything has finished.  When
+	AnimateSplashScreen returns false your sprites are ready to use
+	with RM_Sprite as normal.  The splash screen doesn't include
+	the resource manager itself, so include (and implement) it as
+	usual in whichever order you like.
+
+	Jobs must only load data, anything that needs the engine itself
+	(creating decals for example) has to wait for the main thread,
+	which is what AddPreloadSprite does for you.
+
+	PreloadProgress() returns 0.0f to 1.0f, or a progress bar can be
+	shown underneath the logo...
+
+	   splashScreen.SetProgressBar(true, olc::GREY);
+
+
+	---------------------
+	  v1.5 NEW FEATURES
+	---------------------
+
+	The text is drawn once into decals by the shared olcPGEX_TextCache
+	instead of being drawn pixel by pixel every frame.  As with the
+	Tween header, olcPGEX_TextCache.h is included for you and only
+	needs to be where the compiler can find it.
+
+
 	License (OLC-3)
 	~~~~~~~~~~~~~~~
 
@@ -126,6 +177,13 @@
 */
 
 #include "olcPixelGameEngine.h"
+#include "olcPGEX_Tween.h"
+#include "olcPGEX_TextCache.h"
+#include "olcPGEX_ThreadPool.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
 
 #ifndef OLC_PGEX_SPLASHSCREEN
 #define OLC_PGEX_SPLASHSCREEN
@@ -165,6 +223,8 @@ private:
 	float				fFadeDuration =			1.0f;
 	float				fAnimationCounter =		0.0f;
 	float				fTextOffset =			0.0f;
+	int					nAlphaTween =			-1;									// v1.3
+	int					nOffsetTween =			-1;									// v1.3
 	float				fInitialDelay =			1.5f;
 
 	const std::string	strMadeWith =			"made with";
@@ -179,15 +239,43 @@ private:
 
 	const bool			UPDATE_ALPHA =			true;
 
+	// Shared with the jobs so a job that finishes late never touches a splash screen that has gone - v1.4
+	struct sPreloadState
+	{
+		std::atomic<int> nJobsDone{ 0 };
+	};
+	std::shared_ptr<sPreloadState> preloadState =	std::make_shared<sPreloadState>();
+	int					nPreloadJobs =			0;
+	int					nPreloadSprites =		0;
+	// The resource manager is only known to AddPreloadSprite (a template) so this header doesn't need to include it
+	void*				pResourceManager =		nullptr;
+	void				(*fnUpdatePreloads)		(void* rm) = nullptr;
+	int					(*fnPreloadsPending)	(const void* rm) = nullptr;
+
+	bool				bShowProgress =			false;
+	olc::Pixel			pProgressColour =		olc::WHITE;
+
 public:
 	// Optional function to modify the standard splash screen parameters - v1.1
 	inline void			SetOptions				(const int scale, const int partialScale, const float totalDuration, const float initialDelay, const olc::Pixel backGroundColour, const olc::Pixel PGEColour, const olc::Pixel nameSpaceColour, const olc::Pixel defaultColour);
 	// The main function that will display the splash screen
 	inline bool			AnimateSplashScreen		(const float fElapsedTime);
 
+	// Loading that runs while the splash screen is playing - v1.4
+	inline void			AddPreloadJob			(std::function<void()> job, olcPGEX_ThreadPool* threadPool);
+	template<class ResourceManager>
+	inline void			AddPreloadSprite		(ResourceManager& rm, const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool);
+	template<class ResourceManager>
+	inline void			AddPreloadSprite		(ResourceManager& rm, const int fileNameID, const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool);
+	inline bool			PreloadsFinished		() const;
+	inline float		PreloadProgress			() const;
+	inline void			SetProgressBar			(const bool showProgress, const olc::Pixel progressColour = olc::WHITE);
+
 private:
 	// Internal helper function 
 	inline void			i_UpdateText			(bool updateAlpha = false);
+	template<class ResourceManager>
+	inline void			i_SetResourceManager	(ResourceManager& rm);
 };
 
 void olcPGEX_SplashScreen::SetOptions(const int scale, const int partialScale, const float totalDuration, const float initialDelay, const olc::Pixel backGroundColour, const olc::Pixel PGEColour, const olc::Pixel nameSpaceColour, const olc::Pixel defaultColour)
@@ -210,10 +298,16 @@ bool olcPGEX_SplashScreen::AnimateSplashScreen(const float fElapsedTime)
 	if (nSplashScreenState == SS_State::SS_COMPLETE)
 		return false;
 
+	// Sprites finish loading on the main thread
+	if (pResourceManager != nullptr)
+		fnUpdatePreloads(pResourceManager);
+
 	// Clear screen to desired background colour and increment the counter
 	pge->Clear(pBackGroundColour);
 	fAnimationCounter += fElapsedTime;
-	fTextOffset = fAnimationCounter * fScale * 4.0f;
+
+	auto& tweens = olcPGEX_Tween::Shared();
+	fTextOffset = tweens.Get(nOffsetTween);
 
 	switch (nSplashScreenState)
 	{
@@ -235,6 +329,13 @@ bool olcPGEX_SplashScreen::AnimateSplashScreen(const float fElapsedTime)
 		// Calculate the fade duration based on the total duration
 		fFadeDuration = fTotalDuration / 4.0f;
 
+		// Created here rather than in the constructor, which can run before the engine exists
+		if (nAlphaTween < 0)
+		{
+			nAlphaTween = tweens.Create(0.0f);
+			nOffsetTween = tweens.Create(0.0f);
+		}
+
 		nNextSplashScreenState = SS_State::SS_PRE_FADE_IN;
 
 	} break;
@@ -246,18 +347,21 @@ bool olcPGEX_SplashScreen::AnimateSplashScreen(const float fElapsedTime)
 		{
 			fAnimationCounter = 0.0f;
 			nNextSplashScreenState = SS_State::SS_FADE_IN;
+
+			// The text slides apart for the whole time it is on screen
+			tweens.Start(nAlphaTween, 0.0f, 255.0f, fFadeDuration);
+			tweens.Start(nOffsetTween, 0.0f, fTotalDuration * fScale * 4.0f, fTotalDuration);
 		}
 	} break;
 
 	case SS_State::SS_FADE_IN:
 	{
-		// Lerp the alpha values and display the text
-		fAlpha += (255.0f / fFadeDuration) * fElapsedTime;
-		if (fAlpha > 255.0f) fAlpha = 255.0f;
+		// Fade the text in
+		fAlpha = tweens.Get(nAlphaTween);
 
 		i_UpdateText(UPDATE_ALPHA);
 
-		if (fAnimationCounter >= fFadeDuration)
+		if (!tweens.IsActive(nAlphaTween))
 			nNextSplashScreenState = SS_State::SS_DISPLAY;
 
 	} break;
@@ -267,20 +371,23 @@ bool olcPGEX_SplashScreen::AnimateSplashScreen(const float fElapsedTime)
 		// Display the text with no transparency
 		i_UpdateText();
 
-		if (fAnimationCounter >= fTotalDuration - fFadeDuration)
+		// Hold on the logo until everything has loaded
+		if (fAnimationCounter >= fTotalDuration - fFadeDuration && PreloadsFinished())
+		{
+			tweens.Start(nAlphaTween, fAlpha, 0.0f, fFadeDuration);
 			nNextSplashScreenState = SS_State::SS_FADE_OUT;
+		}
 
 	} break;
 
 	case SS_State::SS_FADE_OUT:
 	{
-		// Lerp the alpha back down to clear and display the text
-		fAlpha -= (255.0f / fFadeDuration) * fElapsedTime;
-		if (fAlpha < 0.0f) fAlpha = 0.0f;
+		// Fade the text back out
+		fAlpha = tweens.Get(nAlphaTween);
 
 		i_UpdateText(UPDATE_ALPHA);
 
-		if (fAnimationCounter >= fTotalDuration)
+		if (!tweens.IsActive(nAlphaTween))
 			nNextSplashScreenState = SS_State::SS_COMPLETE;
 
 	} break;
@@ -305,10 +412,91 @@ void olcPGEX_SplashScreen::i_UpdateText(bool updateAlpha)
 		pDefaultColour.a =			(uint8_t)fAlpha;
 	}
 
-	pge->DrawString					(vecPGEPos, strNameSpace, pNameSpaceColour, nScale);
-	pge->DrawString					(vecPGEPos, strPGE, pPGEColour, nScale);
-	pge->DrawString					(olc::vf2d{ vecMadeWithPos.x + fTextOffset, vecMadeWithPos.y }, strMadeWith, pDefaultColour, nPartialScale);
-	pge->DrawString					(olc::vf2d{ vecOneLoneCoderPos.x - fTextOffset, vecOneLoneCoderPos.y }, strOneLoneCoder, pDefaultColour, nPartialScale);
+	// The strings never change so each one is only ever drawn into a decal once - v1.5
+	auto& text =					olcPGEX_TextCache::Shared();
+	const olc::vf2d vecScale =		{ (float)nScale, (float)nScale };
+	const olc::vf2d vecPartialScale = { (float)nPartialScale, (float)nPartialScale };
+
+	text.DrawString					(vecPGEPos, strNameSpace, pNameSpaceColour, vecScale);
+	text.DrawString					(vecPGEPos, strPGE, pPGEColour, vecScale);
+	text.DrawString					(olc::vf2d{ vecMadeWithPos.x + fTextOffset, vecMadeWithPos.y }, strMadeWith, pDefaultColour, vecPartialScale);
+	text.DrawString					(olc::vf2d{ vecOneLoneCoderPos.x - fTextOffset, vecOneLoneCoderPos.y }, strOneLoneCoder, pDefaultColour, vecPartialScale);
+
+	// The progress bar sits underneath everything, as wide as the PixelGameEngine text - v1.4
+	if (bShowProgress && nPreloadJobs + nPreloadSprites > 0)
+	{
+		olc::Pixel pBar =			pProgressColour;
+		pBar.a =					pDefaultColour.a;
+
+		const olc::vf2d vecBarPos =	{ vecPGEPos.x, vecOneLoneCoderPos.y + 8.0f * nPartialScale * 2.0f };
+		const float fBarWidth =		8.0f * nScale * 20.0f * PreloadProgress();
+		pge->FillRectDecal			(vecBarPos, { fBarWidth, (float)nPartialScale }, pBar);
+	}
+}
+
+void olcPGEX_SplashScreen::AddPreloadJob(std::function<void()> job, olcPGEX_ThreadPool* threadPool)
+{
+	nPreloadJobs++;
+
+	auto state = preloadState;
+	auto preload = [state, job]()
+	{
+		job();
+		state->nJobsDone.fetch_add(1);
+	};
+
+	// Without a thread pool the job simply runs now
+	if (threadPool != nullptr)
+		threadPool->AddJob(preload);
+	else
+		preload();
+}
+
+template<class ResourceManager>
+void olcPGEX_SplashScreen::AddPreloadSprite(ResourceManager& rm, const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool)
+{
+	i_SetResourceManager(rm);
+	nPreloadSprites++;
+	rm.RM_PreloadSprite(spriteFileName, threadPool);
+}
+
+template<class ResourceManager>
+void olcPGEX_SplashScreen::AddPreloadSprite(ResourceManager& rm, const int fileNameID, const std::string& spriteFileName, olcPGEX_ThreadPool* threadPool)
+{
+	i_SetResourceManager(rm);
+	nPreloadSprites++;
+	rm.RM_PreloadSprite(fileNameID, spriteFileName, threadPool);
+}
+
+template<class ResourceManager>
+void olcPGEX_SplashScreen::i_SetResourceManager(ResourceManager& rm)
+{
+	pResourceManager =		&rm;
+	fnUpdatePreloads =		[](void* p) { static_cast<ResourceManager*>(p)->RM_UpdatePreloads(); };
+	fnPreloadsPending =		[](const void* p) { return static_cast<const ResourceManager*>(p)->RM_PreloadsPending(); };
+}
+
+bool olcPGEX_SplashScreen::PreloadsFinished() const
+{
+	return preloadState->nJobsDone.load() >= nPreloadJobs && (pResourceManager == nullptr || fnPreloadsPending(pResourceManager) == 0);
+}
+
+float olcPGEX_SplashScreen::PreloadProgress() const
+{
+	const int nTotal = nPreloadJobs + nPreloadSprites;
+	if (nTotal == 0)
+		return 1.0f;
+
+	// The resource manager may be loading other sprites as well, so only count up to our own
+	const int nSpritesPending = pResourceManager != nullptr ? std::min(fnPreloadsPending(pResourceManager), nPreloadSprites) : 0;
+	const int nDone = std::min(preloadState->nJobsDone.load(), nPreloadJobs) + nPreloadSprites - nSpritesPending;
+	return (float)nDone / (float)nTotal;
+}
+
+void olcPGEX_SplashScreen::SetProgressBar(const bool showProgress, const olc::Pixel progressColour)
+{
+	bShowProgress =			showProgress;
+	pProgressColour =		progressColour;
 }
 
 #endif
@@ -0,0 +1,425 @@
+/*
+	olcPGEX_TextCache.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                   TextCache - v1.0                          |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	Drawing text with DrawString draws every pixel of every letter on
+	the CPU, every frame, even when the text never changes.  This
+	extension draws each piece of text into a decal the first time it
+	is seen and from then on it is drawn as a single tinted decal.
+
+	Text that changes (scores, timers, debug readouts) can be given a
+	slot, and when it changes only the letters that are different are
+	drawn again.
+
+	Some of my other extensions (SplashScreen and the Camera2D debug
+	info) draw their text through the shared text cache.
+
+
+	How to use it?
+	~~~~~~~~~~~~~~
+	Include the header file anywhere after the olcPixelGameEngine.  There
+	is no implementation guard to define, everything is inlined.
+
+		#include "olcPGEX_TextCache.h"
+
+	Use the shared cache in place of DrawString / DrawStringProp.  The
+	position, colour and scale work the same way, the last parameter
+	picks the proportional font...
+
+		auto& text = olcPGEX_TextCache::Shared();
+		text.DrawString({ 10, 10 }, "PAUSED", olc::YELLOW, { 4.0f, 4.0f });
+		text.DrawString({ 10, 50 }, "Press space to continue", olc::WHITE, { 1.0f, 1.0f }, true);
+
+	For text that changes, ask for a slot once and draw through it.
+	Only the letters that changed since the last frame are drawn again
+	(a slot holds one piece of text, so draw it once per frame)...
+
+		int nScoreSlot = text.NewSlot();
+		...
+		text.DrawString(nScoreSlot, { 10, 10 }, "Score: " + std::to_string(nScore));
+
+	Give a slot back with FreeSlot when you are done with it.  Its text
+	is dropped at the start of the next frame and the number is handed
+	out again by NewSlot.
+
+	The cache keeps nMaxEntries pieces of text (128 by default) and
+	drops the ones that have gone unused the longest when it is full.
+	Text drawn during the current frame is never dropped.
+
+	NOTE: The shared cache hooks into the pixel game engine (v2.10 and
+	above) to know when a new frame starts, and should first be used once
+	your PixelGameEngine exists.  If you define OLC_PGEX_TEXTCACHE_MANUAL
+	before including the header (or create your own olcPGEX_TextCache),
+	call NewFrame once at the start of each frame yourself.
+
+
+
+	License (OLC-3)
+	~~~~~~~~~~~~~~~
+
+	Copyright 2018 - 2019 OneLoneCoder.com
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	1. Redistributions or derivations of source code must retain the above
+	copyright notice, this list of conditions and the following disclaimer.
+
+	2. Redistributions or derivative works in binary form must reproduce
+	the above copyright notice. This list of conditions and the following
+	disclaimer must be reproduced in the documentation and/or other
+	materials provided with the distribution.
+
+	3. Neither the name of the copyright holder nor the names of its
+	contributors may be used to endorse or promote products derived
+	from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+	LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+	DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+	THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	Author
+	~~~~~~
+	Justin Richards
+
+*/
+
+#ifndef OLC_PGEX_TEXTCACHE
+#define OLC_PGEX_TEXTCACHE
+
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class olcPGEX_TextCache : public olc::PGEX
+{
+public:
+	inline olcPGEX_TextCache(const bool bHook = false);
+	inline ~olcPGEX_TextCache();
+
+	olcPGEX_TextCache(const olcPGEX_TextCache&) = delete;
+	olcPGEX_TextCache& operator=(const olcPGEX_TextCache&) = delete;
+
+	// The cache used by the other extensions, told about new frames automatically unless OLC_PGEX_TEXTCACHE_MANUAL is defined
+	static inline olcPGEX_TextCache& Shared();
+
+private:
+	struct sEntry
+	{
+		std::string sText;
+		bool bProportional = false;
+		olc::vi2d vecSize{};													// Size of the text at scale 1
+		olc::Sprite* sprText = nullptr;
+		olc::Decal* decText = nullptr;
+		uint32_t nLastUsed = 0;
+		std::list<uint64_t>::iterator itLRU;
+	};
+
+	// Slots and text share one map, slots have the top bit of their key set
+	std::unordered_map<uint64_t, sEntry> mEntries;
+	std::list<uint64_t> lLRU;													// Most recently used at the front
+	uint32_t nFrame = 1;
+	int nNextSlot = 0;
+	std::vector<int> vFreeSlots;												// Ready to be handed out again
+	std::vector<int> vReleasedSlots;											// Freed this frame, their decals may still be waiting to be drawn
+
+	static inline uint64_t i_TextKey(const std::string& sText, const bool bProportional);
+	static inline uint64_t i_SlotKey(const int nSlot) { return (1ull << 63) | (uint32_t)nSlot; }
+	static inline bool i_HasLayout(const std::string& sText) { return sText.find_first_of("\n\t") != std::string::npos; }
+
+	inline sEntry& i_Use(const uint64_t nKey);
+	inline void i_Render(sEntry& entry, const std::string& sText, const bool bProportional);
+	inline void i_ClearRect(sEntry& entry, const olc::vi2d vecPos, const olc::vi2d vecSize);
+	inline void i_Draw(const sEntry& entry, const olc::vf2d& pos, const olc::Pixel tint, const olc::vf2d& scale);
+	inline void i_Evict();
+	inline void i_Free(sEntry& entry);
+
+protected:
+	inline bool OnBeforeUserUpdate(float& fElapsedTime) override;
+
+public:
+	size_t nMaxEntries = 128;
+
+	// Since the start of the frame
+	int nTextsRendered = 0;														// Pieces of text drawn in full
+	int nGlyphsDrawn = 0;														// Letters drawn, in full or changed in a slot
+	int nEvicted = 0;
+
+	inline void DrawString(const olc::vf2d& pos, const std::string& sText, const olc::Pixel tint = olc::WHITE, const olc::vf2d& scale = { 1.0f, 1.0f }, const bool bProportional = false);
+	inline void DrawString(const int nSlot, const olc::vf2d& pos, const std::string& sText, const olc::Pixel tint = olc::WHITE, const olc::vf2d& scale = { 1.0f, 1.0f }, const bool bProportional = false);
+
+	// A decal holding the text (top left of the decal, vecSize in pixels) for drawing it yourself
+	inline olc::Decal* GetDecal(const std::string& sText, const bool bProportional, olc::vi2d& vecSize);
+
+	inline int NewSlot();
+	inline void FreeSlot(const int nSlot);
+	inline void NewFrame();
+	inline void Clear();
+	size_t Size() const { return mEntries.size(); }
+};
+
+
+olcPGEX_TextCache::olcPGEX_TextCache(const bool bHook) : olc::PGEX(bHook && pge != nullptr)
+{
+}
+
+olcPGEX_TextCache::~olcPGEX_TextCache()
+{
+	Clear();
+}
+
+olcPGEX_TextCache& olcPGEX_TextCache::Shared()
+{
+#if defined(OLC_PGEX_TEXTCACHE_MANUAL)
+	static olcPGEX_TextCache cache(false);
+#else
+	static olcPGEX_TextCache cache(true);
+#endif
+	return cache;
+}
+
+bool olcPGEX_TextCache::OnBeforeUserUpdate(float& fElapsedTime)
+{
+	(void)fElapsedTime;
+	NewFrame();
+	return false;
+}
+
+void olcPGEX_TextCache::NewFrame()
+{
+	// Last frame's decals have been drawn by now, so anything not used yet this frame can go
+	nFrame++;
+	nTextsRendered = 0;
+	nGlyphsDrawn = 0;
+	nEvicted = 0;
+
+	for (const int nSlot : vReleasedSlots)
+	{
+		auto it = mEntries.find(i_SlotKey(nSlot));
+		if (it != mEntries.end())
+		{
+			i_Free(it->second);
+			lLRU.erase(it->second.itLRU);
+			mEntries.erase(it);
+		}
+		vFreeSlots.push_back(nSlot);
+	}
+	vReleasedSlots.clear();
+
+	i_Evict();
+}
+
+int olcPGEX_TextCache::NewSlot()
+{
+	if (vFreeSlots.empty())
+		return nNextSlot++;
+
+	const int nSlot = vFreeSlots.back();
+	vFreeSlots.pop_back();
+	return nSlot;
+}
+
+void olcPGEX_TextCache::FreeSlot(const int nSlot)
+{
+	if (nSlot >= 0)
+		vReleasedSlots.push_back(nSlot);
+}
+
+uint64_t olcPGEX_TextCache::i_TextKey(const std::string& sText, const bool bProportional)
+{
+	// A clash only costs a redraw, the entry always checks its own text
+	const uint64_t nHash = (uint64_t)std::hash<std::string>()(sText);
+	return ((nHash << 1) | (bProportional ? 1 : 0)) & ~(1ull << 63);
+}
+
+olcPGEX_TextCache::sEntry& olcPGEX_TextCache::i_Use(const uint64_t nKey)
+{
+	auto it = mEntries.find(nKey);
+	if (it == mEntries.end())
+	{
+		it = mEntries.emplace(nKey, sEntry{}).first;
+		lLRU.push_front(nKey);
+		it->second.itLRU = lLRU.begin();
+	}
+	else
+		lLRU.splice(lLRU.begin(), lLRU, it->second.itLRU);
+
+	it->second.nLastUsed = nFrame;
+	i_Evict();
+	return it->second;
+}
+
+void olcPGEX_TextCache::i_Evict()
+{
+	// Never drop anything used this frame, its decal may already be waiting to be drawn
+	while (mEntries.size() > nMaxEntries && !lLRU.empty())
+	{
+		auto it = mEntries.find(lLRU.back());
+		if (it->second.nLastUsed == nFrame)
+			break;
+
+		i_Free(it->second);
+		mEntries.erase(it);
+		lLRU.pop_back();
+		nEvicted++;
+	}
+}
+
+void olcPGEX_TextCache::i_Free(sEntry& entry)
+{
+	delete entry.decText;
+	delete entry.sprText;
+	entry.decText = nullptr;
+	entry.sprText = nullptr;
+}
+
+void olcPGEX_TextCache::Clear()
+{
+	for (auto& e : mEntries)
+		i_Free(e.second);
+
+	mEntries.clear();
+	lLRU.clear();
+}
+
+void olcPGEX_TextCache::i_ClearRect(sEntry& entry, const olc::vi2d vecPos, const olc::vi2d vecSize)
+{
+	const int nX0 = std::max(vecPos.x, 0);
+	const int nX1 = std::min(vecPos.x + vecSize.x, entry.sprText->width);
+	const int nY1 = std::min(vecPos.y + vecSize.y, entry.sprText->height);
+
+	for (int y = std::max(vecPos.y, 0); y < nY1; y++)
+		for (int x = nX0; x < nX1; x++)
+			entry.sprText->pColData[y * entry.sprText->width + x] = olc::BLANK;
+}
+
+void olcPGEX_TextCache::i_Render(sEntry& entry, const std::string& sText, const bool bProportional)
+{
+	if (entry.decText != nullptr && entry.sText == sText && entry.bProportional == bProportional)
+		return;
+
+	const olc::vi2d vecNewSize = bProportional ? pge->GetTextSizeProp(sText) : pge->GetTextSize(sText);
+
+	// Grow the sprite in steps so text that gets a little longer doesn't mean a new sprite every time
+	bool bFull = entry.decText == nullptr || entry.bProportional != bProportional || entry.vecSize.y != vecNewSize.y
+		|| i_HasLayout(sText) || i_HasLayout(entry.sText);
+
+	if (entry.sprText == nullptr || vecNewSize.x > entry.sprText->width || vecNewSize.y > entry.sprText->height)
+	{
+		i_Free(entry);
+		entry.sprText = new olc::Sprite(std::max((vecNewSize.x + 31) & ~31, 32), std::max(vecNewSize.y, 8));
+		entry.decText = new olc::Decal(entry.sprText);
+		bFull = true;
+	}
+
+	olc::Sprite* pOldTarget = pge->GetDrawTarget();
+	pge->SetDrawTarget(entry.sprText);
+
+	if (bFull)
+	{
+		i_ClearRect(entry, { 0, 0 }, { entry.sprText->width, entry.sprText->height });
+
+		if (bProportional)
+			pge->DrawStringProp({ 0, 0 }, sText, olc::WHITE);
+		else
+			pge->DrawString({ 0, 0 }, sText, olc::WHITE);
+
+		nTextsRendered++;
+		nGlyphsDrawn += (int)sText.size();
+	}
+	else if (!bProportional)
+	{
+		// Every letter has its own 8 x 8 cell, so only the cells that changed are drawn again
+		const std::string& sOld = entry.sText;
+		const size_t nLength = std::max(sOld.size(), sText.size());
+
+		for (size_t i = 0; i < nLength; i++)
+		{
+			const char cOld = i < sOld.size() ? sOld[i] : ' ';
+			const char cNew = i < sText.size() ? sText[i] : ' ';
+			if (cOld == cNew)
+				continue;
+
+			i_ClearRect(entry, { (int)i * 8, 0 }, { 8, 8 });
+			if (cNew != ' ')
+			{
+				pge->DrawString({ (int)i * 8, 0 }, std::string(1, cNew), olc::WHITE);
+				nGlyphsDrawn++;
+			}
+		}
+	}
+	else
+	{
+		// Proportional letters move when an earlier one changes width, so redraw from the first change onwards
+		size_t nSame = 0;
+		while (nSame < entry.sText.size() && nSame < sText.size() && entry.sText[nSame] == sText[nSame])
+			nSame++;
+
+		const int nX = nSame > 0 ? pge->GetTextSizeProp(sText.substr(0, nSame)).x : 0;
+		i_ClearRect(entry, { nX, 0 }, { std::max(entry.vecSize.x, vecNewSize.x) - nX, entry.sprText->height });
+		pge->DrawStringProp({ nX, 0 }, sText.substr(nSame), olc::WHITE);
+		nGlyphsDrawn += (int)(sText.size() - nSame);
+	}
+
+	pge->SetDrawTarget(pOldTarget);
+	entry.decText->Update();
+
+	entry.sText = sText;
+	entry.bProportional = bProportional;
+	entry.vecSize = vecNewSize;
+}
+
+void olcPGEX_TextCache::i_Draw(const sEntry& entry, const olc::vf2d& pos, const olc::Pixel tint, const olc::vf2d& scale)
+{
+	if (entry.vecSize.x <= 0 || entry.vecSize.y <= 0)
+		return;
+
+	pge->DrawPartialDecal(pos, entry.decText, { 0.0f, 0.0f }, { (float)entry.vecSize.x, (float)entry.vecSize.y }, scale, tint);
+}
+
+void olcPGEX_TextCache::DrawString(const olc::vf2d& pos, const std::string& sText, const olc::Pixel tint, const olc::vf2d& scale, const bool bProportional)
+{
+	sEntry& entry = i_Use(i_TextKey(sText, bProportional));
+	i_Render(entry, sText, bProportional);
+	i_Draw(entry, pos, tint, scale);
+}
+
+void olcPGEX_TextCache::DrawString(const int nSlot, const olc::vf2d& pos, const std::string& sText, const olc::Pixel tint, const olc::vf2d& scale, const bool bProportional)
+{
+	sEntry& entry = i_Use(i_SlotKey(nSlot));
+	i_Render(entry, sText, bProportional);
+	i_Draw(entry, pos, tint, scale);
+}
+
+olc::Decal* olcPGEX_TextCache::GetDecal(const std::string& sText, const bool bProportional, olc::vi2d& vecSize)
+{
+	sEntry& entry = i_Use(i_TextKey(sText, bProportional));
+	i_Render(entry, sText, bProportional);
+	vecSize = entry.vecSize;
+	return entry.decText;
+}
+
+#endif		// header guard
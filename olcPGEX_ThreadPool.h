@@ -0,0 +1,250 @@
+/*
+	olcPGEX_ThreadPool.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                   ThreadPool - v1.0                         |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It is a small pool of worker threads that other extensions (and
+	your own code) can hand work to, instead of every extension
+	starting threads of its own.
+
+	Some of my other extensions can make use of it (RayCast2D batches
+	for example), simply pass them a pointer to your thread pool.
+
+
+	How to use it?
+	~~~~~~~~~~~~~~
+	Include the header file anywhere after the olcPixelGameEngine.  There
+	is no implementation guard to define, everything is inlined.
+
+		#include "olcPGEX_ThreadPool.h"
+
+	Create one thread pool somewhere that lives for the whole program,
+	your main class is an ideal place for it.  By default it starts one
+	worker per CPU core, minus one for the main thread.
+
+		olcPGEX_ThreadPool threadPool;
+
+	Fire and forget jobs (loading files for example) can be added at any
+	time and will be picked up by the next free worker...
+
+		threadPool.AddJob([&]() { LoadLevelData("level1.dat"); });
+
+	Or split a loop up between the workers and the main thread.  The loop
+	is broken into chunks of nGrain items, and ParallelFor only returns
+	once every chunk has been processed...
+
+		threadPool.ParallelFor(vEnemies.size(), 64, [&](size_t nBegin, size_t nEnd)
+		{
+			for (size_t i = nBegin; i < nEnd; i++)
+				vEnemies[i].UpdateAI();
+		});
+
+	The main thread always helps out with ParallelFor, so even if every
+	worker is busy with a long running job the loop still completes.
+
+	NOTE: When compiling for emscripten without pthreads there are no
+	workers.  AddJob runs the job immediately and ParallelFor runs on the
+	main thread, so your code works the same either way.
+
+
+
+	License (OLC-3)
+	~~~~~~~~~~~~~~~
+
+	Copyright 2018 - 2019 OneLoneCoder.com
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	1. Redistributions or derivations of source code must retain the above
+	copyright notice, this list of conditions and the following disclaimer.
+
+	2. Redistributions or derivative works in binary form must reproduce
+	the above copyright notice. This list of conditions and the following
+	disclaimer must be reproduced in the documentation and/or other
+	materials provided with the distribution.
+
+	3. Neither the name of the copyright holder nor the names of its
+	contributors may be used to endorse or promote products derived
+	from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+	LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+	DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+	THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	Author
+	~~~~~~
+	Justin Richards
+
+*/
+
+#ifndef OLC_PGEX_THREADPOOL
+#define OLC_PGEX_THREADPOOL
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+	#define OLC_PGEX_THREADPOOL_NO_THREADS
+#endif
+
+class olcPGEX_ThreadPool
+{
+public:
+	inline olcPGEX_ThreadPool(const int nThreads = 0);
+	inline ~olcPGEX_ThreadPool();
+
+	olcPGEX_ThreadPool(const olcPGEX_ThreadPool&) = delete;
+	olcPGEX_ThreadPool& operator=(const olcPGEX_ThreadPool&) = delete;
+
+private:
+	// Shared between the helpers of a single ParallelFor call
+	struct sParallelFor
+	{
+		const std::function<void(size_t, size_t)>* pFunc = nullptr;
+		size_t nCount = 0;
+		size_t nGrain = 1;
+		size_t nChunks = 0;
+		std::atomic<size_t> nNextChunk{ 0 };
+		std::atomic<size_t> nChunksDone{ 0 };
+	};
+
+	std::vector<std::thread> vWorkers;
+	std::deque<std::function<void()>> qJobs;
+
+	std::mutex muxJobs;
+	std::condition_variable cvJobs;
+	bool bStop = false;
+
+	inline void i_WorkerLoop();
+	static inline void i_RunChunks(sParallelFor& state);
+
+public:
+	inline void AddJob(std::function<void()> job);
+	inline void ParallelFor(const size_t nCount, const size_t nGrain, const std::function<void(size_t, size_t)>& func);
+
+	int WorkerCount() const { return (int)vWorkers.size(); }
+};
+
+
+olcPGEX_ThreadPool::olcPGEX_ThreadPool(const int nThreads)
+{
+#if !defined(OLC_PGEX_THREADPOOL_NO_THREADS)
+	// Leave a core for the main thread, but always have at least one worker for background jobs
+	int nWorkers = nThreads > 0 ? nThreads : (int)std::thread::hardware_concurrency() - 1;
+	if (nWorkers < 1) nWorkers = 1;
+
+	for (int i = 0; i < nWorkers; i++)
+		vWorkers.emplace_back([this]() { i_WorkerLoop(); });
+#else
+	(void)nThreads;
+#endif
+}
+
+olcPGEX_ThreadPool::~olcPGEX_ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(muxJobs);
+		bStop = true;
+	}
+	cvJobs.notify_all();
+
+	for (auto& w : vWorkers)
+		w.join();
+}
+
+void olcPGEX_ThreadPool::AddJob(std::function<void()> job)
+{
+	if (vWorkers.empty())
+	{
+		job();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(muxJobs);
+		qJobs.push_back(std::move(job));
+	}
+	cvJobs.notify_one();
+}
+
+void olcPGEX_ThreadPool::ParallelFor(const size_t nCount, const size_t nGrain, const std::function<void(size_t, size_t)>& func)
+{
+	if (nCount == 0)
+		return;
+
+	auto state = std::make_shared<sParallelFor>();
+	state->pFunc = &func;
+	state->nCount = nCount;
+	state->nGrain = nGrain > 0 ? nGrain : 1;
+	state->nChunks = (nCount + state->nGrain - 1) / state->nGrain;
+
+	// Wake as many workers as there are chunks to share, the main thread takes part as well
+	const size_t nHelpers = std::min(vWorkers.size(), state->nChunks - 1);
+	for (size_t h = 0; h < nHelpers; h++)
+		AddJob([state]() { i_RunChunks(*state); });
+
+	i_RunChunks(*state);
+
+	// Helpers that never got started simply find nothing left to do
+	while (state->nChunksDone.load() < state->nChunks)
+		std::this_thread::yield();
+}
+
+void olcPGEX_ThreadPool::i_RunChunks(sParallelFor& state)
+{
+	size_t nChunk;
+	while ((nChunk = state.nNextChunk.fetch_add(1)) < state.nChunks)
+	{
+		const size_t nBegin = nChunk * state.nGrain;
+		const size_t nEnd = std::min(nBegin + state.nGrain, state.nCount);
+		(*state.pFunc)(nBegin, nEnd);
+
+		state.nChunksDone.fetch_add(1);
+	}
+}
+
+void olcPGEX_ThreadPool::i_WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(muxJobs);
+			cvJobs.wait(lock, [this]() { return bStop || !qJobs.empty(); });
+
+			if (bStop && qJobs.empty())
+				return;
+
+			job = std::move(qJobs.front());
+			qJobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+#endif		// header guard
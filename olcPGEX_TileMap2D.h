@@ -0,0 +1,995 @@
+/*
+	olcPGEX_TileMap2D.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                   TileMap2D - v1.0                          |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It draws big tile maps quickly by splitting the map into chunks of
+	tiles (16 x 16 by default).  Each chunk is drawn into its own sprite
+	once and then drawn to the screen as a single decal, so a screen
+	full of tiles costs a handful of decals rather than thousands.
+
+	Only the chunks the camera can see are drawn.  When a tile changes
+	its chunk is marked dirty and drawn into its sprite again, and only
+	a few chunks are re-drawn (baked) each frame so a big change never
+	causes a hitch.  Anything that hasn't been baked yet is drawn tile by
+	tile for that frame so nothing ever goes missing.
+
+
+	How to use it?
+	~~~~~~~~~~~~~~
+	Include the header after the olcPixelGameEngine, and define the
+	implementation guard once...
+
+		#include "olcPixelGameEngine.h"
+
+		#define OLC_PGEX_TILEMAP2D_IMPLEMENTATION
+		#include "olcPGEX_TileMap2D.h"
+
+	Create the tile map once in OnUserCreate with the map size (in tiles),
+	the size of a tile (in pixels) and a tile set decal.  Tiles are
+	numbered from the top left of the tile set, left to right and then
+	top to bottom.  Any negative tile is empty...
+
+		olcPGEX_TileMap2D tileMap;
+
+		tileMap.Create({ 256, 128 }, { 16, 16 }, decalTileSet);
+		tileMap.SetTiles(vLevelData.data());			// optional, one int per tile
+
+	Change tiles at any time, only the chunk holding that tile is baked
+	again...
+
+		tileMap.SetTile(x, y, TILE_RUBBLE);
+		int nTile = tileMap.GetTile(x, y);
+
+	Then draw it using your camera (top left of the view in the world,
+	the size of the view in world units and the zoom)...
+
+		tileMap.Draw(camera.vecCamPos, camera.WorldViewSize(), camera.fZoom);
+
+	nBakeBudget (4 by default) is how many chunks can be baked in a
+	frame.  BakeAll() bakes everything at once, handy behind a loading
+	screen.  nChunksDrawn, nChunksBaked and nTilesDrawn (tiles drawn one
+	at a time because their chunk wasn't baked yet) show what happened
+	during the last Draw.
+
+	Procedural variation
+	~~~~~~~~~~~~~~~~~~~~
+	Big areas of the same tile look repetitive.  Rather than storing a
+	different tile for every spot, turn on variation and each tile picks
+	its own variant, flip, rotation and shade from a hash of its world
+	position.  The same tile always looks the same (so chunks can be
+	baked again, or streamed back in, without anything changing) and it
+	costs no memory at all...
+
+		olcPGEX_TileMap2D::sVariation variation;
+		variation.nFirstTile = TILE_GRASS;			// only these tiles are varied
+		variation.nLastTile = TILE_GRASS;
+		variation.nVariants = 4;				// TILE_GRASS + 0, 8, 16, 24 in the tile set
+		variation.nVariantOffset = 8;
+		variation.bFlipX = true;
+		variation.bRotate = true;				// square tiles only
+		variation.fTintJitter = 0.15f;				// up to 15% darker
+		variation.nSeed = 1234;
+
+		tileMap.SetVariation(variation);
+		streamer.SetVariation(variation);
+
+	The hashes are worked out a whole row of tiles at a time (4 at once
+	with SSE2, define OLC_PGEX_TILEMAP2D_NO_SIMD to turn that off).
+
+	NOTE: The tile set sprite is read directly when baking, so it must
+	stay in memory (decals made from files in the ResourceManager do).
+	Camera rotation isn't supported, the map is drawn axis aligned.
+
+
+	Streaming infinite worlds
+	~~~~~~~~~~~~~~~~~~~~~~~~~
+	If your world is too big to keep in memory (or never ends), use a
+	chunk streamer instead.  You give it a function that fills in the
+	tiles of any chunk, from a file or generated from noise, and it is
+	called on the thread pool for the chunks around the camera, and the
+	chunks the camera is heading towards...
+
+		olcPGEX_ChunkStreamer2D streamer;
+
+		streamer.Create({ 16, 16 }, decalTileSet, &threadPool, [&](const olc::vi2d& vecChunk, int* pTiles)
+		{
+			// Fill in 16 x 16 tiles for the chunk at vecChunk (chunk 0, 0 starts at world 0, 0)
+			for (int y = 0; y < 16; y++)
+				for (int x = 0; x < 16; x++)
+					pTiles[y * 16 + x] = MyWorldGenerator(vecChunk * 16 + olc::vi2d(x, y));
+		});
+
+	WARNING: The function runs on worker threads, so it must be safe to
+	call from more than one thread at a time.
+
+	Then every frame update and draw it using your camera...
+
+		streamer.Update(camera.vecCamPos, camera.WorldViewSize(), fElapsedTime);
+		streamer.Draw(camera.vecCamPos, camera.WorldViewSize(), camera.fZoom);
+
+	Chunks are generated and baked into sprites on the workers, and only
+	nUploadBudget (4 by default) are turned into decals on the main thread
+	each frame.  Chunks that aren't needed are forgotten, least recently
+	seen first, once the chunks kept in memory go over nMemoryCap bytes
+	(64MB by default).  fLookAhead is how many seconds ahead of the camera
+	to load (0.5 by default) and nPreloadChunks how many chunks around
+	the view are kept ready (1 by default).
+
+	Without a thread pool (pass nullptr) chunks are generated on the main
+	thread, nUploadBudget a frame.  GetTile reads a tile from the loaded
+	chunks, and is -1 for anything not loaded.
+
+
+
+	License (OLC-3)
+	~~~~~~~~~~~~~~~
+
+	Copyright 2018 - 2019 OneLoneCoder.com
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	1. Redistributions or derivations of source code must retain the above
+	copyright notice, this list of conditions and the following disclaimer.
+
+	2. Redistributions or derivative works in binary form must reproduce
+	the above copyright notice. This list of conditions and the following
+	disclaimer must be reproduced in the documentation and/or other
+	materials provided with the distribution.
+
+	3. Neither the name of the copyright holder nor the names of its
+	contributors may be used to endorse or promote products derived
+	from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+	LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+	DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+	THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	Author
+	~~~~~~
+	Justin Richards
+
+*/
+
+#ifndef OLC_PGEX_TILEMAP2D
+#define OLC_PGEX_TILEMAP2D
+
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if !defined(OLC_PGEX_TILEMAP2D_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define OLC_PGEX_TILEMAP2D_SSE2
+		#include <emmintrin.h>
+	#endif
+#endif
+
+class olcPGEX_TileMap2D : public olc::PGEX
+{
+public:
+	olcPGEX_TileMap2D() = default;
+	~olcPGEX_TileMap2D();
+
+	olcPGEX_TileMap2D(const olcPGEX_TileMap2D&) = delete;
+	olcPGEX_TileMap2D& operator=(const olcPGEX_TileMap2D&) = delete;
+
+	// Procedural variation, picked from a hash of each tile's world position
+	struct sVariation
+	{
+		uint32_t nSeed =				0;
+		int nFirstTile =				0;				// Only tiles from nFirstTile to nLastTile are varied
+		int nLastTile =					-1;
+		int nVariants =					1;				// Alternatives of each tile, nVariantOffset apart in the tile set
+		int nVariantOffset =				0;
+		bool bFlipX =					false;
+		bool bFlipY =					false;
+		bool bRotate =					false;				// 90 degree steps, square tiles only
+		float fTintJitter =				0.0f;				// Up to this much darker, 0 - 1
+
+		bool IsActive() const { return nLastTile >= nFirstTile && (nVariants > 1 || bFlipX || bFlipY || bRotate || fTintJitter > 0.0f); }
+	};
+
+	// How a single tile ends up looking once variation is applied
+	struct sTileLook
+	{
+		int nTile =					-1;
+		bool bFlipX =					false;
+		bool bFlipY =					false;
+		int nRotation =					0;				// Quarter turns clockwise
+		uint8_t nShade =				255;
+	};
+
+private:
+	struct sChunk
+	{
+		olc::Sprite* sprChunk =				nullptr;
+		olc::Decal* decChunk =				nullptr;
+		bool bDirty =					true;
+		bool bEmpty =					true;			// Nothing but empty tiles, so nothing to draw
+	};
+
+	olc::vi2d vecMapSize{};
+	olc::vi2d vecTileSize{};
+	olc::vi2d vecChunkCount{};
+	int nChunkTiles =					16;
+	int nTileSetColumns =				0;
+
+	olc::Decal* decTileSet =				nullptr;
+
+	std::vector<int> vTiles;
+	std::vector<sChunk> vChunks;
+
+	sVariation variation;
+	std::vector<uint32_t> vRowHashes;					// Scratch space for i_DrawChunkTiles
+
+public:
+	int nBakeBudget =					4;				// Chunks that can be baked each Draw
+
+	int nChunksDrawn =					0;				// Stats for the last Draw
+	int nChunksBaked =					0;
+	int nTilesDrawn =					0;
+
+public:
+	// Copies tiles from a tile set sprite into a chunk sprite, pTiles holds nTilesX x nTilesY tiles
+	// nStride apart.  Anything outside those tiles is left blank.  Safe to call from any thread.
+	// vecWorldTile is the world position of the first tile, used for the variation (if any).
+	static void		BakeTiles			(const olc::Sprite* sprTileSet, const olc::vi2d vecTileSize, const int* pTiles, const int nStride, const olc::vi2d vecTiles, olc::Sprite* sprChunk,
+								 const olc::vi2d vecWorldTile = { 0, 0 }, const sVariation* pVariation = nullptr);
+
+	// Hashes of nCount tiles along a row of the world, starting at x, y
+	static void		HashRow				(const uint32_t nSeed, const int x, const int y, const int nCount, uint32_t* pHashes);
+	static sTileLook	ApplyVariation			(const sVariation& var, const int nTile, const uint32_t nHash, const bool bSquareTiles);
+
+private:
+	void			i_ClearChunks			();
+	void			i_BakeChunk			(const int cx, const int cy);
+	void			i_DrawChunkTiles		(const int cx, const int cy, const olc::vf2d vecCamPos, const float fScale);
+
+public:
+	void			Create				(const olc::vi2d mapSize, const olc::vi2d tileSize, olc::Decal* tileSet, const int chunkTiles = 16);
+
+	void			SetTile				(const int x, const int y, const int nTile);
+	int			GetTile				(const int x, const int y) const;
+	void			SetTiles			(const int* pTiles);
+	void			SetVariation			(const sVariation& var);
+
+	void			BakeAll				();
+	void			Draw				(const olc::vf2d vecCamPos, const olc::vf2d vecViewSize, const float fScale = 1.0f);
+};
+
+// Chunks of an unlimited world, generated on the thread pool as the camera moves around
+class olcPGEX_ChunkStreamer2D : public olc::PGEX
+{
+public:
+	// Fills in the tiles of one chunk (chunk size x chunk size ints, row by row)
+	using GenerateFunc = std::function<void(const olc::vi2d& vecChunk, int* pTiles)>;
+
+	olcPGEX_ChunkStreamer2D() = default;
+	~olcPGEX_ChunkStreamer2D();
+
+	olcPGEX_ChunkStreamer2D(const olcPGEX_ChunkStreamer2D&) = delete;
+	olcPGEX_ChunkStreamer2D& operator=(const olcPGEX_ChunkStreamer2D&) = delete;
+
+private:
+	struct sChunk
+	{
+		olc::vi2d vecChunk{};
+		std::vector<int> vTiles;
+		olc::Sprite* sprChunk =				nullptr;			// nullptr when every tile is empty
+		olc::Decal* decChunk =				nullptr;
+		size_t nBytes =					0;
+		int nLastFrame =				0;				// Last frame it was wanted
+		std::list<uint64_t>::iterator itLRU;
+	};
+
+	// Everything the workers need, kept alive by the jobs themselves so the streamer can be destroyed at any time
+	struct sShared
+	{
+		std::mutex mux;
+		std::vector<sChunk> vFinished;
+		std::atomic<bool> bCancelled{ false };
+
+		GenerateFunc generate;
+		olcPGEX_TileMap2D::sVariation variation;
+		const olc::Sprite* sprTileSet =			nullptr;
+		olc::vi2d vecTileSize{};
+		int nChunkTiles =				16;
+	};
+
+	std::shared_ptr<sShared> shared;
+	olcPGEX_ThreadPool* pThreadPool =			nullptr;
+	olc::Decal* decTileSet =				nullptr;
+	olc::vi2d vecTileSize{};
+	int nChunkTiles =					16;
+	olcPGEX_TileMap2D::sVariation variation;
+
+	std::unordered_map<uint64_t, sChunk> mChunks;		// Chunks with a decal (or empty), ready to draw
+	std::list<uint64_t> lLRU;					// Most recently wanted at the front
+	std::unordered_set<uint64_t> sRequested;			// Being generated, or waiting for a decal
+	std::deque<sChunk> qWaiting;					// Generated, waiting for a decal
+
+	size_t nBytesResident =					0;
+	int nFrame =						0;
+	bool bFirstUpdate =					true;
+	olc::vf2d vecLastCamPos{};
+	olc::vf2d vecVelocity{};
+
+	std::vector<std::pair<float, olc::vi2d>> vWanted;		// Scratch space for Update
+
+public:
+	int nUploadBudget =					4;				// Decals created each frame
+	size_t nMemoryCap =					64 * 1024 * 1024;		// Bytes of chunks kept in memory
+	float fLookAhead =					0.5f;				// Seconds ahead of the camera to load
+	int nPreloadChunks =					1;				// Chunks around the view to keep ready
+	int nMaxJobs =						16;				// Chunks being generated at once
+
+	int nChunksResident =					0;				// Stats for the last Update / Draw
+	int nChunksPending =					0;
+	int nChunksUploaded =					0;
+	int nChunksEvicted =					0;
+	int nChunksDrawn =					0;
+	int nChunksMissing =					0;				// In view but not ready yet
+
+private:
+	static uint64_t		i_Key				(const olc::vi2d vecChunk) { return ((uint64_t)(uint32_t)vecChunk.x << 32) | (uint32_t)vecChunk.y; }
+	static void		i_Generate			(sShared& state, sChunk& chunk);
+	void			i_Request			(const olc::vi2d vecChunk);
+	void			i_MakeResident			(sChunk&& chunk);
+	void			i_ChunkRange			(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight, olc::vi2d& vecFirst, olc::vi2d& vecLast) const;
+
+public:
+	void			Create				(const olc::vi2d tileSize, olc::Decal* tileSet, olcPGEX_ThreadPool* threadPool, GenerateFunc generate, const int chunkTiles = 16);
+	void			Clear				();
+	void			SetVariation			(const olcPGEX_TileMap2D::sVariation& var);
+
+	int			GetTile				(const int x, const int y) const;
+
+	void			Update				(const olc::vf2d vecCamPos, const olc::vf2d vecViewSize, const float fElapsedTime);
+	void			Draw				(const olc::vf2d vecCamPos, const olc::vf2d vecViewSize, const float fScale = 1.0f);
+};
+
+#ifdef OLC_PGEX_TILEMAP2D_IMPLEMENTATION
+#undef OLC_PGEX_TILEMAP2D_IMPLEMENTATION
+
+olcPGEX_TileMap2D::~olcPGEX_TileMap2D()
+{
+	i_ClearChunks();
+}
+
+void olcPGEX_TileMap2D::i_ClearChunks()
+{
+	for (auto& chunk : vChunks)
+	{
+		delete chunk.decChunk;
+		delete chunk.sprChunk;
+	}
+	vChunks.clear();
+}
+
+void olcPGEX_TileMap2D::Create(const olc::vi2d mapSize, const olc::vi2d tileSize, olc::Decal* tileSet, const int chunkTiles)
+{
+	i_ClearChunks();
+
+	vecMapSize = mapSize;
+	vecTileSize = tileSize;
+	nChunkTiles = chunkTiles;
+	decTileSet = tileSet;
+	nTileSetColumns = std::max(1, tileSet->sprite->width / tileSize.x);
+
+	vecChunkCount = (vecMapSize + olc::vi2d(nChunkTiles - 1, nChunkTiles - 1)) / nChunkTiles;
+	vTiles.assign(vecMapSize.x * vecMapSize.y, -1);
+	vChunks.resize(vecChunkCount.x * vecChunkCount.y);
+}
+
+void olcPGEX_TileMap2D::SetTile(const int x, const int y, const int nTile)
+{
+	if (x < 0 || y < 0 || x >= vecMapSize.x || y >= vecMapSize.y)
+		return;
+
+	int& nCurrent = vTiles[y * vecMapSize.x + x];
+	if (nCurrent == nTile)
+		return;
+
+	nCurrent = nTile;
+	vChunks[(y / nChunkTiles) * vecChunkCount.x + x / nChunkTiles].bDirty = true;
+}
+
+int olcPGEX_TileMap2D::GetTile(const int x, const int y) const
+{
+	if (x < 0 || y < 0 || x >= vecMapSize.x || y >= vecMapSize.y)
+		return -1;
+
+	return vTiles[y * vecMapSize.x + x];
+}
+
+void olcPGEX_TileMap2D::SetTiles(const int* pTiles)
+{
+	vTiles.assign(pTiles, pTiles + vTiles.size());
+	for (auto& chunk : vChunks)
+		chunk.bDirty = true;
+}
+
+void olcPGEX_TileMap2D::i_BakeChunk(const int cx, const int cy)
+{
+	sChunk& chunk = vChunks[cy * vecChunkCount.x + cx];
+	chunk.bDirty = false;
+
+	const olc::vi2d vecFirstTile = olc::vi2d(cx, cy) * nChunkTiles;
+	const olc::vi2d vecTiles = (vecMapSize - vecFirstTile).min({ nChunkTiles, nChunkTiles });
+
+	chunk.bEmpty = true;
+	for (int y = 0; y < vecTiles.y && chunk.bEmpty; y++)
+		for (int x = 0; x < vecTiles.x && chunk.bEmpty; x++)
+			chunk.bEmpty = vTiles[(vecFirstTile.y + y) * vecMapSize.x + vecFirstTile.x + x] < 0;
+
+	// Empty chunks keep their sprite (they'll probably be used again) but aren't drawn
+	if (chunk.bEmpty)
+		return;
+
+	if (chunk.sprChunk == nullptr)
+		chunk.sprChunk = new olc::Sprite(nChunkTiles * vecTileSize.x, nChunkTiles * vecTileSize.y);
+
+	BakeTiles(decTileSet->sprite, vecTileSize, vTiles.data() + vecFirstTile.y * vecMapSize.x + vecFirstTile.x, vecMapSize.x, vecTiles, chunk.sprChunk, vecFirstTile, &variation);
+
+	if (chunk.decChunk == nullptr)
+		chunk.decChunk = new olc::Decal(chunk.sprChunk);
+	else
+		chunk.decChunk->Update();
+}
+
+void olcPGEX_TileMap2D::SetVariation(const sVariation& var)
+{
+	variation = var;
+	for (auto& chunk : vChunks)
+		chunk.bDirty = true;
+}
+
+void olcPGEX_TileMap2D::BakeTiles(const olc::Sprite* sprTileSet, const olc::vi2d vecTileSize, const int* pTiles, const int nStride, const olc::vi2d vecTiles, olc::Sprite* sprChunk,
+	const olc::vi2d vecWorldTile, const sVariation* pVariation)
+{
+	// Copy each tile a row of pixels at a time straight from the tile set sprite
+	const int nColumns = std::max(1, sprTileSet->width / vecTileSize.x);
+	const olc::vi2d vecChunkTiles = { sprChunk->width / vecTileSize.x, sprChunk->height / vecTileSize.y };
+	const size_t nRowBytes = vecTileSize.x * sizeof(olc::Pixel);
+	const bool bVaried = pVariation != nullptr && pVariation->IsActive();
+	const bool bSquare = vecTileSize.x == vecTileSize.y;
+	std::vector<uint32_t> vHashes(bVaried ? vecChunkTiles.x : 0);
+
+	for (int ty = 0; ty < vecChunkTiles.y; ty++)
+	{
+		if (bVaried)
+			HashRow(pVariation->nSeed, vecWorldTile.x, vecWorldTile.y + ty, vecChunkTiles.x, vHashes.data());
+
+		for (int tx = 0; tx < vecChunkTiles.x; tx++)
+		{
+			sTileLook look;
+			look.nTile = (tx < vecTiles.x && ty < vecTiles.y) ? pTiles[ty * nStride + tx] : -1;
+			if (bVaried)
+				look = ApplyVariation(*pVariation, look.nTile, vHashes[tx], bSquare);
+
+			const olc::vi2d vecSource = olc::vi2d(look.nTile % nColumns, look.nTile / nColumns) * vecTileSize;
+			const bool bValid = look.nTile >= 0 && vecSource.x + vecTileSize.x <= sprTileSet->width && vecSource.y + vecTileSize.y <= sprTileSet->height;
+			const bool bPlain = !look.bFlipX && !look.bFlipY && look.nRotation == 0 && look.nShade == 255;
+			const olc::Pixel* pSource = sprTileSet->pColData.data() + vecSource.y * sprTileSet->width + vecSource.x;
+
+			for (int py = 0; py < vecTileSize.y; py++)
+			{
+				olc::Pixel* pDst = sprChunk->pColData.data() + (ty * vecTileSize.y + py) * sprChunk->width + tx * vecTileSize.x;
+				if (!bValid)
+					std::fill(pDst, pDst + vecTileSize.x, olc::BLANK);
+				else if (bPlain)
+					std::memcpy((void*)pDst, pSource + py * sprTileSet->width, nRowBytes);
+				else
+				{
+					// Undo the rotation, then the flip, to find where each pixel comes from
+					const int nLast = vecTileSize.x - 1;
+					for (int px = 0; px < vecTileSize.x; px++)
+					{
+						int sx = px, sy = py;
+						switch (look.nRotation)
+						{
+						case 1: sx = py; sy = nLast - px; break;
+						case 2: sx = nLast - px; sy = vecTileSize.y - 1 - py; break;
+						case 3: sx = nLast - py; sy = px; break;
+						}
+						if (look.bFlipX) sx = nLast - sx;
+						if (look.bFlipY) sy = vecTileSize.y - 1 - sy;
+
+						olc::Pixel p = pSource[sy * sprTileSet->width + sx];
+						p.r = (uint8_t)((p.r * look.nShade) / 255);
+						p.g = (uint8_t)((p.g * look.nShade) / 255);
+						p.b = (uint8_t)((p.b * look.nShade) / 255);
+						pDst[px] = p;
+					}
+				}
+			}
+		}
+	}
+}
+
+#if defined(OLC_PGEX_TILEMAP2D_SSE2)
+// SSE2 has no 32 bit multiply (that came with SSE4.1), so do the odd and even lanes separately
+static inline __m128i olcPGEX_TileMap2D_Mul32(const __m128i a, const __m128i b)
+{
+	const __m128i mEven = _mm_mul_epu32(a, b);
+	const __m128i mOdd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(mEven, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(mOdd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+void olcPGEX_TileMap2D::HashRow(const uint32_t nSeed, const int x, const int y, const int nCount, uint32_t* pHashes)
+{
+	// Position mixed with the seed, then a well mixed integer finaliser (lowbias32) so neighbours look unrelated
+	const uint32_t nRow = (uint32_t)y * 0xd8163841u ^ nSeed * 0xcb1ab31fu;
+	int i = 0;
+
+#if defined(OLC_PGEX_TILEMAP2D_SSE2)
+	const __m128i mRow = _mm_set1_epi32((int)nRow);
+	const __m128i mMulX = _mm_set1_epi32((int)0x8da6b343u);
+	const __m128i mMul1 = _mm_set1_epi32((int)0x7feb352du);
+	const __m128i mMul2 = _mm_set1_epi32((int)0x846ca68bu);
+	__m128i mX = _mm_add_epi32(_mm_set1_epi32(x), _mm_set_epi32(3, 2, 1, 0));
+
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i h = _mm_xor_si128(olcPGEX_TileMap2D_Mul32(mX, mMulX), mRow);
+		h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+		h = olcPGEX_TileMap2D_Mul32(h, mMul1);
+		h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+		h = olcPGEX_TileMap2D_Mul32(h, mMul2);
+		h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+		_mm_storeu_si128((__m128i*)(pHashes + i), h);
+		mX = _mm_add_epi32(mX, _mm_set1_epi32(4));
+	}
+#endif
+
+	for (; i < nCount; i++)
+	{
+		uint32_t h = (uint32_t)(x + i) * 0x8da6b343u ^ nRow;
+		h ^= h >> 16;
+		h *= 0x7feb352du;
+		h ^= h >> 15;
+		h *= 0x846ca68bu;
+		h ^= h >> 16;
+		pHashes[i] = h;
+	}
+}
+
+olcPGEX_TileMap2D::sTileLook olcPGEX_TileMap2D::ApplyVariation(const sVariation& var, const int nTile, const uint32_t nHash, const bool bSquareTiles)
+{
+	sTileLook look;
+	look.nTile = nTile;
+	if (nTile < var.nFirstTile || nTile > var.nLastTile)
+		return look;
+
+	// Each choice uses its own bits of the hash
+	if (var.nVariants > 1)
+		look.nTile += (int)((nHash & 0xFFFF) % (uint32_t)var.nVariants) * var.nVariantOffset;
+	look.bFlipX = var.bFlipX && (nHash & (1 << 16));
+	look.bFlipY = var.bFlipY && (nHash & (1 << 17));
+	look.nRotation = (var.bRotate && bSquareTiles) ? (int)((nHash >> 18) & 3) : 0;
+	look.nShade = (uint8_t)(255 - (int)(std::min(1.0f, std::max(0.0f, var.fTintJitter)) * (float)(nHash >> 24)));
+	return look;
+}
+
+void olcPGEX_TileMap2D::BakeAll()
+{
+	for (int cy = 0; cy < vecChunkCount.y; cy++)
+		for (int cx = 0; cx < vecChunkCount.x; cx++)
+			if (vChunks[cy * vecChunkCount.x + cx].bDirty)
+				i_BakeChunk(cx, cy);
+}
+
+void olcPGEX_TileMap2D::i_DrawChunkTiles(const int cx, const int cy, const olc::vf2d vecCamPos, const float fScale)
+{
+	const olc::vi2d vecFirstTile = olc::vi2d(cx, cy) * nChunkTiles;
+	const olc::vi2d vecLastTile = (vecFirstTile + olc::vi2d(nChunkTiles, nChunkTiles)).min(vecMapSize);
+	const olc::vf2d vecTile = { (float)vecTileSize.x, (float)vecTileSize.y };
+	const bool bVaried = variation.IsActive();
+	vRowHashes.resize(vecLastTile.x - vecFirstTile.x);
+
+	for (int y = vecFirstTile.y; y < vecLastTile.y; y++)
+	{
+		if (bVaried)
+			HashRow(variation.nSeed, vecFirstTile.x, y, (int)vRowHashes.size(), vRowHashes.data());
+
+		for (int x = vecFirstTile.x; x < vecLastTile.x; x++)
+		{
+			sTileLook look;
+			look.nTile = vTiles[y * vecMapSize.x + x];
+			if (bVaried)
+				look = ApplyVariation(variation, look.nTile, vRowHashes[x - vecFirstTile.x], vecTileSize.x == vecTileSize.y);
+			if (look.nTile < 0)
+				continue;
+
+			const olc::vf2d vecSource = olc::vf2d{ (float)(look.nTile % nTileSetColumns), (float)(look.nTile / nTileSetColumns) } * vecTile;
+			const olc::vf2d vecPos = (olc::vf2d{ (float)x, (float)y } * vecTile - vecCamPos) * fScale;
+
+			if (!bVaried)
+				pge->DrawPartialDecal(vecPos, vecTile * fScale, decTileSet, vecSource, vecTile);
+			else
+			{
+				// Same flips and turns as the baked chunk, around the middle of the tile
+				const olc::vf2d vecFlip = { look.bFlipX ? -fScale : fScale, look.bFlipY ? -fScale : fScale };
+				pge->DrawPartialRotatedDecal(vecPos + vecTile * fScale / 2.0f, decTileSet, look.nRotation * 1.5707963f, vecTile / 2.0f, vecSource, vecTile, vecFlip,
+					olc::Pixel(look.nShade, look.nShade, look.nShade));
+			}
+			nTilesDrawn++;
+		}
+	}
+}
+
+void olcPGEX_TileMap2D::Draw(const olc::vf2d vecCamPos, const olc::vf2d vecViewSize, const float fScale)
+{
+	nChunksDrawn = 0;
+	nChunksBaked = 0;
+	nTilesDrawn = 0;
+
+	if (vChunks.empty())
+		return;
+
+	// The range of chunks touching the view
+	const olc::vf2d vecChunkPixels = { (float)(vecTileSize.x * nChunkTiles), (float)(vecTileSize.y * nChunkTiles) };
+	const olc::vi2d vecFirst = olc::vi2d{ (int)std::floor(vecCamPos.x / vecChunkPixels.x), (int)std::floor(vecCamPos.y / vecChunkPixels.y) }.max({ 0, 0 });
+	const olc::vi2d vecLast = olc::vi2d{ (int)std::floor((vecCamPos.x + vecViewSize.x) / vecChunkPixels.x), (int)std::floor((vecCamPos.y + vecViewSize.y) / vecChunkPixels.y) }.min(vecChunkCount - olc::vi2d(1, 1));
+
+	for (int cy = vecFirst.y; cy <= vecLast.y; cy++)
+		for (int cx = vecFirst.x; cx <= vecLast.x; cx++)
+		{
+			sChunk& chunk = vChunks[cy * vecChunkCount.x + cx];
+
+			if (chunk.bDirty)
+			{
+				// Out of budget, draw the tiles one at a time this frame and bake the chunk later
+				if (nChunksBaked >= nBakeBudget)
+				{
+					i_DrawChunkTiles(cx, cy, vecCamPos, fScale);
+					continue;
+				}
+
+				i_BakeChunk(cx, cy);
+				nChunksBaked++;
+			}
+
+			if (chunk.bEmpty)
+				continue;
+
+			const olc::vf2d vecPos = (olc::vf2d{ (float)cx, (float)cy } * vecChunkPixels - vecCamPos) * fScale;
+			pge->DrawDecal(vecPos, chunk.decChunk, { fScale, fScale });
+			nChunksDrawn++;
+		}
+}
+
+olcPGEX_ChunkStreamer2D::~olcPGEX_ChunkStreamer2D()
+{
+	Clear();
+}
+
+void olcPGEX_ChunkStreamer2D::Create(const olc::vi2d tileSize, olc::Decal* tileSet, olcPGEX_ThreadPool* threadPool, GenerateFunc generate, const int chunkTiles)
+{
+	Clear();
+
+	vecTileSize = tileSize;
+	decTileSet = tileSet;
+	pThreadPool = threadPool;
+	nChunkTiles = chunkTiles;
+
+	shared = std::make_shared<sShared>();
+	shared->generate = generate;
+	shared->variation = variation;
+	shared->sprTileSet = tileSet->sprite;
+	shared->vecTileSize = tileSize;
+	shared->nChunkTiles = chunkTiles;
+}
+
+void olcPGEX_ChunkStreamer2D::SetVariation(const olcPGEX_TileMap2D::sVariation& var)
+{
+	variation = var;
+
+	// The workers never see a change half way through, every chunk is simply generated again
+	if (shared)
+		Create(vecTileSize, decTileSet, pThreadPool, shared->generate, nChunkTiles);
+}
+
+void olcPGEX_ChunkStreamer2D::Clear()
+{
+	// Jobs still running finish on their own and throw their results away
+	if (shared)
+	{
+		shared->bCancelled = true;
+		std::scoped_lock lock(shared->mux);
+		for (auto& chunk : shared->vFinished)
+			delete chunk.sprChunk;
+		shared->vFinished.clear();
+	}
+	shared.reset();
+
+	for (auto& chunk : qWaiting)
+		delete chunk.sprChunk;
+	qWaiting.clear();
+
+	for (auto& [nKey, chunk] : mChunks)
+	{
+		delete chunk.decChunk;
+		delete chunk.sprChunk;
+	}
+	mChunks.clear();
+	lLRU.clear();
+	sRequested.clear();
+
+	nBytesResident = 0;
+	bFirstUpdate = true;
+}
+
+int olcPGEX_ChunkStreamer2D::GetTile(const int x, const int y) const
+{
+	// Rounded down, even for negative tiles
+	const olc::vi2d vecChunk = { (x >= 0 ? x : x - nChunkTiles + 1) / nChunkTiles, (y >= 0 ? y : y - nChunkTiles + 1) / nChunkTiles };
+	auto it = mChunks.find(i_Key(vecChunk));
+	if (it == mChunks.end())
+		return -1;
+
+	const olc::vi2d vecLocal = olc::vi2d(x, y) - vecChunk * nChunkTiles;
+	return it->second.vTiles[vecLocal.y * nChunkTiles + vecLocal.x];
+}
+
+void olcPGEX_ChunkStreamer2D::i_Generate(sShared& state, sChunk& chunk)
+{
+	const int nTiles = state.nChunkTiles * state.nChunkTiles;
+	chunk.vTiles.assign(nTiles, -1);
+	state.generate(chunk.vecChunk, chunk.vTiles.data());
+	chunk.nBytes = nTiles * sizeof(int);
+
+	if (std::all_of(chunk.vTiles.begin(), chunk.vTiles.end(), [](const int nTile) { return nTile < 0; }))
+		return;
+
+	chunk.sprChunk = new olc::Sprite(state.nChunkTiles * state.vecTileSize.x, state.nChunkTiles * state.vecTileSize.y);
+	olcPGEX_TileMap2D::BakeTiles(state.sprTileSet, state.vecTileSize, chunk.vTiles.data(), state.nChunkTiles, { state.nChunkTiles, state.nChunkTiles }, chunk.sprChunk,
+		chunk.vecChunk * state.nChunkTiles, &state.variation);
+	chunk.nBytes += chunk.sprChunk->width * chunk.sprChunk->height * sizeof(olc::Pixel);
+}
+
+void olcPGEX_ChunkStreamer2D::i_Request(const olc::vi2d vecChunk)
+{
+	sRequested.insert(i_Key(vecChunk));
+
+	sChunk chunk;
+	chunk.vecChunk = vecChunk;
+
+	if (pThreadPool == nullptr)
+	{
+		i_Generate(*shared, chunk);
+		qWaiting.push_back(std::move(chunk));
+		return;
+	}
+
+	pThreadPool->AddJob([state = shared, chunk]() mutable
+	{
+		if (state->bCancelled)
+			return;
+
+		i_Generate(*state, chunk);
+
+		std::scoped_lock lock(state->mux);
+		if (state->bCancelled)
+			delete chunk.sprChunk;
+		else
+			state->vFinished.push_back(std::move(chunk));
+	});
+}
+
+void olcPGEX_ChunkStreamer2D::i_MakeResident(sChunk&& chunk)
+{
+	const uint64_t nKey = i_Key(chunk.vecChunk);
+	sRequested.erase(nKey);
+
+	// Decals can only be made on the main thread
+	if (chunk.sprChunk != nullptr)
+		chunk.decChunk = new olc::Decal(chunk.sprChunk);
+
+	chunk.nLastFrame = nFrame;
+	lLRU.push_front(nKey);
+	chunk.itLRU = lLRU.begin();
+	nBytesResident += chunk.nBytes;
+	mChunks.emplace(nKey, std::move(chunk));
+}
+
+void olcPGEX_ChunkStreamer2D::i_ChunkRange(const olc::vf2d vecTopLeft, const olc::vf2d vecBottomRight, olc::vi2d& vecFirst, olc::vi2d& vecLast) const
+{
+	const olc::vf2d vecChunkPixels = { (float)(vecTileSize.x * nChunkTiles), (float)(vecTileSize.y * nChunkTiles) };
+	vecFirst = { (int)std::floor(vecTopLeft.x / vecChunkPixels.x), (int)std::floor(vecTopLeft.y / vecChunkPixels.y) };
+	vecLast = { (int)std::floor(vecBottomRight.x / vecChunkPixels.x), (int)std::floor(vecBottomRight.y / vecChunkPixels.y) };
+}
+
+void olcPGEX_ChunkStreamer2D::Update(const olc::vf2d vecCamPos, const olc::vf2d vecViewSize, const float fElapsedTime)
+{
+	if (!shared)
+		return;
+
+	nFrame++;
+	nChunksUploaded = 0;
+	nChunksEvicted = 0;
+
+	// Smoothed camera velocity, so a single jerky frame doesn't send the loading off somewhere else
+	if (!bFirstUpdate && fElapsedTime > 0.0f)
+	{
+		const olc::vf2d vecFrameVelocity = (vecCamPos - vecLastCamPos) / fElapsedTime;
+		const float fBlend = std::min(1.0f, fElapsedTime * 8.0f);
+		vecVelocity += (vecFrameVelocity - vecVelocity) * fBlend;
+	}
+	vecLastCamPos = vecCamPos;
+	bFirstUpdate = false;
+
+	// Everything around the view, plus the view where the camera will be in fLookAhead seconds
+	const olc::vf2d vecChunkPixels = { (float)(vecTileSize.x * nChunkTiles), (float)(vecTileSize.y * nChunkTiles) };
+	const olc::vf2d vecMargin = vecChunkPixels * (float)nPreloadChunks;
+	const olc::vf2d vecAhead = vecVelocity * fLookAhead;
+	const olc::vf2d vecCentre = vecCamPos + vecViewSize / 2.0f;
+
+	olc::vi2d vecViewFirst, vecViewLast, vecFirst, vecLast;
+	i_ChunkRange(vecCamPos, vecCamPos + vecViewSize, vecViewFirst, vecViewLast);
+	i_ChunkRange((vecCamPos - vecMargin).min(vecCamPos + vecAhead), (vecCamPos + vecViewSize + vecMargin).max(vecCamPos + vecViewSize + vecAhead), vecFirst, vecLast);
+
+	const olc::vi2d vecAheadFirst = vecViewFirst + olc::vi2d{ (int)std::floor(vecAhead.x / vecChunkPixels.x), (int)std::floor(vecAhead.y / vecChunkPixels.y) };
+	const olc::vi2d vecAheadLast = vecViewLast + (vecAheadFirst - vecViewFirst);
+
+	auto inView = [&](const int cx, const int cy)
+	{
+		return cx >= vecViewFirst.x && cx <= vecViewLast.x && cy >= vecViewFirst.y && cy <= vecViewLast.y;
+	};
+
+	auto isWanted = [&](const int cx, const int cy)
+	{
+		const bool bAhead = cx >= vecAheadFirst.x && cx <= vecAheadLast.x && cy >= vecAheadFirst.y && cy <= vecAheadLast.y;
+		const bool bNear = cx >= vecViewFirst.x - nPreloadChunks && cx <= vecViewLast.x + nPreloadChunks && cy >= vecViewFirst.y - nPreloadChunks && cy <= vecViewLast.y + nPreloadChunks;
+		return inView(cx, cy) || bAhead || bNear;
+	};
+
+	// Keep everything wanted at the front of the LRU list, and collect what isn't loaded yet
+	vWanted.clear();
+	for (int cy = vecFirst.y; cy <= vecLast.y; cy++)
+		for (int cx = vecFirst.x; cx <= vecLast.x; cx++)
+		{
+			if (!isWanted(cx, cy))
+				continue;
+
+			const bool bInView = inView(cx, cy);
+
+			const uint64_t nKey = i_Key({ cx, cy });
+			auto it = mChunks.find(nKey);
+			if (it != mChunks.end())
+			{
+				it->second.nLastFrame = nFrame;
+				lLRU.splice(lLRU.begin(), lLRU, it->second.itLRU);
+				continue;
+			}
+
+			if (sRequested.count(nKey) != 0)
+				continue;
+
+			// Chunks in view first, then the closest to the centre of the view
+			const olc::vf2d vecChunkCentre = (olc::vf2d{ (float)cx, (float)cy } + olc::vf2d{ 0.5f, 0.5f }) * vecChunkPixels;
+			const float fPriority = (vecChunkCentre - vecCentre).mag2() + (bInView ? 0.0f : 1e12f);
+			vWanted.push_back({ fPriority, { cx, cy } });
+		}
+
+	std::sort(vWanted.begin(), vWanted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	// Without workers the main thread generates chunks, so that comes out of the same budget
+	const int nInFlight = (int)sRequested.size() - (int)qWaiting.size();
+	const int nNewJobs = pThreadPool ? std::max(0, nMaxJobs - nInFlight) : std::max(0, nUploadBudget - (int)qWaiting.size());
+	for (int i = 0; i < (int)vWanted.size() && i < nNewJobs; i++)
+		i_Request(vWanted[i].second);
+
+	// Hand finished chunks over to the main thread, and give a few of them decals
+	{
+		std::scoped_lock lock(shared->mux);
+		for (auto& chunk : shared->vFinished)
+			qWaiting.push_back(std::move(chunk));
+		shared->vFinished.clear();
+	}
+
+	// The camera may have moved on since these were requested, so throw away any it has left behind (they
+	// are requested again if it comes back) and give the chunks in view their decals before the rest
+	auto itKeep = std::remove_if(qWaiting.begin(), qWaiting.end(), [&](sChunk& chunk)
+	{
+		if (isWanted(chunk.vecChunk.x, chunk.vecChunk.y))
+			return false;
+
+		sRequested.erase(i_Key(chunk.vecChunk));
+		delete chunk.sprChunk;
+		chunk.sprChunk = nullptr;
+		return true;
+	});
+	qWaiting.erase(itKeep, qWaiting.end());
+	std::stable_partition(qWaiting.begin(), qWaiting.end(), [&](const sChunk& chunk) { return inView(chunk.vecChunk.x, chunk.vecChunk.y); });
+
+	// Empty chunks don't need a decal, so they don't count towards the budget
+	while (nChunksUploaded < nUploadBudget && !qWaiting.empty())
+	{
+		if (qWaiting.front().sprChunk != nullptr)
+			nChunksUploaded++;
+
+		i_MakeResident(std::move(qWaiting.front()));
+		qWaiting.pop_front();
+	}
+
+	// Chunks waiting for a decal are already taking up memory, so they count towards the cap as well
+	size_t nBytesWaiting = 0;
+	for (const auto& chunk : qWaiting)
+		nBytesWaiting += chunk.nBytes;
+
+	// Forget the least recently wanted chunks until back under the memory cap (never ones wanted this frame)
+	while (nBytesResident + nBytesWaiting > nMemoryCap && !lLRU.empty())
+	{
+		auto it = mChunks.find(lLRU.back());
+		if (it->second.nLastFrame == nFrame)
+			break;
+
+		nBytesResident -= it->second.nBytes;
+		delete it->second.decChunk;
+		delete it->second.sprChunk;
+		mChunks.erase(it);
+		lLRU.pop_back();
+		nChunksEvicted++;
+	}
+
+	nChunksResident = (int)mChunks.size();
+	nChunksPending = (int)sRequested.size();
+}
+
+void olcPGEX_ChunkStreamer2D::Draw(const olc::vf2d vecCamPos, const olc::vf2d vecViewSize, const float fScale)
+{
+	nChunksDrawn = 0;
+	nChunksMissing = 0;
+
+	const olc::vf2d vecChunkPixels = { (float)(vecTileSize.x * nChunkTiles), (float)(vecTileSize.y * nChunkTiles) };
+	olc::vi2d vecFirst, vecLast;
+	i_ChunkRange(vecCamPos, vecCamPos + vecViewSize, vecFirst, vecLast);
+
+	for (int cy = vecFirst.y; cy <= vecLast.y; cy++)
+		for (int cx = vecFirst.x; cx <= vecLast.x; cx++)
+		{
+			auto it = mChunks.find(i_Key({ cx, cy }));
+			if (it == mChunks.end())
+			{
+				nChunksMissing++;
+				continue;
+			}
+
+			if (it->second.decChunk == nullptr)
+				continue;
+
+			const olc::vf2d vecPos = (olc::vf2d{ (float)cx, (float)cy } * vecChunkPixels - vecCamPos) * fScale;
+			pge->DrawDecal(vecPos, it->second.decChunk, { fScale, fScale });
+			nChunksDrawn++;
+		}
+}
+
+#endif			// Implementation Guard
+#endif			// Header Guard
@@ -3,7 +3,7 @@
 
 	+-------------------------------------------------------------+
 	|         OneLoneCoder Pixel Game Engine Extension            |
-	|                Screen Transition - v1.1                     |
+	|                Screen Transition - v1.3                     |
 	+-------------------------------------------------------------+
 
 	What is this?
@@ -51,6 +51,36 @@
 	
 	All done :-)
 	
+	
+	v1.2 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	
+	bTransitionFinished is true for the one frame a transition reaches
+	the end of its fade (fully solid, or fully transparent), so you can
+	react to it without checking the alpha yourself:
+	
+		if (transitions[0].bTransitionFinished)
+			LoadNextLevel();
+	
+	A transition that has faded TO solid stays solid until it is started
+	again in the other direction, GetAlpha() tells you how far through
+	a fade it is.
+	
+	
+	v1.3 - NEW FEATURES
+	~~~~~~~~~~~~~~~~~~~
+	
+	The fades are now run by the shared olcPGEX_Tween engine, which
+	updates them at the start of each frame.  This header includes
+	olcPGEX_Tween.h itself, so you don't need to, but the file must be
+	next to this one (or on your include path).
+
+	Nothing changes in how you use transitions, elapsedTime is still
+	accepted by ProcessTransitions but is no longer needed.  Each transition owns its tween, so transitions can be moved
+	(a std::vector of them works as before) but not copied.  An easing curve can be passed when starting a transition:
+	
+		transitions[0].StartSingleTransition(1.0f, 1.0f, olcPGEX_Tween::Ease::SMOOTHSTEP);
+	
 
 	License (OLC-3)
 	~~~~~~~~~~~~~~~
@@ -95,24 +125,34 @@
 #define OLC_PGEX_TRANSITION
 
 #include "olcPixelGameEngine.h"
+#include "olcPGEX_Tween.h"
 
 class olcPGEX_Transition : public olc::PGEX
 {
 public:
 	olcPGEX_Transition() = delete;
 	olcPGEX_Transition(const int ID, olc::Decal* decal, const olc::Pixel tint);
+	~olcPGEX_Transition();
+
+	// Each transition owns its tween, so it can be moved (into a vector for example) but not copied
+	olcPGEX_Transition(const olcPGEX_Transition&) = delete;
+	olcPGEX_Transition& operator=(const olcPGEX_Transition&) = delete;
+	olcPGEX_Transition(olcPGEX_Transition&& other) noexcept;
+	olcPGEX_Transition& operator=(olcPGEX_Transition&& other) noexcept;
 
 private:
 	olc::Decal* decTransition =				nullptr;
 
 	olc::Pixel pTint =					olc::WHITE;
-	float fAlpha =						0.0f;
+	float fAlpha =						0.0f;					// Read from the tween each frame - v1.3
+	int nAlphaTween =					-1;					// v1.3
 	float fTransitionDirection =				0.0f;					// -1.0f OUT, 0.0f OFF, 1.0f IN
 	float fSpeed =						1.0f;					// 1.0f = 1 second, scale accordingly
 
 public:
 	int nID =						0;
 	bool bActive =						false;
+	bool bTransitionFinished =				false;					// True for the frame the fade ends - v1.2
 
 private:
 	void			i_UpdateAndDraw			(const float elapsedTime, const olc::vf2d screenSize);
@@ -122,7 +162,8 @@ public:
 	static void		SetDefaultTransitions		(std::vector<olcPGEX_Transition>& transitionGroup, olc::Decal* decal);
 	static void		ProcessTransitions		(std::vector<olcPGEX_Transition>& transitionGroup, const float elapsedTime, const olc::vf2d screenSize);
 	
-	void			StartSingleTransition		(const float direction, const float speed = 1.0f);
+	void			StartSingleTransition		(const float direction, const float speed = 1.0f, const olcPGEX_Tween::Ease ease = olcPGEX_Tween::Ease::LINEAR);
+	float			GetAlpha			() const { return fAlpha; }
 };
 
 #ifdef OLC_PGEX_TRANSITION_IMPLEMENTATION
@@ -134,6 +175,38 @@ olcPGEX_Transition::olcPGEX_Transition(const int ID, olc::Decal* decal, const ol
 	decTransition =			decal;
 	pTint =				tint;
 	fAlpha =			0.0f;
+	nAlphaTween =			olcPGEX_Tween::Shared().Create(fAlpha);
+}
+
+olcPGEX_Transition::~olcPGEX_Transition()
+{
+	olcPGEX_Tween::Shared().Destroy(nAlphaTween);
+}
+
+olcPGEX_Transition::olcPGEX_Transition(olcPGEX_Transition&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+olcPGEX_Transition& olcPGEX_Transition::operator=(olcPGEX_Transition&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	// Our own tween goes, and the other transition hands its tween over to us
+	olcPGEX_Tween::Shared().Destroy(nAlphaTween);
+	nAlphaTween =			other.nAlphaTween;
+	other.nAlphaTween =		-1;
+
+	decTransition =			other.decTransition;
+	pTint =				other.pTint;
+	fAlpha =			other.fAlpha;
+	fTransitionDirection =		other.fTransitionDirection;
+	fSpeed =			other.fSpeed;
+	nID =				other.nID;
+	bActive =			other.bActive;
+	bTransitionFinished =		other.bTransitionFinished;
+	return *this;
 }
 
 void olcPGEX_Transition::AddTransitionType(std::vector<olcPGEX_Transition>& transitionGroup, const int ID, olc::Decal* decal, const olc::Pixel tint)
@@ -155,34 +228,44 @@ void olcPGEX_Transition::ProcessTransitions(std::vector<olcPGEX_Transition>& tra
 
 }
 
-void olcPGEX_Transition::StartSingleTransition(const float direction, const float speed)
+void olcPGEX_Transition::StartSingleTransition(const float direction, const float speed, const olcPGEX_Tween::Ease ease)
 {
 	fTransitionDirection = direction;
 	fSpeed = speed;
 
 	fAlpha = fTransitionDirection < 0.0f ? 1.0f : 0.0f;
 	bActive = true;
+
+	// A direction (or speed) of 0.0f simply holds the transition where it is
+	auto& tweens = olcPGEX_Tween::Shared();
+	if (fTransitionDirection == 0.0f || fSpeed <= 0.0f)
+	{
+		fTransitionDirection = 0.0f;
+		tweens.Set(nAlphaTween, fAlpha);
+	}
+	else
+		tweens.Start(nAlphaTween, fAlpha, 1.0f - fAlpha, 1.0f / fSpeed, ease);
 }
 
 void olcPGEX_Transition::i_UpdateAndDraw(const float elapsedTime, const olc::vf2d screenSize)
 {
+	(void)elapsedTime;
+	bTransitionFinished = false;
+
 	if (bActive)
 	{
-		if (fTransitionDirection < 0.0f)
-			fAlpha -= elapsedTime * fSpeed;
-		else if (fTransitionDirection > 0.0f)
-			fAlpha += elapsedTime * fSpeed;
+		auto& tweens = olcPGEX_Tween::Shared();
+		fAlpha = tweens.Get(nAlphaTween);
 
-		if (fAlpha < 0.0f)
-		{
-			fAlpha = 0.0f;
-			fTransitionDirection = 0.0f;
-			bActive = false;
-		}
-		else if (fAlpha > 1.0f)
+		// A fade that is still running has a direction, so one that has stopped has just finished (this is
+		// checked rather than JustFinished, which is only true during the frame the tween engine ended it)
+		if (fTransitionDirection != 0.0f && !tweens.IsActive(nAlphaTween))
 		{
-			fAlpha = 1.0f;
 			fTransitionDirection = 0.0f;
+			bTransitionFinished = true;
+
+			if (fAlpha <= 0.0f)
+				bActive = false;
 		}
 
 		pTint.a = fAlpha * 255.0f;
@@ -0,0 +1,426 @@
+/*
+	olcPGEX_Tween.h
+
+	+-------------------------------------------------------------+
+	|         OneLoneCoder Pixel Game Engine Extension            |
+	|                     Tween - v1.0                            |
+	+-------------------------------------------------------------+
+
+	What is this?
+	~~~~~~~~~~~~~
+	This is an extension to the olcPixelGameEngine v2.0 and above.
+	It moves float values from one number to another over a set time
+	with a choice of easing curves (fades, zooms, sliding menus, camera
+	moves, anything really), so your code doesn't need to tick its own
+	counters every frame.
+
+	All the running tweens are kept together and updated in one go at
+	the start of each frame.  Tweens that have finished (or have never
+	been started) are not touched at all, so it doesn't matter how many
+	of them you create.
+
+	Some of my other extensions (Transition, Menu, SplashScreen and
+	Camera2D) use the shared tween engine for their own animations.
+
+
+	How to use it?
+	~~~~~~~~~~~~~~
+	Include the header file anywhere after the olcPixelGameEngine.  There
+	is no implementation guard to define, everything is inlined.
+
+		#include "olcPGEX_Tween.h"
+
+	The easiest thing is to use the shared engine, which updates itself
+	before every OnUserUpdate.  Create a tween once (it starts off idle,
+	holding the value you give it)...
+
+		auto& tweens = olcPGEX_Tween::Shared();
+		int nDoorTween = tweens.Create(0.0f);
+
+	...start it whenever you like, with a start value, end value, duration
+	in seconds and an easing curve...
+
+		tweens.Start(nDoorTween, 0.0f, 64.0f, 0.5f, olcPGEX_Tween::Ease::OUT_CUBIC);
+
+	...or from wherever it is right now (handy if it is already moving)...
+
+		tweens.StartTo(nDoorTween, 0.0f, 0.5f);
+
+	...and read its value when you draw...
+
+		DrawDecal({ vecDoorPos.x, vecDoorPos.y - tweens.Get(nDoorTween) }, decDoor);
+
+	When a tween reaches its end value it stops, and it is added to the
+	list of tweens that finished this frame.  You can check one tween,
+	or go through them all (the optional tag you passed to Start comes
+	back with each one so you know what it was for)...
+
+		if (tweens.JustFinished(nDoorTween))
+			PlaySound(DOOR_CLOSED);
+
+		for (auto& e : tweens.Events())
+			OnTweenFinished(e.nID, e.nTag);
+
+	The list is cleared at the start of the next frame, so everything
+	you do during OnUserUpdate sees the same set of events.
+
+	Easing curves available:
+
+		LINEAR
+		IN_QUAD, OUT_QUAD, IN_OUT_QUAD
+		IN_CUBIC, OUT_CUBIC, IN_OUT_CUBIC
+		SMOOTHSTEP
+
+	NOTE: The shared engine hooks into the pixel game engine (v2.10 and
+	above) so it is updated automatically, and should first be used once
+	your PixelGameEngine exists (OnUserCreate or later, or inside your
+	main class).  If you would rather update it yourself (older versions
+	of the engine, or to pause all tweens), define OLC_PGEX_TWEEN_MANUAL
+	before including the header and call Advance once per frame...
+
+		olcPGEX_Tween::Shared().Advance(fElapsedTime);
+
+	You can also create your own olcPGEX_Tween instances (one per game
+	scene for example), these are always updated with Advance.
+
+
+
+	License (OLC-3)
+	~~~~~~~~~~~~~~~
+
+	Copyright 2018 - 2019 OneLoneCoder.com
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+
+	1. Redistributions or derivations of source code must retain the above
+	copyright notice, this list of conditions and the following disclaimer.
+
+	2. Redistributions or derivative works in binary form must reproduce
+	the above copyright notice. This list of conditions and the following
+	disclaimer must be reproduced in the documentation and/or other
+	materials provided with the distribution.
+
+	3. Neither the name of the copyright holder nor the names of its
+	contributors may be used to endorse or promote products derived
+	from this software without specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+	A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+	HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+	LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+	DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+	THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+	OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+	Author
+	~~~~~~
+	Justin Richards
+
+*/
+
+#ifndef OLC_PGEX_TWEEN
+#define OLC_PGEX_TWEEN
+
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class olcPGEX_Tween : public olc::PGEX
+{
+public:
+	enum class Ease : uint8_t
+	{
+		LINEAR,
+		IN_QUAD,
+		OUT_QUAD,
+		IN_OUT_QUAD,
+		IN_CUBIC,
+		OUT_CUBIC,
+		IN_OUT_CUBIC,
+		SMOOTHSTEP,
+
+		COUNT
+	};
+
+	// A tween that reached its end value during the last Advance
+	struct sEvent
+	{
+		int nID = -1;
+		int nTag = 0;
+	};
+
+	inline olcPGEX_Tween(const bool bHook = false);
+
+	olcPGEX_Tween(const olcPGEX_Tween&) = delete;
+	olcPGEX_Tween& operator=(const olcPGEX_Tween&) = delete;
+
+	// The engine used by the other extensions, updated automatically unless OLC_PGEX_TWEEN_MANUAL is defined
+	static inline olcPGEX_Tween& Shared();
+
+private:
+	// Running tweens are grouped by easing curve, so each group is updated by one simple loop
+	// over contiguous arrays with no per tween branching
+	struct sGroup
+	{
+		std::vector<float> vFrom;
+		std::vector<float> vDelta;
+		std::vector<float> vTime;												// 0.0f to 1.0f
+		std::vector<float> vRate;												// 1.0f / duration
+		std::vector<float> vValue;
+		std::vector<int> vID;
+	};
+	sGroup groups[(size_t)Ease::COUNT];
+
+	// Per tween ID, only read while a tween is idle or when it starts and stops
+	std::vector<float> vRestValue;												// The value when idle, the end value while running
+	std::vector<int8_t> vGroup;													// -1 when idle
+	std::vector<int> vIndex;													// Position within its group
+	std::vector<int> vTag;
+	std::vector<uint32_t> vFinishedFrame;
+	std::vector<bool> vAlive;
+	std::vector<int> vFreeIDs;
+
+	std::vector<sEvent> vEvents;
+	uint32_t nFrame = 1;
+	int nActive = 0;
+
+	inline bool i_Valid(const int nID) const { return nID >= 0 && nID < (int)vAlive.size() && vAlive[nID]; }
+	inline void i_Remove(const int nID);
+
+	template<typename EASE>
+	static inline void i_Evaluate(sGroup& group, const size_t nCount, EASE ease);
+
+protected:
+	inline bool OnBeforeUserUpdate(float& fElapsedTime) override;
+
+public:
+	inline int Create(const float fValue = 0.0f);
+	inline void Destroy(const int nID);
+
+	inline void Start(const int nID, const float fFrom, const float fTo, const float fDuration, const Ease ease = Ease::LINEAR, const int nTag = 0);
+	inline void StartTo(const int nID, const float fTo, const float fDuration, const Ease ease = Ease::LINEAR, const int nTag = 0);
+	inline void Set(const int nID, const float fValue);								// Stops the tween, no event is fired
+
+	inline float Get(const int nID) const;
+	inline bool IsActive(const int nID) const { return i_Valid(nID) && vGroup[nID] >= 0; }
+	inline bool JustFinished(const int nID) const { return i_Valid(nID) && vFinishedFrame[nID] == nFrame; }
+	int ActiveCount() const { return nActive; }
+
+	inline void Advance(const float fElapsedTime);
+	const std::vector<sEvent>& Events() const { return vEvents; }
+};
+
+
+olcPGEX_Tween::olcPGEX_Tween(const bool bHook) : olc::PGEX(bHook && pge != nullptr)
+{
+}
+
+olcPGEX_Tween& olcPGEX_Tween::Shared()
+{
+#if defined(OLC_PGEX_TWEEN_MANUAL)
+	static olcPGEX_Tween tweens(false);
+#else
+	static olcPGEX_Tween tweens(true);
+#endif
+	return tweens;
+}
+
+bool olcPGEX_Tween::OnBeforeUserUpdate(float& fElapsedTime)
+{
+	Advance(fElapsedTime);
+	return false;
+}
+
+int olcPGEX_Tween::Create(const float fValue)
+{
+	int nID;
+	if (!vFreeIDs.empty())
+	{
+		nID = vFreeIDs.back();
+		vFreeIDs.pop_back();
+	}
+	else
+	{
+		nID = (int)vAlive.size();
+		vRestValue.push_back(0.0f);
+		vGroup.push_back(-1);
+		vIndex.push_back(-1);
+		vTag.push_back(0);
+		vFinishedFrame.push_back(0);
+		vAlive.push_back(false);
+	}
+
+	vRestValue[nID] = fValue;
+	vGroup[nID] = -1;
+	vIndex[nID] = -1;
+	vTag[nID] = 0;
+	vFinishedFrame[nID] = 0;
+	vAlive[nID] = true;
+	return nID;
+}
+
+void olcPGEX_Tween::Destroy(const int nID)
+{
+	if (!i_Valid(nID))
+		return;
+
+	if (vGroup[nID] >= 0)
+		i_Remove(nID);
+
+	vAlive[nID] = false;
+	vFreeIDs.push_back(nID);
+}
+
+void olcPGEX_Tween::Start(const int nID, const float fFrom, const float fTo, const float fDuration, const Ease ease, const int nTag)
+{
+	if (!i_Valid(nID) || ease >= Ease::COUNT)
+		return;
+
+	if (vGroup[nID] >= 0)
+		i_Remove(nID);
+
+	sGroup& g = groups[(size_t)ease];
+	vGroup[nID] = (int8_t)ease;
+	vIndex[nID] = (int)g.vID.size();
+	vTag[nID] = nTag;
+	vRestValue[nID] = fTo;
+	vFinishedFrame[nID] = 0;
+
+	// A zero duration still finishes (and fires its event) on the next Advance
+	g.vFrom.push_back(fFrom);
+	g.vDelta.push_back(fTo - fFrom);
+	g.vTime.push_back(0.0f);
+	g.vRate.push_back(fDuration > 0.0f ? 1.0f / fDuration : std::numeric_limits<float>::max());
+	g.vValue.push_back(fFrom);
+	g.vID.push_back(nID);
+	nActive++;
+}
+
+void olcPGEX_Tween::StartTo(const int nID, const float fTo, const float fDuration, const Ease ease, const int nTag)
+{
+	Start(nID, Get(nID), fTo, fDuration, ease, nTag);
+}
+
+void olcPGEX_Tween::Set(const int nID, const float fValue)
+{
+	if (!i_Valid(nID))
+		return;
+
+	if (vGroup[nID] >= 0)
+		i_Remove(nID);
+
+	vRestValue[nID] = fValue;
+	vFinishedFrame[nID] = 0;
+}
+
+float olcPGEX_Tween::Get(const int nID) const
+{
+	if (!i_Valid(nID))
+		return 0.0f;
+
+	if (vGroup[nID] < 0)
+		return vRestValue[nID];
+
+	return groups[vGroup[nID]].vValue[vIndex[nID]];
+}
+
+void olcPGEX_Tween::i_Remove(const int nID)
+{
+	// Swap the last tween in the group into the gap so the arrays stay contiguous
+	sGroup& g = groups[vGroup[nID]];
+	const size_t i = (size_t)vIndex[nID];
+	const size_t nLast = g.vID.size() - 1;
+
+	if (i != nLast)
+	{
+		g.vFrom[i] = g.vFrom[nLast];
+		g.vDelta[i] = g.vDelta[nLast];
+		g.vTime[i] = g.vTime[nLast];
+		g.vRate[i] = g.vRate[nLast];
+		g.vValue[i] = g.vValue[nLast];
+		g.vID[i] = g.vID[nLast];
+		vIndex[g.vID[i]] = (int)i;
+	}
+
+	g.vFrom.pop_back();
+	g.vDelta.pop_back();
+	g.vTime.pop_back();
+	g.vRate.pop_back();
+	g.vValue.pop_back();
+	g.vID.pop_back();
+
+	vGroup[nID] = -1;
+	vIndex[nID] = -1;
+	nActive--;
+}
+
+template<typename EASE>
+void olcPGEX_Tween::i_Evaluate(sGroup& group, const size_t nCount, EASE ease)
+{
+	const float* pFrom = group.vFrom.data();
+	const float* pDelta = group.vDelta.data();
+	const float* pTime = group.vTime.data();
+	float* pValue = group.vValue.data();
+
+	for (size_t i = 0; i < nCount; i++)
+		pValue[i] = pFrom[i] + pDelta[i] * ease(pTime[i]);
+}
+
+void olcPGEX_Tween::Advance(const float fElapsedTime)
+{
+	nFrame++;
+	vEvents.clear();
+
+	if (nActive == 0)
+		return;
+
+	for (size_t e = 0; e < (size_t)Ease::COUNT; e++)
+	{
+		sGroup& g = groups[e];
+		const size_t nCount = g.vID.size();
+		if (nCount == 0)
+			continue;
+
+		float* pTime = g.vTime.data();
+		const float* pRate = g.vRate.data();
+		for (size_t i = 0; i < nCount; i++)
+			pTime[i] = std::min(pTime[i] + fElapsedTime * pRate[i], 1.0f);
+
+		switch ((Ease)e)
+		{
+		case Ease::LINEAR:			i_Evaluate(g, nCount, [](const float t) { return t; }); break;
+		case Ease::IN_QUAD:			i_Evaluate(g, nCount, [](const float t) { return t * t; }); break;
+		case Ease::OUT_QUAD:		i_Evaluate(g, nCount, [](const float t) { return t * (2.0f - t); }); break;
+		case Ease::IN_OUT_QUAD:		i_Evaluate(g, nCount, [](const float t) { const float u = 1.0f - t; return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * u * u; }); break;
+		case Ease::IN_CUBIC:		i_Evaluate(g, nCount, [](const float t) { return t * t * t; }); break;
+		case Ease::OUT_CUBIC:		i_Evaluate(g, nCount, [](const float t) { const float u = 1.0f - t; return 1.0f - u * u * u; }); break;
+		case Ease::IN_OUT_CUBIC:	i_Evaluate(g, nCount, [](const float t) { const float u = 1.0f - t; return t < 0.5f ? 4.0f * t * t * t : 1.0f - 4.0f * u * u * u; }); break;
+		case Ease::SMOOTHSTEP:		i_Evaluate(g, nCount, [](const float t) { return t * t * (3.0f - 2.0f * t); }); break;
+		default: break;
+		}
+
+		// Walk backwards so swapping the last tween into a finished one's place doesn't skip anything
+		for (size_t i = nCount; i-- > 0;)
+		{
+			if (g.vTime[i] < 1.0f)
+				continue;
+
+			const int nID = g.vID[i];
+			vFinishedFrame[nID] = nFrame;
+			vEvents.push_back({ nID, vTag[nID] });
+			i_Remove(nID);
+		}
+	}
+}
+
+#endif		// header guard